@@ -24,6 +24,7 @@
 
 #ifdef USE_MAD
 
+#include "common/array.h"
 #include "common/debug.h"
 #include "common/mutex.h"
 #include "common/ptr.h"
@@ -108,6 +109,26 @@ protected:
 	Timestamp _length;
 
 private:
+	/**
+	 * A frame boundary recorded while the stream length is computed, so
+	 * seeking can jump close to its destination instead of skipping over
+	 * every frame from the start of the stream.
+	 */
+	struct SeekPoint {
+		mad_timer_t time;	///< playback time at the start of the frame
+		uint32 offset;		///< position of the frame in _inStream
+	};
+
+	enum {
+		// Only every n-th frame is indexed, seeking skips the frame
+		// headers in between.
+		SEEK_INDEX_STRIDE = 8
+	};
+
+	Common::Array<SeekPoint> _seekIndex;
+
+	const SeekPoint &findSeekPoint(const mad_timer_t &where) const;
+
 	static Common::SeekableReadStream *skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose);
 };
 
@@ -337,10 +358,26 @@ MP3Stream::MP3Stream(Common::SeekableReadStream *inStream, DisposeAfterUse::Flag
 	_channels = MAD_NCHANNELS(&_frame.header);
 	_rate = _frame.header.samplerate;
 
-	// Calculate the length of the stream
-	while (_state != MP3_STATE_EOS)
+	// The first frame has been decoded above, so start the seek index by hand
+	SeekPoint start;
+	start.time = mad_timer_zero;
+	start.offset = 0;
+	_seekIndex.push_back(start);
+
+	// Calculate the length of the stream and build the seek index
+	uint32 frame = 1;
+	while (_state != MP3_STATE_EOS) {
+		mad_timer_t frameStart = _curTime;
 		readHeader(*_inStream);
 
+		if (_state != MP3_STATE_EOS && (frame++ % SEEK_INDEX_STRIDE) == 0) {
+			SeekPoint point;
+			point.time = frameStart;
+			point.offset = _inStream->pos() - (_stream.bufend - _stream.this_frame);
+			_seekIndex.push_back(point);
+		}
+	}
+
 	// To rule out any invalid sample rate to be encountered here, say in case the
 	// MP3 stream is invalid, we just check the MAD error code here.
 	// We need to assure this, since else we might trigger an assertion in Timestamp
@@ -377,9 +414,13 @@ bool MP3Stream::seek(const Timestamp &where) {
 	mad_timer_t destination;
 	mad_timer_set(&destination, time / 1000, time % 1000, 1000);
 
-	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0) {
-		_inStream->seek(0);
+	// Restart from the closest indexed frame, unless it is faster to just
+	// keep skipping forward from the current position.
+	const SeekPoint &point = findSeekPoint(destination);
+	if (_state != MP3_STATE_READY || mad_timer_compare(destination, _curTime) < 0 || mad_timer_compare(point.time, _curTime) > 0) {
+		_inStream->seek(point.offset);
 		initStream(*_inStream);
+		_curTime = point.time;
 	}
 
 	while (mad_timer_compare(destination, _curTime) > 0 && _state != MP3_STATE_EOS)
@@ -390,6 +431,19 @@ bool MP3Stream::seek(const Timestamp &where) {
 	return (_state != MP3_STATE_EOS);
 }
 
+const MP3Stream::SeekPoint &MP3Stream::findSeekPoint(const mad_timer_t &where) const {
+	// Binary search for the last frame starting at or before the destination
+	uint lo = 0, hi = _seekIndex.size();
+	while (hi - lo > 1) {
+		uint mid = (lo + hi) / 2;
+		if (mad_timer_compare(_seekIndex[mid].time, where) <= 0)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	return _seekIndex[lo];
+}
+
 Common::SeekableReadStream *MP3Stream::skipID3(Common::SeekableReadStream *stream, DisposeAfterUse::Flag dispose) {
 	// Skip ID3 TAG if any
 	// ID3v1 (beginning with with 'TAG') is located at the end of files. So we can ignore those.
@@ -5,6 +5,7 @@ MODULE_OBJS := \
 	mididrv.o \
 	mixer.o \
 	musicplugin.o \
+	pcmcache.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
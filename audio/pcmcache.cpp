@@ -0,0 +1,240 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/pcmcache.h"
+#include "audio/audiostream.h"
+
+#include "common/textconsole.h"
+
+namespace Common {
+DECLARE_SINGLETON(Audio::PCMCache);
+}
+
+namespace Audio {
+
+/**
+ * A stream reading from the samples of a cached clip. The stream holds a
+ * reference to the clip, so it stays alive even when it gets evicted.
+ */
+class CachedPCMStream : public SeekableAudioStream {
+public:
+	CachedPCMStream(PCMCache *cache, PCMCache::Clip *clip)
+		: _cache(cache), _clip(clip), _pos(0),
+		  _length(0, clip->numSamples / (clip->stereo ? 2 : 1), clip->rate) {
+	}
+
+	~CachedPCMStream() {
+		_cache->releaseStreamClip(_clip);
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const int samples = MIN<uint32>(numSamples, _clip->numSamples - _pos);
+		memcpy(buffer, _clip->samples + _pos, samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const { return _clip->stereo; }
+	int getRate() const { return _clip->rate; }
+	bool endOfData() const { return _pos >= _clip->numSamples; }
+
+	bool seek(const Timestamp &where) {
+		const uint32 pos = convertTimeToStreamPos(where, _clip->rate, _clip->stereo).totalNumberOfFrames();
+		if (pos > _clip->numSamples)
+			return false;
+		_pos = pos;
+		return true;
+	}
+
+	Timestamp getLength() const { return _length; }
+
+private:
+	PCMCache *const _cache;
+	PCMCache::Clip *const _clip;
+	uint32 _pos;
+	const Timestamp _length;
+};
+
+PCMCache::PCMCache() :
+		_budget(kDefaultBudget),
+		_maxClipSize(kDefaultMaxClipSize),
+		_size(0),
+		_hits(0),
+		_misses(0),
+		_evictions(0) {
+}
+
+PCMCache::~PCMCache() {
+	evict(0);
+}
+
+SeekableAudioStream *PCMCache::find(const Common::String &key) {
+	Common::StackLock lock(_mutex);
+
+	ClipMap::iterator it = _clipMap.find(key);
+	if (it == _clipMap.end()) {
+		_misses++;
+		return 0;
+	}
+	_hits++;
+
+	// Move the clip to the front of the LRU list
+	Clip *clip = *it->_value;
+	_clips.erase(it->_value);
+	_clips.push_front(clip);
+	it->_value = _clips.begin();
+
+	return createStream(clip);
+}
+
+RewindableAudioStream *PCMCache::add(const Common::String &key, RewindableAudioStream *stream) {
+	if (!stream)
+		return 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		if (_tooLong.contains(key))
+			return stream;
+	}
+
+	// Decoding may take a while, so it happens without holding the lock
+	Clip *decoded = decode(stream);
+	if (!decoded) {
+		Common::StackLock lock(_mutex);
+		_tooLong[key] = true;
+		if (!stream->rewind())
+			warning("PCMCache: Failed to rewind '%s'", key.c_str());
+		return stream;
+	}
+	delete stream;
+
+	Clip *clip = decoded;
+	clip->key = key;
+	// The reference of the cache itself
+	clip->refCount = 1;
+
+	Common::StackLock lock(_mutex);
+	ClipMap::iterator it = _clipMap.find(key);
+	if (it != _clipMap.end()) {
+		// Someone else added the same clip in the meantime
+		_size -= (*it->_value)->getSize();
+		releaseClip(*it->_value);
+		_clips.erase(it->_value);
+	}
+	_clips.push_front(clip);
+	_clipMap[key] = _clips.begin();
+	_size += clip->getSize();
+
+	// Take the reference of the stream before the clip can get evicted
+	SeekableAudioStream *cachedStream = createStream(clip);
+	evict(_budget);
+	return cachedStream;
+}
+
+SeekableAudioStream *PCMCache::createStream(Clip *clip) {
+	clip->refCount++;
+	return new CachedPCMStream(this, clip);
+}
+
+void PCMCache::releaseClip(Clip *clip) {
+	assert(clip->refCount > 0);
+	if (--clip->refCount == 0)
+		delete clip;
+}
+
+void PCMCache::releaseStreamClip(Clip *clip) {
+	Common::StackLock lock(_mutex);
+	releaseClip(clip);
+}
+
+PCMCache::Clip *PCMCache::decode(RewindableAudioStream *stream) const {
+	const uint32 maxSamples = _maxClipSize / sizeof(int16);
+
+	// Reject clips which are known to be too long before decoding them
+	SeekableAudioStream *seekableStream = dynamic_cast<SeekableAudioStream *>(stream);
+	if (seekableStream) {
+		const uint32 length = seekableStream->getLength().convertToFramerate(stream->getRate()).totalNumberOfFrames();
+		if (length * (stream->isStereo() ? 2 : 1) > maxSamples)
+			return 0;
+	}
+
+	uint32 capacity = MIN<uint32>(maxSamples, 16384);
+	uint32 numSamples = 0;
+	int16 *samples = new int16[capacity];
+
+	while (!stream->endOfData()) {
+		if (numSamples == capacity) {
+			if (capacity >= maxSamples) {
+				delete[] samples;
+				return 0;
+			}
+			capacity = MIN(capacity * 2, maxSamples);
+			int16 *newSamples = new int16[capacity];
+			memcpy(newSamples, samples, numSamples * sizeof(int16));
+			delete[] samples;
+			samples = newSamples;
+		}
+
+		const int read = stream->readBuffer(samples + numSamples, capacity - numSamples);
+		if (read <= 0)
+			break;
+		numSamples += read;
+	}
+
+	Clip *clip = new Clip();
+	clip->numSamples = numSamples;
+	clip->rate = stream->getRate();
+	clip->stereo = stream->isStereo();
+	if (numSamples == capacity) {
+		clip->samples = samples;
+	} else {
+		clip->samples = new int16[numSamples];
+		memcpy(clip->samples, samples, numSamples * sizeof(int16));
+		delete[] samples;
+	}
+	return clip;
+}
+
+void PCMCache::evict(uint32 budget) {
+	while (_size > budget && !_clips.empty()) {
+		Clip *clip = _clips.back();
+		_clips.pop_back();
+		_clipMap.erase(clip->key);
+		_size -= clip->getSize();
+		_evictions++;
+		releaseClip(clip);
+	}
+}
+
+void PCMCache::clear() {
+	Common::StackLock lock(_mutex);
+	evict(0);
+	_tooLong.clear();
+}
+
+void PCMCache::setBudget(uint32 bytes) {
+	Common::StackLock lock(_mutex);
+	_budget = bytes;
+	evict(_budget);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,160 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_PCMCACHE_H
+#define AUDIO_PCMCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+namespace Audio {
+
+class RewindableAudioStream;
+class SeekableAudioStream;
+
+/**
+ * A process-wide cache of fully decoded short sound clips.
+ *
+ * Sound effects which are played over and over again (footsteps, UI clicks)
+ * only need to be decoded once. The cache keeps the decoded samples of such
+ * clips, keyed by a name chosen by the caller (usually the archive member the
+ * clip comes from), and hands out streams reading directly from the cached
+ * samples. The least recently used clips are dropped once the cache exceeds
+ * its byte budget. Streams handed out earlier stay valid after that.
+ *
+ * All methods may be called from any thread.
+ */
+class PCMCache : public Common::Singleton<PCMCache> {
+public:
+	enum {
+		kDefaultBudget = 4 * 1024 * 1024,	///< Default size of the cache in bytes
+		kDefaultMaxClipSize = 512 * 1024	///< Default size limit of a single clip in bytes
+	};
+
+	/**
+	 * Look up a clip.
+	 *
+	 * @param key	the name the clip was added with
+	 * @return a new stream playing the cached clip, or 0 if it is not cached
+	 */
+	SeekableAudioStream *find(const Common::String &key);
+
+	/**
+	 * Decode a clip and add it to the cache.
+	 *
+	 * The clip is only cached if it fits in the size limit for a single clip.
+	 * Clips which are too long are remembered, so the next add() for the same
+	 * key returns right away without decoding anything.
+	 *
+	 * @param key		the name to cache the clip under
+	 * @param stream	the stream to decode, the cache takes ownership of it
+	 * @return a stream playing the clip: either one over the cached samples,
+	 *         or the passed stream itself, rewound, if it was not cached
+	 */
+	RewindableAudioStream *add(const Common::String &key, RewindableAudioStream *stream);
+
+	/** Drop all cached clips. */
+	void clear();
+
+	/**
+	 * Set the maximum amount of memory used for cached samples. Clips are
+	 * evicted right away if the cache is already larger than that.
+	 */
+	void setBudget(uint32 bytes);
+	uint32 getBudget() const { return _budget; }
+
+	/** Set the size limit of a single cached clip. */
+	void setMaxClipSize(uint32 bytes) { _maxClipSize = bytes; }
+	uint32 getMaxClipSize() const { return _maxClipSize; }
+
+	/** Number of bytes currently used by cached samples. */
+	uint32 getSize() const { return _size; }
+	/** Number of cached clips. */
+	uint32 getNumClips() const { return _clips.size(); }
+
+	uint32 getHits() const { return _hits; }
+	uint32 getMisses() const { return _misses; }
+	uint32 getEvictions() const { return _evictions; }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	friend class CachedPCMStream;
+	PCMCache();
+	~PCMCache();
+
+	/**
+	 * The decoded samples of a clip. They are shared by the cache and the
+	 * streams playing the clip, which may be deleted by the mixer thread,
+	 * so the reference count is only ever touched while holding _mutex.
+	 */
+	struct Clip {
+		Clip() : samples(0), numSamples(0), rate(0), stereo(false), refCount(0) {}
+		~Clip() { delete[] samples; }
+
+		Common::String key;
+		int16 *samples;
+		uint32 numSamples;
+		int rate;
+		bool stereo;
+		uint refCount;
+
+		uint32 getSize() const { return numSamples * sizeof(int16); }
+	};
+
+	typedef Common::List<Clip *> ClipList;
+	typedef Common::HashMap<Common::String, ClipList::iterator> ClipMap;
+	typedef Common::HashMap<Common::String, bool> KeySet;
+
+	Clip *decode(RewindableAudioStream *stream) const;
+	void evict(uint32 budget);
+	/** Create a stream playing a clip, with _mutex held. */
+	SeekableAudioStream *createStream(Clip *clip);
+	/** Drop a reference to a clip, with _mutex held. */
+	static void releaseClip(Clip *clip);
+	/** Drop the reference of a stream to its clip. */
+	void releaseStreamClip(Clip *clip);
+
+	Common::Mutex _mutex;
+	// Most recently used clips first
+	ClipList _clips;
+	ClipMap _clipMap;
+	KeySet _tooLong;
+
+	uint32 _budget;
+	uint32 _maxClipSize;
+	uint32 _size;
+
+	uint32 _hits;
+	uint32 _misses;
+	uint32 _evictions;
+};
+
+} // End of namespace Audio
+
+/** Shortcut for accessing the PCM cache. */
+#define PCMCacheMan	Audio::PCMCache::instance()
+
+#endif
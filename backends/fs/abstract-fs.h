@@ -183,6 +183,24 @@ public:
 	 */
 	virtual Common::SeekableReadStream *createReadStream() = 0;
 
+	/**
+	 * Creates a MemoryReadStream instance over the file referred by this
+	 * node, mapped into memory. Backends which can not map files do not need
+	 * to implement this.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	virtual Common::MemoryReadStream *createMappedReadStream() { return nullptr; }
+
+	/**
+	 * Returns the time the file referred by this node was last modified,
+	 * in seconds since the epoch. Backends which can not query it do not
+	 * need to implement this.
+	 *
+	 * @return the modification time, 0 if it is not known
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -96,6 +96,14 @@ Common::SeekableReadStream *ChRootFilesystemNode::createReadStream() {
 	return _realNode->createReadStream();
 }
 
+Common::MemoryReadStream *ChRootFilesystemNode::createMappedReadStream() {
+	return _realNode->createMappedReadStream();
+}
+
+uint32 ChRootFilesystemNode::getModificationTime() const {
+	return _realNode->getModificationTime();
+}
+
 Common::WriteStream *ChRootFilesystemNode::createWriteStream() {
 	return _realNode->createWriteStream();
 }
@@ -48,6 +48,8 @@ public:
 	virtual AbstractFSNode *getParent() const;
 
 	virtual Common::SeekableReadStream *createReadStream();
+	virtual Common::MemoryReadStream *createMappedReadStream();
+	virtual uint32 getModificationTime() const;
 	virtual Common::WriteStream *createWriteStream();
 	virtual bool createDirectory();
 
@@ -34,6 +34,9 @@
 
 #include "backends/fs/posix/posix-fs.h"
 #include "backends/fs/posix/posix-iostream.h"
+#ifndef PSP2
+#include "backends/fs/posix/posix-mappedstream.h"
+#endif
 #include "common/algorithm.h"
 
 #include <sys/param.h>
@@ -312,6 +315,22 @@ Common::SeekableReadStream *POSIXFilesystemNode::createReadStream() {
 	return PosixIoStream::makeFromPath(getPath(), false);
 }
 
+Common::MemoryReadStream *POSIXFilesystemNode::createMappedReadStream() {
+#ifdef PSP2
+	return nullptr;
+#else
+	return PosixMappedStream::makeFromPath(getPath());
+#endif
+}
+
+uint32 POSIXFilesystemNode::getModificationTime() const {
+	struct stat st;
+	if (stat(_path.c_str(), &st) != 0)
+		return 0;
+
+	return st.st_mtime;
+}
+
 Common::WriteStream *POSIXFilesystemNode::createWriteStream() {
 	return PosixIoStream::makeFromPath(getPath(), true);
 }
@@ -0,0 +1,63 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "backends/fs/posix/posix-mappedstream.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+PosixMappedStream *PosixMappedStream::makeFromPath(const Common::String &path) {
+	int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1)
+		return nullptr;
+
+	// Empty files can not be mapped, and the streams can not address more than 2 GB
+	struct stat st;
+	if (fstat(fd, &st) == -1 || st.st_size <= 0 || st.st_size > 0x7FFFFFFF) {
+		close(fd);
+		return nullptr;
+	}
+
+	void *data = mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+
+	// The mapping stays valid once the file is closed
+	close(fd);
+
+	if (data == MAP_FAILED)
+		return nullptr;
+
+	return new PosixMappedStream(data, st.st_size);
+}
+
+PosixMappedStream::PosixMappedStream(void *data, uint32 size) :
+		MemoryReadStream((const byte *)data, size),
+		_mapping(data),
+		_mappingSize(size) {
+}
+
+PosixMappedStream::~PosixMappedStream() {
+	munmap(_mapping, _mappingSize);
+}
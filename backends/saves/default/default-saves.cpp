@@ -133,7 +133,9 @@ Common::InSaveFile *DefaultSaveFileManager::openForLoading(const Common::String
 	} else {
 		// Open the file for loading.
 		Common::SeekableReadStream *sf = file->_value.createReadStream();
-		return Common::wrapCompressedReadStream(sf);
+		// Some engines seek back and forth in their saves, keep them from
+		// decompressing the save again from its start each time
+		return Common::wrapCompressedReadStream(sf, 0, 256 * 1024);
 	}
 }
 
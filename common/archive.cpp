@@ -265,6 +265,20 @@ SeekableReadStream *SearchSet::createReadStreamForMember(const String &name) con
 	return nullptr;
 }
 
+MemoryReadStream *SearchSet::createMappedReadStreamForMember(const String &name) const {
+	if (name.empty())
+		return nullptr;
+
+	// Only map the file the regular lookup would open
+	ArchiveNodeList::const_iterator it = _list.begin();
+	for (; it != _list.end(); ++it) {
+		if (it->_arc->hasFile(name))
+			return it->_arc->createMappedReadStreamForMember(name);
+	}
+
+	return nullptr;
+}
+
 
 SearchManager::SearchManager() {
 	clear(); // Force a reset
@@ -31,6 +31,7 @@
 namespace Common {
 
 class FSNode;
+class MemoryReadStream;
 class SeekableReadStream;
 
 
@@ -48,6 +49,18 @@ public:
 	virtual SeekableReadStream *createReadStream() const = 0;
 	virtual String getName() const = 0;
 	virtual String getDisplayName() const { return getName(); }
+
+	/**
+	 * Return the time the member was last modified, in seconds since the
+	 * epoch, or 0 if it is not known.
+	 */
+	virtual uint32 getModificationTime() const { return 0; }
+
+	/**
+	 * Return the path of the file the member is read from, if it is a file
+	 * of its own rather than a part of an archive file, or an empty string.
+	 */
+	virtual String getPath() const { return String(); }
 };
 
 typedef SharedPtr<ArchiveMember> ArchiveMemberPtr;
@@ -123,6 +136,15 @@ public:
 	 * @return the newly created input stream
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const = 0;
+
+	/**
+	 * Create a stream over the whole member with the specified name, mapped
+	 * into memory. The stream does not copy the data, so large files can be
+	 * read in place. This is only possible for some archives and backends,
+	 * 0 is returned otherwise and createReadStreamForMember() should be used.
+	 * @return the newly created input stream
+	 */
+	virtual MemoryReadStream *createMappedReadStreamForMember(const String &name) const { return nullptr; }
 };
 
 
@@ -251,6 +273,12 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
 
+	/**
+	 * Implements createMappedReadStreamForMember from Archive base class, with
+	 * the same policy as createReadStreamForMember.
+	 */
+	virtual MemoryReadStream *createMappedReadStreamForMember(const String &name) const;
+
 	/**
 	 * Ignore clashes when adding directories. For more details see the corresponding parameter
 	 * in FSDirectory documentation
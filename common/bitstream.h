@@ -324,6 +324,10 @@ public:
 		return _size;
 	}
 
+	const byte *getData() const {
+		return _ptrOrig;
+	}
+
 	bool seek(uint32 offset) {
 		assert(offset <= _size);
 
@@ -420,6 +424,216 @@ public:
 };
 
 
+/**
+ * A bit stream reading directly from a memory buffer.
+ *
+ * This implements the same interface as BitStreamImpl, for the memory
+ * layouts where the bits follow the byte order of the buffer: bytes
+ * and little-endian values read LSB to MSB, and bytes and big-endian
+ * values read MSB to LSB.
+ *
+ * Instead of reading one data value at a time, the next 64 bits of the
+ * buffer are loaded into the cache with a single memory access whenever
+ * it runs short, so peeking and skipping are just shifts.
+ */
+template<int valueBits, bool MSB2LSB>
+class BitStreamMemoryImpl {
+private:
+	BitStreamMemoryStream *_stream; ///< The input stream.
+	DisposeAfterUse::Flag _disposeAfterUse; ///< Should we delete the stream on destruction?
+
+	const byte *_data; ///< The stream's data.
+	uint32 _dataSize;  ///< Size of the data in bytes, excluding a trailing partial data value.
+
+	uint64 _cache;    ///< The bits at the current position.
+	uint8  _cacheBits; ///< Number of bits currently valid in the cache.
+	uint32 _size;     ///< Total bitstream size (in bits)
+	uint32 _pos;      ///< Current bitstream position (in bits)
+
+	void init() {
+		if ((valueBits != 8) && (valueBits != 16) && (valueBits != 32))
+			error("BitStreamMemoryImpl: Invalid memory layout %d, %d", valueBits, MSB2LSB);
+
+		_data = _stream->getData();
+		_dataSize = _stream->size() & ~((uint32) ((valueBits >> 3) - 1));
+		_size = _dataSize * 8;
+		_cache = 0;
+		_cacheBits = 0;
+		_pos = 0;
+	}
+
+	/** Load the 64 bits starting at the byte containing the current position. */
+	inline void fillCache() {
+		const uint32 bytePos = _pos >> 3;
+
+		uint64 data;
+		if (bytePos + 8 <= _dataSize) {
+			data = MSB2LSB ? READ_BE_UINT64(_data + bytePos) : READ_LE_UINT64(_data + bytePos);
+		} else {
+			// Peeking data out of bounds is well defined and returns 0 bits,
+			// just like BitStreamImpl does.
+			data = 0;
+			for (uint32 i = 0; i < 8 && bytePos + i < _dataSize; i++) {
+				if (MSB2LSB)
+					data |= (uint64)_data[bytePos + i] << (56 - 8 * i);
+				else
+					data |= (uint64)_data[bytePos + i] << (8 * i);
+			}
+		}
+
+		const uint8 offset = _pos & 7;
+
+		if (MSB2LSB)
+			_cache = data << offset;
+		else
+			_cache = data >> offset;
+
+		_cacheBits = 64 - offset;
+	}
+
+	/** Get n bits from the cache. */
+	inline uint32 getNBits(size_t n) const {
+		if (n == 0)
+			return 0;
+
+		if (MSB2LSB)
+			return _cache >> (64 - n);
+		else
+			return _cache & (((uint64)1 << n) - 1);
+	}
+
+public:
+	/** Create a bit stream using this input data stream and optionally delete it on destruction. */
+	BitStreamMemoryImpl(BitStreamMemoryStream *stream, DisposeAfterUse::Flag disposeAfterUse = DisposeAfterUse::NO) :
+	    _stream(stream), _disposeAfterUse(disposeAfterUse) {
+		init();
+	}
+
+	/** Create a bit stream using this input data stream. */
+	BitStreamMemoryImpl(BitStreamMemoryStream &stream) :
+	    _stream(&stream), _disposeAfterUse(DisposeAfterUse::NO) {
+		init();
+	}
+
+	~BitStreamMemoryImpl() {
+		if (_disposeAfterUse == DisposeAfterUse::YES)
+			delete _stream;
+	}
+
+	/** Read a bit from the bit stream, without changing the stream's position. */
+	uint peekBit() {
+		if (_cacheBits < 1)
+			fillCache();
+
+		return getNBits(1);
+	}
+
+	/** Read a bit from the bit stream. */
+	uint getBit() {
+		const uint b = peekBit();
+
+		skip(1);
+
+		return b;
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream, without changing the stream's position.
+	 *
+	 * The bit order is the same as in getBits().
+	 */
+	uint32 peekBits(size_t n) {
+		if (n > 32)
+			error("BitStreamMemoryImpl::peekBits(): Too many bits requested to be peeked");
+
+		if (_cacheBits < n)
+			fillCache();
+
+		return getNBits(n);
+	}
+
+	/**
+	 * Read a multi-bit value from the bit stream.
+	 *
+	 * The value is read as if just taken as a whole from the bitstream.
+	 * See BitStreamImpl::getBits().
+	 */
+	uint32 getBits(size_t n) {
+		if (n > 32)
+			error("BitStreamMemoryImpl::getBits(): Too many bits requested to be read");
+
+		const uint32 b = peekBits(n);
+
+		skip(n);
+
+		return b;
+	}
+
+	/**
+	 * Add a bit to the value x, making it an n+1-bit value.
+	 *
+	 * See BitStreamImpl::addBit().
+	 */
+	void addBit(uint32 &x, uint32 n) {
+		if (n >= 32)
+			error("BitStreamMemoryImpl::addBit(): Too many bits requested to be read");
+
+		if (MSB2LSB)
+			x = (x << 1) | getBit();
+		else
+			x = (x & ~(1 << n)) | (getBit() << n);
+	}
+
+	/** Rewind the bit stream back to the start. */
+	void rewind() {
+		_cacheBits = 0;
+		_pos       = 0;
+	}
+
+	/** Skip the specified amount of bits. */
+	void skip(uint32 n) {
+		if (n < _cacheBits) {
+			if (MSB2LSB)
+				_cache <<= n;
+			else
+				_cache >>= n;
+
+			_cacheBits -= n;
+		} else {
+			_cacheBits = 0;
+		}
+
+		_pos += n;
+	}
+
+	/** Skip the bits to closest data value border. */
+	void align() {
+		uint32 bitsAfterBoundary = _pos % valueBits;
+		if (bitsAfterBoundary) {
+			skip(valueBits - bitsAfterBoundary);
+		}
+	}
+
+	/** Return the stream position in bits. */
+	uint32 pos() const {
+		return _pos;
+	}
+
+	/** Return the stream size in bits. */
+	uint32 size() const {
+		return _size;
+	}
+
+	bool eos() const {
+		return _pos >= _size;
+	}
+
+	static bool isMSB2LSB() {
+		return MSB2LSB;
+	}
+};
+
+
 // typedefs for various memory layouts.
 
 /** 8-bit data, MSB to LSB. */
@@ -448,25 +662,25 @@ typedef BitStreamImpl<SeekableReadStream, 32, false, false> BitStream32BELSB;
 
 
 /** 8-bit data, MSB to LSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 8, false, true > BitStreamMemory8MSB;
+typedef BitStreamMemoryImpl<8, true > BitStreamMemory8MSB;
 /** 8-bit data, LSB to MSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 8, false, false> BitStreamMemory8LSB;
+typedef BitStreamMemoryImpl<8, false> BitStreamMemory8LSB;
 
 /** 16-bit little-endian data, MSB to LSB. */
 typedef BitStreamImpl<BitStreamMemoryStream, 16, true , true > BitStreamMemory16LEMSB;
 /** 16-bit little-endian data, LSB to MSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 16, true , false> BitStreamMemory16LELSB;
+typedef BitStreamMemoryImpl<16, false> BitStreamMemory16LELSB;
 /** 16-bit big-endian data, MSB to LSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 16, false, true > BitStreamMemory16BEMSB;
+typedef BitStreamMemoryImpl<16, true > BitStreamMemory16BEMSB;
 /** 16-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<BitStreamMemoryStream, 16, false, false> BitStreamMemory16BELSB;
 
 /** 32-bit little-endian data, MSB to LSB. */
 typedef BitStreamImpl<BitStreamMemoryStream, 32, true , true > BitStreamMemory32LEMSB;
 /** 32-bit little-endian data, LSB to MSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 32, true , false> BitStreamMemory32LELSB;
+typedef BitStreamMemoryImpl<32, false> BitStreamMemory32LELSB;
 /** 32-bit big-endian data, MSB to LSB. */
-typedef BitStreamImpl<BitStreamMemoryStream, 32, false, true > BitStreamMemory32BEMSB;
+typedef BitStreamMemoryImpl<32, true > BitStreamMemory32BEMSB;
 /** 32-bit big-endian data, LSB to MSB. */
 typedef BitStreamImpl<BitStreamMemoryStream, 32, false, false> BitStreamMemory32BELSB;
 
@@ -24,9 +24,36 @@
 
 #include "common/cosinetables.h"
 #include "common/scummsys.h"
+#include "common/math.h"
+#include "common/mutex.h"
+#include "common/system.h"
 
 namespace Common {
 
+// Shared tables, indexed by log2(nPoints) - 4
+static struct {
+	CosineTable *table;
+	int refCount;
+} s_sharedCosineTables[13];
+
+// Guards the shared tables, which may be acquired by decoders on different threads
+static MutexRef s_sharedCosineTablesMutex = nullptr;
+
+static void lockSharedCosineTables() {
+	// As for the String memory pool, the tables may be used before the backend
+	// is initialized, but there is only one thread at that point.
+	if (!g_system || !g_system->backendInitialized())
+		return;
+	if (!s_sharedCosineTablesMutex)
+		s_sharedCosineTablesMutex = g_system->createMutex();
+	g_system->lockMutex(s_sharedCosineTablesMutex);
+}
+
+static void unlockSharedCosineTables() {
+	if (s_sharedCosineTablesMutex)
+		g_system->unlockMutex(s_sharedCosineTablesMutex);
+}
+
 CosineTable::CosineTable(int nPoints) {
 	assert((nPoints >= 16) && (nPoints <= 65536)); // log2 space is in [4,16]
 	assert(nPoints % 4 == 0);
@@ -76,4 +103,33 @@ CosineTable::~CosineTable() {
 	delete[] _table;
 }
 
+const CosineTable *CosineTable::acquire(int nPoints) {
+	assert((nPoints >= 16) && (nPoints <= 65536) && !(nPoints & (nPoints - 1)));
+
+	const int index = intLog2(nPoints) - 4;
+	lockSharedCosineTables();
+	if (!s_sharedCosineTables[index].table)
+		s_sharedCosineTables[index].table = new CosineTable(nPoints);
+
+	s_sharedCosineTables[index].refCount++;
+	const CosineTable *shared = s_sharedCosineTables[index].table;
+	unlockSharedCosineTables();
+	return shared;
+}
+
+void CosineTable::release(const CosineTable *table) {
+	if (!table)
+		return;
+
+	const int index = intLog2(table->_nPoints) - 4;
+	lockSharedCosineTables();
+	assert(s_sharedCosineTables[index].table == table && s_sharedCosineTables[index].refCount > 0);
+
+	if (--s_sharedCosineTables[index].refCount == 0) {
+		delete s_sharedCosineTables[index].table;
+		s_sharedCosineTables[index].table = nullptr;
+	}
+	unlockSharedCosineTables();
+}
+
 } // End of namespace Common
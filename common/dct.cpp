@@ -30,10 +30,11 @@
 
 namespace Common {
 
-DCT::DCT(int bits, TransformType trans) : _bits(bits), _cos(1 << (_bits + 2) ), _trans(trans), _rdft(nullptr) {
+DCT::DCT(int bits, TransformType trans) : _bits(bits), _trans(trans), _rdft(nullptr) {
 	int n = 1 << _bits;
 
-	_tCos = _cos.getTable();
+	_cos = CosineTable::acquire(1 << (_bits + 2));
+	_tCos = _cos->getTable();
 
 	_csc2 = new float[n / 2];
 
@@ -44,6 +45,7 @@ DCT::DCT(int bits, TransformType trans) : _bits(bits), _cos(1 << (_bits + 2) ),
 }
 
 DCT::~DCT() {
+	CosineTable::release(_cos);
 	delete _rdft;
 	delete[] _csc2;
 }
@@ -61,7 +61,7 @@ private:
 	int _bits;
 	TransformType _trans;
 
-	CosineTable _cos;
+	const CosineTable *_cos;
 	const float *_tCos;
 
 	float *_csc2;
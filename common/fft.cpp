@@ -31,13 +31,16 @@
 #include "common/util.h"
 #include "common/textconsole.h"
 
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+
 namespace Common {
 
 FFT::FFT(int bits, int inverse) : _bits(bits), _inverse(inverse) {
 	assert((_bits >= 2) && (_bits <= 16));
 
 	int n = 1 << bits;
-	int nPoints;
 
 	_tmpBuf = new Complex[n];
 	_expTab = new Complex[n / 2];
@@ -48,20 +51,19 @@ FFT::FFT(int bits, int inverse) : _bits(bits), _inverse(inverse) {
 	for (int i = 0; i < n; i++)
 		_revTab[-splitRadixPermutation(i, n, _inverse) & (n - 1)] = i;
 
+	// The twiddle factors only depend on the size, so they are shared
+	// with all other transforms using the same sizes.
 	for (int i = 0; i < ARRAYSIZE(_cosTables); i++) {
-		if (i + 4 <= _bits) {
-			nPoints = 1 << (i + 4);
-			_cosTables[i] = new Common::CosineTable(nPoints);
-		}
+		if (i + 4 <= _bits)
+			_cosTables[i] = CosineTable::acquire(1 << (i + 4));
 		else
 			_cosTables[i] = nullptr;
 	}
 }
 
 FFT::~FFT() {
-	for (int i = 0; i < ARRAYSIZE(_cosTables); i++) {
-		delete _cosTables[i];
-	}
+	for (int i = 0; i < ARRAYSIZE(_cosTables); i++)
+		CosineTable::release(_cosTables[i]);
 
 	delete[] _revTab;
 	delete[] _expTab;
@@ -155,6 +157,65 @@ int FFT::splitRadixPermutation(int i, int n, int inverse) {
 	BUTTERFLIES(a0, a1, a2, a3) \
 }
 
+#if defined(__SSE__)
+
+static inline void loadComplex4(const Complex *z, __m128 &re, __m128 &im) {
+	const __m128 lo = _mm_loadu_ps(&z[0].re);
+	const __m128 hi = _mm_loadu_ps(&z[2].re);
+
+	re = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));
+	im = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));
+}
+
+static inline void storeComplex4(Complex *z, __m128 re, __m128 im) {
+	_mm_storeu_ps(&z[0].re, _mm_unpacklo_ps(re, im));
+	_mm_storeu_ps(&z[2].re, _mm_unpackhi_ps(re, im));
+}
+
+/* z[0...8n-1], w[1...2n-1]
+ * Same as the scalar pass below, doing four TRANSFORMs at a time with
+ * the real and imaginary parts split into separate vectors. */
+static void pass(Complex *z, const float *wre, unsigned int n) {
+	const int o1 = 2 * n;
+	const int o2 = 4 * n;
+	const int o3 = 6 * n;
+	const float *wim = wre + o1;
+
+	assert((o1 % 4) == 0);
+
+	for (int k = 0; k < o1; k += 4) {
+		__m128 r0, i0, r1, i1, r2, i2, r3, i3;
+		loadComplex4(z + k, r0, i0);
+		loadComplex4(z + o1 + k, r1, i1);
+		loadComplex4(z + o2 + k, r2, i2);
+		loadComplex4(z + o3 + k, r3, i3);
+
+		// wim is walked backwards
+		const __m128 wr = _mm_loadu_ps(wre + k);
+		__m128 wi = _mm_loadu_ps(wim - k - 3);
+		wi = _mm_shuffle_ps(wi, wi, _MM_SHUFFLE(0, 1, 2, 3));
+
+		const __m128 t1 = _mm_add_ps(_mm_mul_ps(r2, wr), _mm_mul_ps(i2, wi));
+		const __m128 t2 = _mm_sub_ps(_mm_mul_ps(i2, wr), _mm_mul_ps(r2, wi));
+		const __m128 t5 = _mm_sub_ps(_mm_mul_ps(r3, wr), _mm_mul_ps(i3, wi));
+		const __m128 t6 = _mm_add_ps(_mm_mul_ps(i3, wr), _mm_mul_ps(r3, wi));
+
+		const __m128 s3 = _mm_sub_ps(t5, t1);
+		const __m128 s5 = _mm_add_ps(t5, t1);
+		const __m128 s4 = _mm_sub_ps(t2, t6);
+		const __m128 s6 = _mm_add_ps(t2, t6);
+
+		storeComplex4(z + k,      _mm_add_ps(r0, s5), _mm_add_ps(i0, s6));
+		storeComplex4(z + o1 + k, _mm_add_ps(r1, s4), _mm_add_ps(i1, s3));
+		storeComplex4(z + o2 + k, _mm_sub_ps(r0, s5), _mm_sub_ps(i0, s6));
+		storeComplex4(z + o3 + k, _mm_sub_ps(r1, s4), _mm_sub_ps(i1, s3));
+	}
+}
+
+#define pass_big pass
+
+#else
+
 /* z[0...8n-1], w[1...2n-1] */
 #define PASS(name) \
 static void name(Complex *z, const float *wre, unsigned int n) { \
@@ -181,6 +242,8 @@ PASS(pass)
 #define BUTTERFLIES BUTTERFLIES_BIG
 PASS(pass_big)
 
+#endif // __SSE__
+
 void FFT::fft4(Complex *z) {
 	float t1, t2, t3, t4, t5, t6, t7, t8;
 
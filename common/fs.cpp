@@ -140,6 +140,23 @@ SeekableReadStream *FSNode::createReadStream() const {
 	return _realNode->createReadStream();
 }
 
+MemoryReadStream *FSNode::createMappedReadStream() const {
+	if (_realNode == nullptr)
+		return nullptr;
+
+	if (!_realNode->exists() || _realNode->isDirectory())
+		return nullptr;
+
+	return _realNode->createMappedReadStream();
+}
+
+uint32 FSNode::getModificationTime() const {
+	if (_realNode == nullptr || !_realNode->exists())
+		return 0;
+
+	return _realNode->getModificationTime();
+}
+
 WriteStream *FSNode::createWriteStream() const {
 	if (_realNode == nullptr)
 		return nullptr;
@@ -255,6 +272,17 @@ SeekableReadStream *FSDirectory::createReadStreamForMember(const String &name) c
 	return stream;
 }
 
+MemoryReadStream *FSDirectory::createMappedReadStreamForMember(const String &name) const {
+	if (name.empty() || !_node.isDirectory())
+		return nullptr;
+
+	FSNode *node = lookupCache(_fileCache, name);
+	if (!node)
+		return nullptr;
+
+	return node->createMappedReadStream();
+}
+
 FSDirectory *FSDirectory::getSubDirectory(const String &name, int depth, bool flat, bool ignoreClashes) {
 	return getSubDirectory(String(), name, depth, flat, ignoreClashes);
 }
@@ -35,6 +35,7 @@ class AbstractFSNode;
 namespace Common {
 
 class FSNode;
+class MemoryReadStream;
 class SeekableReadStream;
 class WriteStream;
 
@@ -168,7 +169,7 @@ public:
 	 *
 	 * @return the 'path' represented by this filesystem node
 	 */
-	String getPath() const;
+	virtual String getPath() const;
 
 	/**
 	 * Get the parent node of this node. If this node has no parent node,
@@ -222,6 +223,25 @@ public:
 	 */
 	virtual SeekableReadStream *createReadStream() const;
 
+	/**
+	 * Creates a read-only MemoryReadStream instance over the file referred
+	 * by this node, mapped into memory. The pages are shared with the system
+	 * file cache, and only read when accessed. If the node does not refer to
+	 * a readable file, or the backend can not map files, 0 is returned.
+	 *
+	 * @return pointer to the stream object, 0 in case of a failure
+	 */
+	MemoryReadStream *createMappedReadStream() const;
+
+	/**
+	 * Returns the time the file referred by this node was last modified, in
+	 * seconds since the epoch. If the node does not exist, or the backend
+	 * can not query it, 0 is returned.
+	 *
+	 * @return the modification time, 0 if it is not known
+	 */
+	virtual uint32 getModificationTime() const;
+
 	/**
 	 * Creates a WriteStream instance corresponding to the file
 	 * referred by this node. This assumes that the node actually refers
@@ -369,6 +389,12 @@ public:
 	 * for success.
 	 */
 	virtual SeekableReadStream *createReadStreamForMember(const String &name) const;
+
+	/**
+	 * Map the specified file into memory. A full match of relative path and
+	 * filename is needed for success.
+	 */
+	virtual MemoryReadStream *createMappedReadStreamForMember(const String &name) const;
 };
 
 
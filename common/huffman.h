@@ -26,7 +26,7 @@
 #define COMMON_HUFFMAN_H
 
 #include "common/array.h"
-#include "common/list.h"
+#include "common/hashmap.h"
 #include "common/types.h"
 
 namespace Common {
@@ -62,30 +62,59 @@ public:
 	/** Return the next symbol in the bitstream. */
 	uint32 getSymbol(BITSTREAM &bits) const;
 
+	/** Read count symbols from the bitstream into the symbols array. */
+	void getSymbols(BITSTREAM &bits, uint32 count, uint32 *symbols) const;
+
 private:
-	struct Symbol {
+	struct Code {
 		uint32 code;
+		uint8  length;
 		uint32 symbol;
 
-		Symbol(uint32 c, uint32 s) : code(c), symbol(s) {}
+		Code(uint32 c, uint8 l, uint32 s) : code(c), length(l), symbol(s) {}
 	};
 
-	typedef List<Symbol> CodeList;
-	typedef Array<CodeList> CodeLists;
+	typedef Array<Code> CodeList;
 
-	/** Lists of codes and their symbols, sorted by code length. */
-	CodeLists _codes;
+	/**
+	 * An entry of the lookup tables.
+	 *
+	 * Codes are decoded by looking up the next bits of the stream in the root
+	 * table. Codes longer than the index of a table continue in a sub table
+	 * indexed by the bits following it, so that each code takes one lookup
+	 * per table level instead of a search by length.
+	 */
+	struct TableEntry {
+		uint32 value;  ///< The symbol, or the index of the first entry of the sub table.
+		uint8  length; ///< The code bits used at this level, or the index size of the sub table.
+		uint8  type;   ///< One of the EntryType values.
 
-	/** Prefix lookup table used to speed up the decoding of short codes. */
-	struct PrefixEntry {
-		uint32 symbol;
-		uint8  length;
+		TableEntry() : value(0), length(0), type(kEntryInvalid) {}
+	};
 
-		PrefixEntry() : length(0xFF) {}
+	enum EntryType {
+		kEntryInvalid,
+		kEntrySymbol,
+		kEntryTable
 	};
 
-	static const uint8 _prefixTableBits = 8;
-	PrefixEntry _prefixTable[1 << _prefixTableBits];
+	/** All the lookup tables, starting with the root table. */
+	Array<TableEntry> _tables;
+
+	/** Maximum index size of the root table, in bits. */
+	static const uint8 _rootTableBits = 10;
+
+	/** Maximum index size of a sub table, in bits. */
+	static const uint8 _tableBits = 8;
+
+	/** Index size of the root table, in bits. */
+	uint8 _rootBits;
+
+	/** Fill the table at tableStart, indexed with tableBits bits following the first offset bits of the codes. */
+	void buildTable(uint32 tableStart, uint8 tableBits, uint8 offset, const CodeList &codes);
+
+	/** Return the table index for bits [offset, offset + count) of code, as the bitstream hands them out. */
+	static uint32 getIndex(const Code &code, uint8 offset, uint8 count, uint8 tableBits);
 };
 
 template <class BITSTREAM>
@@ -101,62 +130,119 @@ Huffman<BITSTREAM>::Huffman(uint8 maxLength, uint32 codeCount, const uint32 *cod
 
 	assert(maxLength <= 32);
 
-	// Codes that don't fit in the prefix table are stored in the _codes array
-	_codes.resize(MAX(maxLength - _prefixTableBits, 0));
+	CodeList codeList;
+	codeList.reserve(codeCount);
 
-	for (uint i = 0; i < codeCount; i++) {
-		uint8 length = lengths[i];
+	for (uint32 i = 0; i < codeCount; i++) {
+		assert(lengths[i] > 0);
 
 		// The symbol. If none were specified, just assume it's identical to the code index
-		uint32 symbol = symbols ? symbols[i] : i;
-
-		if (length <= _prefixTableBits) {
-			// Short codes go in the prefix lookup table. Set all the entries in the table
-			// with an index starting with the code to the symbol value.
-			uint32 startIndex;
-			if (BITSTREAM::isMSB2LSB()) {
-				startIndex = codes[i] << (_prefixTableBits - length);
-			} else {
-				startIndex = REVERSEBITS(codes[i]) >> (32 - _prefixTableBits);
-			}
-
-			uint32 endIndex = startIndex | ((1 << (_prefixTableBits - length)) - 1);
-
-			for (uint32 j = startIndex; j <= endIndex; j++) {
-				uint32 index = BITSTREAM::isMSB2LSB() ? j : REVERSEBITS(j) >> (32 - _prefixTableBits);
-				_prefixTable[index].symbol = symbol;
-				_prefixTable[index].length = length;
-			}
-		} else {
-			// Put the code and symbol into the correct list for the length
-			_codes[lengths[i] - 1 - _prefixTableBits].push_back(Symbol(codes[i], symbol));
+		codeList.push_back(Code(codes[i], lengths[i], symbols ? symbols[i] : i));
+	}
+
+	// Small code sets don't need a full size root table
+	_rootBits = MIN<uint8>(maxLength, _rootTableBits);
+
+	_tables.resize(1 << _rootBits);
+	buildTable(0, _rootBits, 0, codeList);
+}
+
+template <class BITSTREAM>
+uint32 Huffman<BITSTREAM>::getIndex(const Code &code, uint8 offset, uint8 count, uint8 tableBits) {
+	// The bits as they appear in the code, first bit in the stream first
+	uint32 bits = (code.code >> (code.length - offset - count)) & ((1 << count) - 1);
+
+	if (BITSTREAM::isMSB2LSB())
+		return bits << (tableBits - count);
+
+	return REVERSEBITS(bits) >> (32 - count);
+}
+
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::buildTable(uint32 tableStart, uint8 tableBits, uint8 offset, const CodeList &codes) {
+	// Codes continuing past this table, grouped by the table entry they start in
+	HashMap<uint32, CodeList> subCodes;
+
+	for (typename CodeList::const_iterator code = codes.begin(); code != codes.end(); ++code) {
+		const uint8 length = code->length - offset;
+
+		if (length > tableBits) {
+			subCodes[getIndex(*code, offset, tableBits, tableBits)].push_back(*code);
+			continue;
 		}
+
+		// Set all the entries in the table with an index starting with
+		// the code to the symbol value.
+		const uint32 index = getIndex(*code, offset, length, tableBits);
+		const uint32 fill = 1 << (tableBits - length);
+
+		for (uint32 j = 0; j < fill; j++) {
+			// The unused bits follow the code in the stream
+			const uint32 entry = BITSTREAM::isMSB2LSB() ? (index | j) : (index | (j << length));
+
+			_tables[tableStart + entry].value = code->symbol;
+			_tables[tableStart + entry].length = length;
+			_tables[tableStart + entry].type = kEntrySymbol;
+		}
+	}
+
+	for (typename HashMap<uint32, CodeList>::const_iterator sub = subCodes.begin(); sub != subCodes.end(); ++sub) {
+		uint8 maxLength = 0;
+		for (typename CodeList::const_iterator code = sub->_value.begin(); code != sub->_value.end(); ++code)
+			maxLength = MAX(maxLength, code->length);
+
+		const uint8 subOffset = offset + tableBits;
+		const uint8 subBits = MIN<uint8>(maxLength - subOffset, _tableBits);
+		const uint32 subStart = _tables.size();
+
+		_tables[tableStart + sub->_key].value = subStart;
+		_tables[tableStart + sub->_key].length = subBits;
+		_tables[tableStart + sub->_key].type = kEntryTable;
+
+		_tables.resize(subStart + (1 << subBits));
+		buildTable(subStart, subBits, subOffset, sub->_value);
 	}
 }
 
 template <class BITSTREAM>
 uint32 Huffman<BITSTREAM>::getSymbol(BITSTREAM &bits) const {
-	uint32 code = bits.peekBits(_prefixTableBits);
-
-	uint8 length = _prefixTable[code].length;
+	const TableEntry *tables = _tables.begin();
+	const TableEntry *entry = tables + bits.peekBits(_rootBits);
 
-	if (length != 0xFF) {
-		bits.skip(length);
-		return _prefixTable[code].symbol;
-	} else {
-		bits.skip(_prefixTableBits);
+	if (entry->type == kEntryTable) {
+		bits.skip(_rootBits);
 
-		for (uint32 i = 0; i < _codes.size(); i++) {
-			bits.addBit(code, i + _prefixTableBits);
+		while (entry->type == kEntryTable) {
+			const uint8 tableBits = entry->length;
+			entry = tables + entry->value + bits.peekBits(tableBits);
 
-			for (typename CodeList::const_iterator cCode = _codes[i].begin(); cCode != _codes[i].end(); ++cCode)
-				if (code == cCode->code)
-					return cCode->symbol;
+			if (entry->type == kEntryTable)
+				bits.skip(tableBits);
 		}
 	}
 
-	error("Unknown Huffman code");
-	return 0;
+	if (entry->type != kEntrySymbol)
+		error("Unknown Huffman code");
+
+	bits.skip(entry->length);
+	return entry->value;
+}
+
+template <class BITSTREAM>
+void Huffman<BITSTREAM>::getSymbols(BITSTREAM &bits, uint32 count, uint32 *symbols) const {
+	const TableEntry *root = _tables.begin();
+
+	for (uint32 i = 0; i < count; i++) {
+		const TableEntry *entry = root + bits.peekBits(_rootBits);
+
+		// Most symbols are decoded by the root table alone
+		if (entry->type == kEntrySymbol) {
+			bits.skip(entry->length);
+			symbols[i] = entry->value;
+		} else {
+			symbols[i] = getSymbol(bits);
+		}
+	}
 }
 
 } // End of namespace Common
@@ -33,12 +33,6 @@
 
 namespace Common {
 
-struct md5_context {
-	uint32 total[2];
-	uint32 state[4];
-	uint8 buffer[64];
-};
-
 static void md5_starts(md5_context *ctx);
 static void md5_update(md5_context *ctx, const uint8 *input, uint32 length);
 static void md5_finish(md5_context *ctx, uint8 digest[16]);
@@ -249,14 +243,18 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 #ifdef DISABLE_MD5
 	memset(digest, 0, 16);
 #else
+	// Whole game data files get hashed, read them in large blocks.
+	// Detection only hashes a few kilobytes, it gets a smaller buffer.
+	const uint32 bufSize = (length != 0 && length < 64 * 1024) ? length : 64 * 1024;
+
 	md5_context ctx;
 	int i;
-	unsigned char buf[1000];
+	unsigned char *buf = new unsigned char[bufSize];
 	bool restricted = (length != 0);
 	uint32 readlen;
 
-	if (!restricted || sizeof(buf) <= length)
-		readlen = sizeof(buf);
+	if (!restricted || bufSize <= length)
+		readlen = bufSize;
 	else
 		readlen = length;
 
@@ -270,26 +268,53 @@ bool computeStreamMD5(ReadStream &stream, uint8 digest[16], uint32 length) {
 			if (length == 0)
 				break;
 
-			if (sizeof(buf) > length)
+			if (bufSize > length)
 				readlen = length;
 		}
 	}
 
 	md5_finish(&ctx, digest);
+	delete[] buf;
 #endif
 	return true;
 }
 
-String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
+static String digestToString(const uint8 digest[16]) {
 	String md5;
+	for (int i = 0; i < 16; i++) {
+		md5 += String::format("%02x", (int)digest[i]);
+	}
+
+	return md5;
+}
+
+String computeStreamMD5AsString(ReadStream &stream, uint32 length) {
 	uint8 digest[16];
 	if (computeStreamMD5(stream, digest, length)) {
-		for (int i = 0; i < 16; i++) {
-			md5 += String::format("%02x", (int)digest[i]);
-		}
+		return digestToString(digest);
 	}
 
-	return md5;
+	return String();
+}
+
+MD5Context::MD5Context() {
+	md5_starts(&_ctx);
+}
+
+void MD5Context::update(const uint8 *data, uint32 length) {
+#ifndef DISABLE_MD5
+	md5_update(&_ctx, data, length);
+#endif
+}
+
+String MD5Context::finishAsString() {
+	uint8 digest[16];
+#ifdef DISABLE_MD5
+	memset(digest, 0, 16);
+#else
+	md5_finish(&_ctx, digest);
+#endif
+	return digestToString(digest);
 }
 
 } // End of namespace Common
@@ -30,6 +30,33 @@ namespace Common {
 class ReadStream;
 class String;
 
+struct md5_context {
+	uint32 total[2];
+	uint32 state[4];
+	uint8 buffer[64];
+};
+
+/**
+ * An MD5 checksum computed a block at a time, for data which is not
+ * available all at once.
+ */
+class MD5Context {
+public:
+	MD5Context();
+
+	/** Add the next length bytes of the data to the checksum */
+	void update(const uint8 *data, uint32 length);
+
+	/**
+	 * Compute the checksum of all the data added so far, as a lowercase
+	 * hex string of length 32. No data can be added afterwards.
+	 */
+	String finishAsString();
+
+private:
+	md5_context _ctx;
+};
+
 /**
  * Compute the MD5 checksum of the content of the given ReadStream.
  * The 128 bit MD5 checksum is returned directly in the array digest.
@@ -23,6 +23,7 @@
 #ifndef COMMON_MEMSTREAM_H
 #define COMMON_MEMSTREAM_H
 
+#include "common/ptr.h"
 #include "common/stream.h"
 #include "common/types.h"
 #include "common/util.h"
@@ -71,6 +72,31 @@ public:
 	int32 size() const { return _size; }
 
 	bool seek(int32 offs, int whence = SEEK_SET);
+
+	/** Returns the memory block the stream reads from. */
+	const byte *getData() const { return _ptrOrig; }
+};
+
+/**
+ * A MemoryReadStream over a part of the data of another memory stream,
+ * such as a file mapped into memory. The view holds a reference to the
+ * parent stream, which is kept alive until all its views are gone.
+ *
+ * The reference counts of the views are guarded by a lock, so that views
+ * may be created and deleted on any thread, e.g. by the mixer once a sound
+ * is done playing. The other references to the parent, such as the one
+ * an archive keeps to create views, must be released with releaseParent().
+ */
+class MemoryReadStreamView : public MemoryReadStream {
+public:
+	MemoryReadStreamView(const SharedPtr<MemoryReadStream> &parent, uint32 offset, uint32 size);
+	~MemoryReadStreamView();
+
+	/** Release a reference to a parent which may still have views on other threads. */
+	static void releaseParent(SharedPtr<MemoryReadStream> &parent);
+
+private:
+	SharedPtr<MemoryReadStream> _parent;
 };
 
 
@@ -28,7 +28,7 @@
 
 namespace Common {
 
-RDFT::RDFT(int bits, TransformType trans) : _bits(bits), _sin(1 << bits), _cos(1 << bits), _fft(nullptr) {
+RDFT::RDFT(int bits, TransformType trans) : _bits(bits), _sin(nullptr), _cos(nullptr), _fft(nullptr) {
 	assert((_bits >= 4) && (_bits <= 16));
 
 	_inverse        = trans == IDFT_C2R || trans == DFT_C2R;
@@ -38,11 +38,16 @@ RDFT::RDFT(int bits, TransformType trans) : _bits(bits), _sin(1 << bits), _cos(1
 
 	int n = 1 << bits;
 
-	_tSin = _sin.getTable() + (trans == DFT_R2C || trans == DFT_C2R) * (n >> 2);
-	_tCos = _cos.getTable();
+	_sin = SineTable::acquire(n);
+	_cos = CosineTable::acquire(n);
+
+	_tSin = _sin->getTable() + (trans == DFT_R2C || trans == DFT_C2R) * (n >> 2);
+	_tCos = _cos->getTable();
 }
 
 RDFT::~RDFT() {
+	SineTable::release(_sin);
+	CosineTable::release(_cos);
 	delete _fft;
 }
 
@@ -24,9 +24,36 @@
 
 #include "common/scummsys.h"
 #include "common/sinetables.h"
+#include "common/math.h"
+#include "common/mutex.h"
+#include "common/system.h"
 
 namespace Common {
 
+// Shared tables, indexed by log2(nPoints) - 4
+static struct {
+	SineTable *table;
+	int refCount;
+} s_sharedSineTables[13];
+
+// Guards the shared tables, which may be acquired by decoders on different threads
+static MutexRef s_sharedSineTablesMutex = nullptr;
+
+static void lockSharedSineTables() {
+	// As for the String memory pool, the tables may be used before the backend
+	// is initialized, but there is only one thread at that point.
+	if (!g_system || !g_system->backendInitialized())
+		return;
+	if (!s_sharedSineTablesMutex)
+		s_sharedSineTablesMutex = g_system->createMutex();
+	g_system->lockMutex(s_sharedSineTablesMutex);
+}
+
+static void unlockSharedSineTables() {
+	if (s_sharedSineTablesMutex)
+		g_system->unlockMutex(s_sharedSineTablesMutex);
+}
+
 SineTable::SineTable(int nPoints) {
 	assert((nPoints >= 16) && (nPoints <= 65536)); // log2 space is in [4,16]
 	assert(nPoints % 4 == 0);
@@ -79,4 +106,33 @@ SineTable::~SineTable() {
 	delete[] _table;
 }
 
+const SineTable *SineTable::acquire(int nPoints) {
+	assert((nPoints >= 16) && (nPoints <= 65536) && !(nPoints & (nPoints - 1)));
+
+	const int index = intLog2(nPoints) - 4;
+	lockSharedSineTables();
+	if (!s_sharedSineTables[index].table)
+		s_sharedSineTables[index].table = new SineTable(nPoints);
+
+	s_sharedSineTables[index].refCount++;
+	const SineTable *shared = s_sharedSineTables[index].table;
+	unlockSharedSineTables();
+	return shared;
+}
+
+void SineTable::release(const SineTable *table) {
+	if (!table)
+		return;
+
+	const int index = intLog2(table->_nPoints) - 4;
+	lockSharedSineTables();
+	assert(s_sharedSineTables[index].table == table && s_sharedSineTables[index].refCount > 0);
+
+	if (--s_sharedSineTables[index].refCount == 0) {
+		delete s_sharedSineTables[index].table;
+		s_sharedSineTables[index].table = nullptr;
+	}
+	unlockSharedSineTables();
+}
+
 } // End of namespace Common
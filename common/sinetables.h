@@ -35,6 +35,18 @@ public:
 	SineTable(int nPoints);
 	~SineTable();
 
+	/**
+	 * Get the table shared by all users of the given number of points,
+	 * creating it on first use. Every call must be paired with a call
+	 * to release().
+	 *
+	 * @param nPoints Number of distinct radian points, which must be a power of 2 in range [16,65536]
+	 */
+	static const SineTable *acquire(int nPoints);
+
+	/** Release a table returned by acquire(). */
+	static void release(const SineTable *table);
+
 	/**
 	 * Get pointer to table
 	 *
@@ -46,7 +58,7 @@ public:
 	 * - Entries 2_nPoints/4 up to nPoints/2:
 	 *           sin(pi) till (excluding) sin(3/2*pi)
 	 */
-	const float *getTable() { return _tableEOS; }
+	const float *getTable() const { return _tableEOS; }
 
 	/**
 	 * Returns sin(2*pi * index / nPoints )
@@ -23,8 +23,10 @@
 #include "common/ptr.h"
 #include "common/stream.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
 #include "common/substream.h"
 #include "common/str.h"
+#include "common/system.h"
 
 namespace Common {
 
@@ -115,6 +117,43 @@ bool MemoryReadStream::seek(int32 offs, int whence) {
 	return true; // FIXME: STREAM REWRITE
 }
 
+// Guards the reference counts of the parents of the views
+static MutexRef s_memoryViewMutex = nullptr;
+
+static void lockMemoryViews() {
+	// As for the String memory pool, views may be created before the backend
+	// is initialized, but there is only one thread at that point.
+	if (!g_system || !g_system->backendInitialized())
+		return;
+	if (!s_memoryViewMutex)
+		s_memoryViewMutex = g_system->createMutex();
+	g_system->lockMutex(s_memoryViewMutex);
+}
+
+static void unlockMemoryViews() {
+	if (s_memoryViewMutex)
+		g_system->unlockMutex(s_memoryViewMutex);
+}
+
+MemoryReadStreamView::MemoryReadStreamView(const SharedPtr<MemoryReadStream> &parent, uint32 offset, uint32 size) :
+		MemoryReadStream(parent->getData() + offset, size) {
+	assert(offset + size <= (uint32)parent->size());
+
+	lockMemoryViews();
+	_parent = parent;
+	unlockMemoryViews();
+}
+
+MemoryReadStreamView::~MemoryReadStreamView() {
+	releaseParent(_parent);
+}
+
+void MemoryReadStreamView::releaseParent(SharedPtr<MemoryReadStream> &parent) {
+	lockMemoryViews();
+	parent.reset();
+	unlockMemoryViews();
+}
+
 #pragma mark -
 
 enum {
@@ -24,6 +24,7 @@
 #define FORBIDDEN_SYMBOL_ALLOW_ALL
 
 #include "common/zlib.h"
+#include "common/array.h"
 #include "common/ptr.h"
 #include "common/util.h"
 #include "common/stream.h"
@@ -40,6 +41,11 @@
   #if ZLIB_VERNUM < 0x1204
   #error Version 1.2.0.4 or newer of zlib is required for this code
   #endif
+
+  // Resuming the decompression from a checkpoint needs inflateGetDictionary
+  #if ZLIB_VERNUM >= 0x1271
+  #define ZLIB_HAS_SEEK_CHECKPOINTS
+  #endif
 #endif
 
 
@@ -153,7 +159,20 @@ static bool _shownBackwardSeekingWarning = false;
 class GZipReadStream : public SeekableReadStream {
 protected:
 	enum {
-		BUFSIZE = 16384		// 1 << MAX_WBITS
+		BUFSIZE = 16384,	// 1 << MAX_WBITS
+		WINDOWSIZE = 32768	// The largest deflate window
+	};
+
+	/**
+	 * The state of the decompression at a deflate block boundary,
+	 * from which it can be resumed without the preceding data.
+	 */
+	struct Checkpoint {
+		uint32 outPos;		///< Position in the decompressed data
+		uint32 inPos;		///< Position of the next full byte in the wrapped stream
+		int bits;			///< Bits of the byte before inPos still to be decompressed
+		uint windowSize;
+		byte window[WINDOWSIZE];	///< The last decompressed bytes, the dictionary
 	};
 
 	byte	_buf[BUFSIZE];
@@ -165,9 +184,65 @@ protected:
 	uint32 _origSize;
 	bool _eos;
 
+	uint32 _checkpointInterval;
+	Array<Checkpoint *> _checkpoints;
+
+#ifdef ZLIB_HAS_SEEK_CHECKPOINTS
+	void addCheckpoint(uint32 outPos) {
+		uint32 lastPos = _checkpoints.empty() ? 0 : _checkpoints.back()->outPos;
+		if (outPos < lastPos + _checkpointInterval)
+			return;
+
+		Checkpoint *checkpoint = new Checkpoint();
+		checkpoint->outPos = outPos;
+		checkpoint->inPos = _wrapped->pos() - _stream.avail_in;
+		checkpoint->bits = _stream.data_type & 7;
+
+		uInt windowSize = WINDOWSIZE;
+		inflateGetDictionary(&_stream, checkpoint->window, &windowSize);
+		checkpoint->windowSize = windowSize;
+
+		_checkpoints.push_back(checkpoint);
+	}
+
+	bool resumeFromCheckpoint(const Checkpoint *checkpoint) {
+		// The checkpoint is in the middle of the deflate data, past any header
+		_zlibErr = inflateReset2(&_stream, -MAX_WBITS);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		if (checkpoint->bits) {
+			_wrapped->seek(checkpoint->inPos - 1, SEEK_SET);
+			byte partialByte = _wrapped->readByte();
+			inflatePrime(&_stream, checkpoint->bits, partialByte >> (8 - checkpoint->bits));
+		} else {
+			_wrapped->seek(checkpoint->inPos, SEEK_SET);
+		}
+
+		_zlibErr = inflateSetDictionary(&_stream, checkpoint->window, checkpoint->windowSize);
+		if (_zlibErr != Z_OK)
+			return false;
+
+		_stream.next_in = _buf;
+		_stream.avail_in = 0;
+		_pos = checkpoint->outPos;
+		return true;
+	}
+
+	const Checkpoint *findCheckpoint(uint32 pos) const {
+		// The last checkpoint at or before pos
+		const Checkpoint *checkpoint = nullptr;
+		for (uint i = 0; i < _checkpoints.size() && _checkpoints[i]->outPos <= pos; i++) {
+			checkpoint = _checkpoints[i];
+		}
+		return checkpoint;
+	}
+#endif
+
 public:
 
-	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0) : _wrapped(w), _stream() {
+	GZipReadStream(SeekableReadStream *w, uint32 knownSize = 0, uint32 checkpointInterval = 0) :
+			_wrapped(w), _stream(), _checkpointInterval(checkpointInterval) {
 		assert(w != nullptr);
 
 		// Verify file header is correct
@@ -205,6 +280,10 @@ public:
 
 	~GZipReadStream() {
 		inflateEnd(&_stream);
+
+		for (uint i = 0; i < _checkpoints.size(); i++) {
+			delete _checkpoints[i];
+		}
 	}
 
 	bool err() const { return (_zlibErr != Z_OK) && (_zlibErr != Z_STREAM_END); }
@@ -224,6 +303,20 @@ public:
 				_stream.next_in = _buf;
 				_stream.avail_in = _wrapped->read(_buf, BUFSIZE);
 			}
+
+#ifdef ZLIB_HAS_SEEK_CHECKPOINTS
+			if (_checkpointInterval) {
+				// Stop at each block boundary, to record checkpoints
+				_zlibErr = inflate(&_stream, Z_BLOCK);
+
+				bool blockEnd = (_stream.data_type & 128) && !(_stream.data_type & 64);
+				uint32 outPos = _pos + dataSize - _stream.avail_out;
+				if (_zlibErr == Z_OK && blockEnd && outPos > 0)
+					addCheckpoint(outPos);
+				continue;
+			}
+#endif
+
 			_zlibErr = inflate(&_stream, Z_NO_FLUSH);
 		}
 
@@ -262,6 +355,15 @@ public:
 
 		assert(newPos >= 0);
 
+#ifdef ZLIB_HAS_SEEK_CHECKPOINTS
+		// Resume from the closest checkpoint, if that skips over some data
+		const Checkpoint *checkpoint = findCheckpoint(newPos);
+		if (checkpoint && (checkpoint->outPos > _pos || (uint32)newPos < _pos)) {
+			if (!resumeFromCheckpoint(checkpoint))
+				return false;
+		}
+#endif
+
 		if ((uint32)newPos < _pos) {
 			// To search backward, we have to restart the whole decompression
 			// from the start of the file. A rather wasteful operation, best
@@ -279,7 +381,12 @@ public:
 
 			_pos = 0;
 			_wrapped->seek(0, SEEK_SET);
+#ifdef ZLIB_HAS_SEEK_CHECKPOINTS
+			// Resuming from a checkpoint switched to raw deflate data
+			_zlibErr = inflateReset2(&_stream, MAX_WBITS + 32);
+#else
 			_zlibErr = inflateReset(&_stream);
+#endif
 			if (_zlibErr != Z_OK)
 				return false; // FIXME: STREAM REWRITE
 			_stream.next_in = _buf;
@@ -413,7 +520,7 @@ public:
 
 #endif	// USE_ZLIB
 
-SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize) {
+SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize, uint32 seekCheckpointInterval) {
 	if (toBeWrapped) {
 		uint16 header = toBeWrapped->readUint16BE();
 		bool isCompressed = (header == 0x1F8B ||
@@ -422,7 +529,7 @@ SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, ui
 		toBeWrapped->seek(-2, SEEK_CUR);
 		if (isCompressed) {
 #if defined(USE_ZLIB)
-			return new GZipReadStream(toBeWrapped, knownSize);
+			return new GZipReadStream(toBeWrapped, knownSize, seekCheckpointInterval);
 #else
 			delete toBeWrapped;
 			return NULL;
@@ -116,10 +116,17 @@ bool inflateZlibInstallShield(byte *dst, uint dstLen, const byte *src, uint srcL
  * It is safe to call this with a NULL parameter (in this case, NULL is
  * returned).
  *
+ * Seeking backwards in a compressed stream normally restarts the
+ * decompression from the beginning. If seekCheckpointInterval is not zero,
+ * the state of the decompression is saved about every seekCheckpointInterval
+ * bytes of decompressed data, the first time it is read. Seeks then resume
+ * from the closest checkpoint. Each checkpoint takes 32 KB of memory.
+ *
  * @param toBeWrapped	the stream to be wrapped (if it is in gzip-format)
  * @param knownSize		a supplied length of the compressed data (if not available directly)
+ * @param seekCheckpointInterval	the decompressed bytes between two seek checkpoints, 0 to disable them
  */
-SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0);
+SeekableReadStream *wrapCompressedReadStream(SeekableReadStream *toBeWrapped, uint32 knownSize = 0, uint32 seekCheckpointInterval = 0);
 
 /**
  * Take an arbitrary WriteStream and wrap it in a custom stream which provides
@@ -26,6 +26,7 @@
 #include "engines/grim/debugger.h"
 #include "engines/grim/md5check.h"
 #include "engines/grim/grim.h"
+#include "engines/grim/resource.h"
 
 namespace Grim {
 
@@ -38,6 +39,7 @@ Debugger::Debugger() :
 	registerCmd("set_renderer", WRAP_METHOD(Debugger, cmd_set_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("resource_cache", WRAP_METHOD(Debugger, cmd_resource_cache));
 }
 
 Debugger::~Debugger() {
@@ -127,4 +129,11 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_resource_cache(int argc, const char **argv) {
+	ResourceLoader::CacheStats stats = g_resourceloader->getCacheStats();
+	debugPrintf("Files: %u, %u of %u KB\n", stats.entries, stats.memorySize / 1024, stats.memoryBudget / 1024);
+	debugPrintf("Hits: %u, misses: %u, evictions: %u\n", stats.hits, stats.misses, stats.evictions);
+	return true;
+}
+
 }
@@ -117,6 +117,8 @@ void Lua_V2::ImSetState() {
 
 	int state = (int)lua_getnumber(stateObj);
 	g_imuseState = state;
+	// The state is applied on the next frame, open the track meanwhile.
+	g_emiSound->prefetchMusicState(state);
 	Debug::debug(Debug::Sound | Debug::Scripts, "Lua_V2::ImSetState: stub, state: %d", state);
 }
 
@@ -572,6 +574,7 @@ void Lua_V2::ImPushState() {
 	if (lua_isnumber(stateObj)) {
 		int state = (int)lua_getnumber(stateObj);
 		g_imuseState = state;
+		g_emiSound->prefetchMusicState(state);
 	}
 
 	Debug::debug(Debug::Sound | Debug::Scripts, "Lua_V2::ImPushState: currently guesswork");
@@ -24,6 +24,7 @@
 #include "audio/mixer.h"
 #include "audio/audiostream.h"
 #include "audio/decoders/aiff.h"
+#include "audio/pcmcache.h"
 #include "engines/grim/debug.h"
 #include "engines/grim/resource.h"
 #include "engines/grim/emi/sound/aifftrack.h"
@@ -48,19 +49,29 @@ AIFFTrack::~AIFFTrack() {
 }
 
 bool AIFFTrack::openSound(const Common::String &filename, const Common::String &soundName, const Audio::Timestamp *start) {
-	Common::SeekableReadStream *file = g_resourceloader->openNewStreamFile(filename, true);
-	if (!file) {
-		Debug::debug(Debug::Sound, "Stream for %s not open", soundName.c_str());
-		return false;
+	// Sound effects are short and replayed often, keep them decoded.
+	const bool cached = _soundType == Audio::Mixer::kSFXSoundType;
+	Audio::RewindableAudioStream *aiffStream = nullptr;
+	if (cached)
+		aiffStream = PCMCacheMan.find(filename);
+
+	if (!aiffStream) {
+		Common::SeekableReadStream *file = g_resourceloader->openNewStreamFile(filename, true);
+		if (!file) {
+			Debug::debug(Debug::Sound, "Stream for %s not open", soundName.c_str());
+			return false;
+		}
+		aiffStream = Audio::makeAIFFStream(file, DisposeAfterUse::YES);
+		if (cached)
+			aiffStream = PCMCacheMan.add(filename, aiffStream);
 	}
 	_soundName = soundName;
-	Audio::RewindableAudioStream *aiffStream = Audio::makeAIFFStream(file, DisposeAfterUse::YES);
 	Audio::SeekableAudioStream *seekStream = dynamic_cast<Audio::SeekableAudioStream *>(aiffStream);
 	_stream = aiffStream;
-	if (start)
-		seekStream->seek(*start);
 	if (!_stream)
 		return false;
+	if (start)
+		seekStream->seek(*start);
 	_handle = new Audio::SoundHandle();
 	return true;
 }
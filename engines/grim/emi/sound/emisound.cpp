@@ -46,6 +46,15 @@ namespace Grim {
 
 EMISound *g_emiSound = nullptr;
 
+// How much of a prefetched track is decoded ahead of time.
+static const uint32 kPrefetchPrimeMs = 300;
+// How much of it is decoded per prefetcher tick, about two MP3 frames.
+static const uint32 kPrefetchStepMs = 50;
+// How many prefetched but not yet started tracks are kept around, primed or not.
+static const uint kMaxPrefetchedTracks = 8;
+// How often the prefetcher checks its queue, in microseconds.
+static const int32 kPrefetchInterval = 10000;
+
 extern uint16 imuseDestTable[];
 
 MusicEntry emiPS2MusicTable[] = {
@@ -182,6 +191,11 @@ void EMISound::timerHandler(void *refCon) {
 	emiSound->callback();
 }
 
+void EMISound::prefetchHandler(void *refCon) {
+	EMISound *emiSound = (EMISound *)refCon;
+	emiSound->processPrefetchQueue();
+}
+
 EMISound::EMISound(int fps) {
 	_curMusicState = -1;
 	_numMusicStates = 0;
@@ -191,10 +205,13 @@ EMISound::EMISound(int fps) {
 	vimaInit(imuseDestTable);
 	initMusicTable();
 	g_system->getTimerManager()->installTimerProc(timerHandler, 1000000 / _callbackFps, this, "emiSoundCallback");
+	g_system->getTimerManager()->installTimerProc(prefetchHandler, kPrefetchInterval, this, "emiSoundPrefetch");
 }
 
 EMISound::~EMISound() {
+	g_system->getTimerManager()->removeTimerProc(prefetchHandler);
 	g_system->getTimerManager()->removeTimerProc(timerHandler);
+	freePrefetchedTracks();
 	freePlayingSounds();
 	freeLoadedSounds();
 	delete _musicTrack;
@@ -432,7 +449,150 @@ int EMISound::getLoadedSoundVolume(int id) {
 	return false;
 }
 
-SoundTrack *EMISound::initTrack(const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start) const {
+void EMISound::freePrefetchedTracks() {
+	Common::StackLock lock(_prefetchMutex);
+	for (PrefetchList::iterator it = _prefetchedTracks.begin(); it != _prefetchedTracks.end(); ++it) {
+		delete it->_track;
+	}
+	for (PrefetchList::iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+		delete it->_track;
+	}
+	_prefetchedTracks.clear();
+	_prefetchQueue.clear();
+}
+
+void EMISound::prefetchSound(const Common::String &soundName, Audio::Mixer::SoundType soundType) {
+	Common::String filename = getTrackFilename(soundName, soundType);
+
+	{
+		Common::StackLock lock(_prefetchMutex);
+		for (PrefetchList::iterator it = _prefetchedTracks.begin(); it != _prefetchedTracks.end(); ++it) {
+			if (it->_filename == filename && it->_soundType == soundType)
+				return;
+		}
+		for (PrefetchList::iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+			if (it->_filename == filename && it->_soundType == soundType)
+				return;
+		}
+	}
+
+	// Only the engine thread adds entries, so nobody can queue the same track meanwhile.
+	PrefetchEntry entry;
+	entry._filename = filename;
+	entry._soundName = soundName;
+	entry._soundType = soundType;
+	entry._track = createTrack(filename, soundName, soundType);
+	if (!entry._track)
+		return;
+
+	SoundTrack *evicted = nullptr;
+	{
+		Common::StackLock lock(_prefetchMutex);
+		if (_prefetchedTracks.size() + _prefetchQueue.size() >= kMaxPrefetchedTracks) {
+			if (!_prefetchedTracks.empty()) {
+				evicted = _prefetchedTracks.front()._track;
+				_prefetchedTracks.pop_front();
+			} else {
+				evicted = _prefetchQueue.back()._track;
+				_prefetchQueue.pop_back();
+			}
+		}
+
+		// Music switches are the most noticeable, so they go first.
+		if (soundType == Audio::Mixer::kMusicSoundType) {
+			_prefetchQueue.push_front(entry);
+		} else {
+			_prefetchQueue.push_back(entry);
+		}
+	}
+	delete evicted;
+}
+
+void EMISound::prefetchMusicState(int stateId) {
+	Common::String filename;
+	{
+		Common::StackLock lock(_mutex);
+		if (_musicTable == nullptr || stateId <= 0 || stateId >= _numMusicStates || stateId == _curMusicState)
+			return;
+		if (_musicTable[stateId]._id != stateId)
+			return;
+
+		const MusicEntry &entry = _musicTable[stateId];
+		if (_musicTrack && _musicTrack->isPlaying()) {
+			// setMusicState either keeps the current track or restarts the new one at
+			// the current position in these cases, neither can use a prefetched track.
+			if (entry._sync == _musicTrack->getSync() && (entry._sync != 0 || entry._filename == _musicTrack->getSoundName()))
+				return;
+		}
+		filename = entry._filename;
+	}
+
+	// Opening the file must not hold up the sound callback, which needs _mutex.
+	prefetchSound(filename, Audio::Mixer::kMusicSoundType);
+}
+
+void EMISound::processPrefetchQueue() {
+	// Each tick only decodes a little of the track, so that the other timer
+	// procs are not held up, and the engine thread can take the track at any
+	// time without waiting for more than one step.
+	Common::StackLock lock(_prefetchMutex);
+	if (_prefetchQueue.empty())
+		return;
+
+	PrefetchEntry &entry = _prefetchQueue.front();
+	if (!entry._track->prime(kPrefetchPrimeMs, kPrefetchStepMs)) {
+		Debug::debug(Debug::Sound, "Primed sound: %s", entry._filename.c_str());
+		_prefetchedTracks.push_back(entry);
+		_prefetchQueue.pop_front();
+	}
+}
+
+SoundTrack *EMISound::takePrefetchedTrack(const Common::String &filename, Audio::Mixer::SoundType soundType) {
+	Common::StackLock lock(_prefetchMutex);
+	for (PrefetchList::iterator it = _prefetchedTracks.begin(); it != _prefetchedTracks.end(); ++it) {
+		if (it->_filename == filename && it->_soundType == soundType) {
+			SoundTrack *track = it->_track;
+			_prefetchedTracks.erase(it);
+			return track;
+		}
+	}
+
+	// A track which is not fully primed yet is still open, which is the slow part,
+	// and plays whatever has been primed so far.
+	for (PrefetchList::iterator it = _prefetchQueue.begin(); it != _prefetchQueue.end(); ++it) {
+		if (it->_filename == filename && it->_soundType == soundType) {
+			SoundTrack *track = it->_track;
+			_prefetchQueue.erase(it);
+			return track;
+		}
+	}
+	return nullptr;
+}
+
+Common::String EMISound::getTrackFilename(const Common::String &soundName, Audio::Mixer::SoundType soundType) const {
+	if (soundType == Audio::Mixer::kMusicSoundType) {
+		return _musicPrefix + soundName;
+	} else {
+		return soundName;
+	}
+}
+
+SoundTrack *EMISound::initTrack(const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start) {
+	Common::String filename = getTrackFilename(soundName, soundType);
+
+	// A prefetched track always starts at the beginning.
+	if (!start) {
+		SoundTrack *track = takePrefetchedTrack(filename, soundType);
+		if (track) {
+			Debug::debug(Debug::Sound, "Using prefetched sound: %s", filename.c_str());
+			return track;
+		}
+	}
+
+	return createTrack(filename, soundName, soundType, start);
+}
+
+SoundTrack *EMISound::createTrack(const Common::String &filename, const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start) {
 	SoundTrack *track;
 	Common::String soundNameLower(soundName);
 	soundNameLower.toLowercase();
@@ -446,16 +606,10 @@ SoundTrack *EMISound::initTrack(const Common::String &soundName, Audio::Mixer::S
 		track = new VimaTrack();
 	}
 
-	Common::String filename;
-	if (soundType == Audio::Mixer::kMusicSoundType) {
-		filename = _musicPrefix + soundName;
-	} else {
-		filename = soundName;
-	}
-
 	if (track->openSound(filename, soundName, start)) {
 		return track;
 	}
+	delete track;
 	return nullptr;
 }
 
@@ -715,6 +869,7 @@ void EMISound::selectMusicSet(int setId) {
 	} else {
 		error("EMISound::selectMusicSet - Unknown setId %d", setId);
 	}
+	freePrefetchedTracks();
 
 	// Immediately switch all currently active music tracks to the new quality.
 	for (TrackList::iterator it = _playingTracks.begin(); it != _playingTracks.end(); ++it) {
@@ -882,6 +1037,7 @@ void EMISound::flushTracks() {
 void EMISound::restoreState(SaveGame *savedState) {
 	Common::StackLock lock(_mutex);
 	// Clear any current music
+	freePrefetchedTracks();
 	flushStack();
 	setMusicState(0);
 	freePlayingSounds();
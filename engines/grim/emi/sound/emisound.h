@@ -28,6 +28,7 @@
 #include "common/stack.h"
 #include "common/mutex.h"
 #include "common/hashmap.h"
+#include "common/list.h"
 #include "math/vector3d.h"
 
 namespace Grim {
@@ -78,6 +79,14 @@ public:
 	void setMusicState(int stateId);
 	void selectMusicSet(int setId);
 
+	/**
+	 * Open a track and queue it to be primed by the background prefetcher, so
+	 * that a later start of the same sound does not stall the engine thread.
+	 * The file is opened right away, as the resource loader is not thread-safe.
+	 */
+	void prefetchSound(const Common::String &soundName, Audio::Mixer::SoundType soundType);
+	void prefetchMusicState(int stateId);
+
 	bool stateHasLooped(int stateId);
 	bool stateHasEnded(int stateId);
 
@@ -113,12 +122,32 @@ private:
 	typedef Common::HashMap<int, SoundTrack *> TrackMap;
 	TrackMap _preloadedTrackMap;
 
+	struct PrefetchEntry {
+		Common::String _filename;
+		Common::String _soundName;
+		Audio::Mixer::SoundType _soundType;
+		SoundTrack *_track;
+	};
+
+	typedef Common::List<PrefetchEntry> PrefetchList;
+	// Tracks opened by the engine thread, being primed by the timer callback.
+	PrefetchList _prefetchQueue;
+	PrefetchList _prefetchedTracks;
+	// Guards the prefetch lists, which are shared with the prefetch timer callback.
+	// Never take _mutex while holding it.
+	Common::Mutex _prefetchMutex;
+
 	int _curMusicState;
 	int _numMusicStates;
 	int _callbackFps;
 	int _curTrackId;
 
 	static void timerHandler(void *refConf);
+	static void prefetchHandler(void *refCon);
+	void processPrefetchQueue();
+	void freePrefetchedTracks();
+	SoundTrack *takePrefetchedTrack(const Common::String &filename, Audio::Mixer::SoundType soundType);
+	Common::String getTrackFilename(const Common::String &soundName, Audio::Mixer::SoundType soundType) const;
 	void removeItem(SoundTrack *item);
 	TrackList::iterator getPlayingTrackByName(const Common::String &name);
 	void freeChannel(int32 channel);
@@ -128,7 +157,8 @@ private:
 	void updateTrack(SoundTrack *track);
 	void freePlayingSounds();
 	void freeLoadedSounds();
-	SoundTrack *initTrack(const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start = nullptr) const;
+	SoundTrack *initTrack(const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start = nullptr);
+	static SoundTrack *createTrack(const Common::String &filename, const Common::String &soundName, Audio::Mixer::SoundType soundType, const Audio::Timestamp *start = nullptr);
 	SoundTrack *restartTrack(SoundTrack *track);
 	bool startSound(const Common::String &soundName, Audio::Mixer::SoundType soundType, int volume, int pan);
 	bool startSoundFrom(const Common::String &soundName, Audio::Mixer::SoundType soundType, const Math::Vector3d &pos, int volume);
@@ -100,6 +100,76 @@ private:
 	bool _hasLooped;
 };
 
+/**
+ * Keeps the beginning of a stream decoded in memory, so that the mixer can
+ * start playing it without having to wait for the decoder first. The buffer
+ * is filled a little at a time, and must not be filled any more once the
+ * stream is being played.
+ */
+class PrimedAudioStream : public Audio::AudioStream {
+public:
+	PrimedAudioStream(Audio::AudioStream *stream, uint32 msecs)
+		: _parent(stream, DisposeAfterUse::YES), _buffer(nullptr), _bufferCapacity(0), _bufferSize(0), _bufferPos(0) {
+		_bufferCapacity = MAX<int>(msecsToSamples(msecs), 0);
+		if (_bufferCapacity > 0)
+			_buffer = new int16[_bufferCapacity];
+	}
+
+	~PrimedAudioStream() {
+		delete[] _buffer;
+	}
+
+	/**
+	 * Decode up to msecs more of the stream into the buffer.
+	 * @return true if the buffer is not full yet
+	 */
+	bool fill(uint32 msecs) {
+		int numSamples = MIN(msecsToSamples(msecs), _bufferCapacity - _bufferSize);
+		if (numSamples <= 0)
+			return false;
+
+		int samples = _parent->readBuffer(_buffer + _bufferSize, numSamples);
+		if (samples < numSamples)
+			_bufferCapacity = _bufferSize + MAX(samples, 0);
+		_bufferSize += MAX(samples, 0);
+		return _bufferSize < _bufferCapacity;
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) override {
+		int samples = MIN(numSamples, _bufferSize - _bufferPos);
+		if (samples > 0) {
+			memcpy(buffer, _buffer + _bufferPos, samples * sizeof(int16));
+			_bufferPos += samples;
+		} else {
+			samples = 0;
+		}
+
+		if (samples < numSamples)
+			samples += _parent->readBuffer(buffer + samples, numSamples - samples);
+		return samples;
+	}
+
+	bool endOfData() const override { return _bufferPos >= _bufferSize && _parent->endOfData(); }
+	bool endOfStream() const override { return _bufferPos >= _bufferSize && _parent->endOfStream(); }
+	bool isStereo() const override { return _parent->isStereo(); }
+	int getRate() const override { return _parent->getRate(); }
+
+	/** Number of primed frames which have not been handed to the mixer yet */
+	int getPendingFrames() const { return (_bufferSize - _bufferPos) / (isStereo() ? 2 : 1); }
+
+private:
+	int msecsToSamples(uint32 msecs) const {
+		return (msecs * _parent->getRate() / 1000) * (_parent->isStereo() ? 2 : 1);
+	}
+
+	Common::DisposablePtr<Audio::AudioStream> _parent;
+
+	int16 *_buffer;
+	int _bufferCapacity;
+	int _bufferSize;
+	int _bufferPos;
+};
+
 void MP3Track::parseRIFFHeader(Common::SeekableReadStream *data) {
 	uint32 tag = data->readUint32BE();
 	if (tag == MKTAG('R','I','F','F')) {
@@ -148,6 +218,8 @@ MP3Track::MP3Track(Audio::Mixer::SoundType soundType) {
 	_channels = 0;
 	_endFlag = false;
 	_looping = false;
+	_loopStream = nullptr;
+	_primedStream = nullptr;
 }
 
 MP3Track::~MP3Track() {
@@ -186,7 +258,8 @@ bool MP3Track::openSound(const Common::String &filename, const Common::String &s
 		mp3Stream->seek(cuePoints._start);
 		_looping = false;
 	} else {
-		_stream = new EMISubLoopingAudioStream(mp3Stream, 0, cuePoints._start, cuePoints._loopStart, cuePoints._loopEnd);
+		_loopStream = new EMISubLoopingAudioStream(mp3Stream, 0, cuePoints._start, cuePoints._loopStart, cuePoints._loopEnd);
+		_stream = _loopStream;
 		_looping = true;
 	}
 	_handle = new Audio::SoundHandle();
@@ -194,11 +267,20 @@ bool MP3Track::openSound(const Common::String &filename, const Common::String &s
 #endif
 }
 
+bool MP3Track::prime(uint32 msecs, uint32 stepMsecs) {
+	if (!_stream || isPlaying())
+		return false;
+	if (!_primedStream) {
+		_primedStream = new PrimedAudioStream(_stream, msecs);
+		_stream = _primedStream;
+	}
+	return _primedStream->fill(stepMsecs);
+}
+
 bool MP3Track::hasLooped() {
 	if (!_stream || !_looping)
 		return false;
-	EMISubLoopingAudioStream *las = static_cast<EMISubLoopingAudioStream*>(_stream);
-	return las->hasLooped();
+	return _loopStream->hasLooped();
 }
 
 bool MP3Track::isPlaying() {
@@ -212,8 +294,11 @@ Audio::Timestamp MP3Track::getPos() {
 	if (!_stream)
 		return Audio::Timestamp(0);
 	if (_looping) {
-		EMISubLoopingAudioStream *slas = static_cast<EMISubLoopingAudioStream*>(_stream);
-		return slas->getPos();
+		Audio::Timestamp pos = _loopStream->getPos();
+		// The loop stream runs ahead by whatever is still waiting in the primed buffer.
+		if (_primedStream)
+			pos = pos.addFrames(-_primedStream->getPendingFrames());
+		return pos;
 	} else {
 		return g_system->getMixer()->getSoundElapsedTime(*_handle);
 	}
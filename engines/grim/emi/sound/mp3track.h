@@ -35,6 +35,9 @@ namespace Audio {
 
 namespace Grim {
 
+class EMISubLoopingAudioStream;
+class PrimedAudioStream;
+
 class MP3Track : public SoundTrack {
 	struct JMMCuePoints {
 		Audio::Timestamp _start;
@@ -48,12 +51,15 @@ class MP3Track : public SoundTrack {
 	char _channels;
 	bool _endFlag;
 	bool _looping;
+	EMISubLoopingAudioStream *_loopStream;
+	PrimedAudioStream *_primedStream;
 	void parseRIFFHeader(Common::SeekableReadStream *data);
 	JMMCuePoints parseJMMFile(const Common::String &filename);
 public:
 	MP3Track(Audio::Mixer::SoundType soundType);
 	~MP3Track();
 	bool openSound(const Common::String &filename, const Common::String &soundName, const Audio::Timestamp *start = nullptr) override;
+	bool prime(uint32 msecs, uint32 stepMsecs) override;
 	bool hasLooped() override;
 	bool isPlaying() override;
 	Audio::Timestamp getPos() override;
@@ -41,6 +41,7 @@ SoundTrack::SoundTrack() {
 	_balance = 0;
 	_volume = Audio::Mixer::kMaxChannelVolume;
 	_disposeAfterPlaying = DisposeAfterUse::YES;
+	_streamGivenToMixer = false;
 	_sync = 0;
 	_fadeMode = FadeNone;
 	_fade = 1.0f;
@@ -51,7 +52,8 @@ SoundTrack::SoundTrack() {
 }
 
 SoundTrack::~SoundTrack() {
-	if (_stream && (_disposeAfterPlaying == DisposeAfterUse::NO || !_handle))
+	// Tracks which were opened (or prefetched) but never played still own their stream.
+	if (_stream && (_disposeAfterPlaying == DisposeAfterUse::NO || !_handle || !_streamGivenToMixer))
 		delete _stream;
 }
 
@@ -121,6 +123,7 @@ bool SoundTrack::play() {
 		}
 		// If _disposeAfterPlaying is NO, the destructor will take care of the stream.
 		g_system->getMixer()->playStream(_soundType, _handle, _stream, -1, (byte)getEffectiveVolume(), _balance, _disposeAfterPlaying);
+		_streamGivenToMixer = true;
 		return true;
 	}
 	return false;
@@ -56,6 +56,7 @@ protected:
 	Audio::SoundHandle *_handle;
 	Audio::Mixer::SoundType _soundType;
 	DisposeAfterUse::Flag _disposeAfterPlaying;
+	bool _streamGivenToMixer;
 	bool _paused;
 	bool _positioned;
 	Math::Vector3d _pos;
@@ -70,6 +71,16 @@ public:
 	virtual ~SoundTrack();
 	virtual bool openSound(const Common::String &filename, const Common::String &voiceName, const Audio::Timestamp *start = nullptr) = 0;
 	virtual bool isPlaying() = 0;
+	/**
+	 * Decode the first few milliseconds of the track ahead of time, so that
+	 * play() can start without waiting for the decoder. Each call decodes at
+	 * most stepMsecs more, it must be called again until it returns false.
+	 * Must only be called before the track is played for the first time.
+	 * @param msecs     how much of the track to decode in total
+	 * @param stepMsecs how much of the track to decode in this call
+	 * @return true if there is more of the track to prime
+	 */
+	virtual bool prime(uint32 msecs, uint32 stepMsecs) { return false; }
 	virtual bool play();
 	virtual void pause();
 	virtual void stop();
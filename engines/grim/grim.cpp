@@ -25,6 +25,8 @@
 #define FORBIDDEN_SYMBOL_EXCEPTION_stderr
 #define FORBIDDEN_SYMBOL_EXCEPTION_stdin
 
+#include "audio/pcmcache.h"
+
 #include "common/archive.h"
 #include "common/debug-channels.h"
 #include "common/file.h"
@@ -201,6 +203,8 @@ GrimEngine::~GrimEngine() {
 	g_emiSound = nullptr;
 	delete g_sound;
 	g_sound = nullptr;
+	// The cached sound clips are of no use to the next game
+	PCMCacheMan.clear();
 	delete g_localizer;
 	g_localizer = nullptr;
 	delete g_resourceloader;
@@ -819,6 +823,13 @@ void GrimEngine::mainLoop() {
 			g_imuse->refreshScripts();
 		}
 
+		// Apply the music state the scripts set on the last frame. Doing it a
+		// frame late leaves the EMI prefetcher time to prime the new track.
+		if (g_imuseState != -1) {
+			g_sound->setMusicState(g_imuseState);
+			g_imuseState = -1;
+		}
+
 		_debugger->onFrame();
 
 		// Process events
@@ -898,11 +909,6 @@ void GrimEngine::mainLoop() {
 			luaUpdate();
 		}
 
-		if (g_imuseState != -1) {
-			g_sound->setMusicState(g_imuseState);
-			g_imuseState = -1;
-		}
-
 		uint32 endTime = g_system->getMillis();
 		if (startTime > endTime)
 			continue;
@@ -23,12 +23,76 @@
 #include "common/file.h"
 #include "common/substream.h"
 #include "common/memstream.h"
+#include "common/mutex.h"
 
 #include "engines/grim/grim.h"
 #include "engines/grim/lab.h"
 
 namespace Grim {
 
+/**
+ * The file handle of a LAB, opened once and shared by the streams of its
+ * members. The members may be read from several threads, the mutex keeps
+ * each seek together with the read following it.
+ */
+class LabFile {
+public:
+	LabFile(Common::SeekableReadStream *stream) : _stream(stream) {}
+	~LabFile() { delete _stream; }
+
+	Common::SeekableReadStream *getStream() { return _stream; }
+	Common::Mutex &getMutex() { return _mutex; }
+
+private:
+	Common::SeekableReadStream *_stream;
+	Common::Mutex _mutex;
+};
+
+/**
+ * Release a reference to a LAB file, under its mutex as the members copy and
+ * release theirs from other threads. The last reference is released without
+ * it, as the mutex goes away with the file.
+ */
+static void releaseLabFile(Common::SharedPtr<LabFile> &file) {
+	if (!file)
+		return;
+
+	{
+		Common::StackLock lock(file->getMutex());
+		if (!file.unique()) {
+			file.reset();
+			return;
+		}
+	}
+	file.reset();
+}
+
+/** A member of a LAB, read at its own position from the shared file handle */
+class LabMemberStream : public Common::SafeSeekableSubReadStream {
+public:
+	LabMemberStream(const Common::SharedPtr<LabFile> &file, uint32 begin, uint32 end) :
+			SafeSeekableSubReadStream(file->getStream(), begin, end, DisposeAfterUse::NO),
+			_file(file) {
+	}
+
+	~LabMemberStream() {
+		releaseLabFile(_file);
+	}
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		Common::StackLock lock(_file->getMutex());
+		return SafeSeekableSubReadStream::read(dataPtr, dataSize);
+	}
+
+	bool seek(int32 offset, int whence = SEEK_SET) {
+		Common::StackLock lock(_file->getMutex());
+		return SafeSeekableSubReadStream::seek(offset, whence);
+	}
+
+private:
+	Common::SharedPtr<LabFile> _file;
+};
+
 LabEntry::LabEntry(const Common::String &name, uint32 offset, uint32 len, Lab *parent) :
 		_offset(offset), _len(len), _parent(parent), _name(name) {
 	_name.toLowercase();
@@ -39,11 +103,12 @@ Common::SeekableReadStream *LabEntry::createReadStream() const {
 }
 
 Lab::Lab() {
-	_stream = nullptr;
 }
 
 Lab::~Lab() {
-	delete _stream;
+	// The sounds being played may still have views of the mapping
+	Common::MemoryReadStreamView::releaseParent(_mapping);
+	releaseLabFile(_file);
 }
 
 bool Lab::open(const Common::String &filename, bool keepStream) {
@@ -62,13 +127,22 @@ bool Lab::open(const Common::String &filename, bool keepStream) {
 		else
 			parseMonkey4FileTable(file);
 	}
-	if (result && keepStream) {
+	if (result) {
+		// When the file can be mapped into memory, the members are read in place
+		_mapping = Common::SharedPtr<Common::MemoryReadStream>(SearchMan.createMappedReadStreamForMember(filename));
+	}
+	if (result && keepStream && !_mapping) {
 		file->seek(0, SEEK_SET);
 		byte *data = static_cast<byte*>(malloc(sizeof(byte) * file->size()));
 		file->read(data, file->size());
-		_stream = new Common::MemoryReadStream(data, file->size(), DisposeAfterUse::YES);
+		_mapping = Common::SharedPtr<Common::MemoryReadStream>(new Common::MemoryReadStream(data, file->size(), DisposeAfterUse::YES));
+	}
+	if (result && !_mapping) {
+		// Keep the file open for the members, instead of opening it again for each one
+		_file = Common::SharedPtr<LabFile>(new LabFile(file));
+	} else {
+		delete file;
 	}
-	delete file;
 
 	return result;
 }
@@ -180,16 +254,23 @@ Common::SeekableReadStream *Lab::createReadStreamForMember(const Common::String
 	fname.toLowercase();
 	LabEntryPtr i = _entries[fname];
 
-	if (!_stream) {
-		Common::File *file = new Common::File();
-		file->open(_labFileName);
-		return new Common::SeekableSubReadStream(file, i->_offset, i->_offset + i->_len, DisposeAfterUse::YES);
-	} else {
-		byte *data = static_cast<byte*>(malloc(sizeof(byte) * i->_len));
-		_stream->seek(i->_offset, SEEK_SET);
-		_stream->read(data, i->_len);
-		return new Common::MemoryReadStream(data, i->_len, DisposeAfterUse::YES);
+	if (_mapping && i->_offset + i->_len <= (uint32)_mapping->size()) {
+		return new Common::MemoryReadStreamView(_mapping, i->_offset, i->_len);
+	}
+
+	if (_file) {
+		// Creating the stream moves the file position
+		Common::StackLock lock(_file->getMutex());
+		return new LabMemberStream(_file, i->_offset, i->_offset + i->_len);
+	}
+
+	// The member doesn't fit in the mapping, the file may have changed since it was opened
+	Common::File *file = new Common::File();
+	if (!file->open(_labFileName)) {
+		delete file;
+		return nullptr;
 	}
+	return new Common::SeekableSubReadStream(file, i->_offset, i->_offset + i->_len, DisposeAfterUse::YES);
 }
 
 } // end of namespace Grim
@@ -27,11 +27,13 @@
 
 namespace Common {
 	class File;
+	class MemoryReadStream;
 }
 
 namespace Grim {
 
 class Lab;
+class LabFile;
 
 class LabEntry : public Common::ArchiveMember {
 	Lab *_parent;
@@ -63,7 +65,10 @@ private:
 	typedef Common::SharedPtr<LabEntry> LabEntryPtr;
 	typedef Common::HashMap<Common::String, LabEntryPtr, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> LabMap;
 	LabMap _entries;
-	Common::SeekableReadStream *_stream;
+	/** The whole LAB, mapped or read into memory. The members are views into it. */
+	Common::SharedPtr<Common::MemoryReadStream> _mapping;
+	/** Otherwise, the file handle shared by the streams of the members */
+	Common::SharedPtr<LabFile> _file;
 };
 
 } // end of namespace Grim
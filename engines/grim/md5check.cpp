@@ -20,8 +20,15 @@
  *
  */
 
+#include "common/archive.h"
+#include "common/config-manager.h"
 #include "common/file.h"
+#include "common/hashmap.h"
 #include "common/md5.h"
+#include "common/mutex.h"
+#include "common/savefile.h"
+#include "common/system.h"
+#include "common/timer.h"
 #include "common/translation.h"
 
 #include "gui/error.h"
@@ -372,6 +379,21 @@ const char *emi_installer[] = {
 bool MD5Check::_initted = false;
 Common::Array<MD5Check::MD5Sum> *MD5Check::_files = nullptr;
 int MD5Check::_iterator = -1;
+Common::Mutex *MD5Check::_mutex = nullptr;
+
+// How often the timer proc hashes a chunk of the next file, in microseconds
+static const int32 kHashInterval = 10000;
+// How much of a file is hashed at a time, in bytes
+static const uint32 kHashChunkSize = 256 * 1024;
+
+struct CachedSum {
+	uint32 size;
+	uint32 modificationTime;
+	Common::String md5;
+};
+
+// The sums, by the path of the files
+typedef Common::HashMap<Common::String, CachedSum> CachedSumMap;
 
 void MD5Check::init() {
 	if (_initted) {
@@ -379,6 +401,7 @@ void MD5Check::init() {
 	}
 	_initted = true;
 	_files = new Common::Array<MD5Sum>();
+	_mutex = new Common::Mutex();
 
 	#define MD5SUM(filename, sums) _files->push_back(MD5Sum(filename, sums, sizeof(sums) / sizeof(const char *)));
 
@@ -494,9 +517,14 @@ void MD5Check::init() {
 }
 
 void MD5Check::clear() {
+	stopHashing();
+
 	delete _files;
 	_files = nullptr;
+	delete _mutex;
+	_mutex = nullptr;
 	_initted = false;
+	_iterator = -1;
 }
 
 bool MD5Check::checkMD5(const MD5Sum &sums, const char *md5) {
@@ -520,7 +548,11 @@ bool MD5Check::checkFiles() {
 
 void MD5Check::startCheckFiles() {
 	init();
+	stopHashing();
+	loadCache();
 	_iterator = 0;
+
+	g_system->getTimerManager()->installTimerProc(hashHandler, kHashInterval, nullptr, "grimMD5Check");
 }
 
 bool MD5Check::advanceCheck(int *pos, int *total) {
@@ -528,7 +560,8 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 		return false;
 	}
 
-	const MD5Sum &sum = (*_files)[_iterator++];
+	int index = _iterator++;
+	const MD5Sum &sum = (*_files)[index];
 	if (pos) {
 		*pos = _iterator;
 	}
@@ -539,14 +572,32 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 		_iterator = -1;
 	}
 
-	Common::File file;
-	if (file.open(sum.filename)) {
-		Common::String md5 = Common::computeStreamMD5AsString(file);
-		if (!checkMD5(sum, md5.c_str())) {
-			warning(_("'%s' may be corrupted. MD5: '%s'"), sum.filename, md5.c_str());
+	// Hash the file, unless the timer proc already has. While it is
+	// working on this file, help it with the next ones.
+	while (true) {
+		{
+			Common::StackLock lock(*_mutex);
+			if (sum.state == kHashDone) {
+				break;
+			}
+		}
+
+		if (!hashNextChunk(index)) {
+			g_system->delayMillis(1);
+		}
+	}
+
+	if (_iterator == -1) {
+		stopHashing();
+		saveCache();
+	}
+
+	if (!sum.md5.empty()) {
+		if (!checkMD5(sum, sum.md5.c_str())) {
+			warning(_("'%s' may be corrupted. MD5: '%s'"), sum.filename, sum.md5.c_str());
 			GUI::displayErrorDialog(Common::String::format(_("The game data file %s may be corrupted.\nIf you are sure it is "
 									"not please provide the ResidualVM team the following code, along with the file name, the language and a "
-									"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, md5.c_str()).c_str());
+									"description of your game version (i.e. dvd-box or jewelcase):\n%s"), sum.filename, sum.md5.c_str()).c_str());
 			return false;
 		}
 	} else {
@@ -560,4 +611,158 @@ bool MD5Check::advanceCheck(int *pos, int *total) {
 	return true;
 }
 
+void MD5Check::hashHandler(void *refCon) {
+	hashNextChunk(-1);
+}
+
+bool MD5Check::hashNextChunk(int index) {
+	MD5Sum *sum = nullptr;
+	{
+		Common::StackLock lock(*_mutex);
+
+		// Take the given file, or the first queued one
+		if (index >= 0 && (*_files)[index].state == kHashQueued) {
+			sum = &(*_files)[index];
+		}
+		for (uint i = 0; !sum && i < _files->size(); i++) {
+			if ((*_files)[i].state == kHashQueued) {
+				sum = &(*_files)[i];
+			}
+		}
+
+		if (!sum) {
+			return false;
+		}
+		sum->state = kHashRunning;
+	}
+
+	// The stream and the context are only used by whoever set the running state
+	byte buffer[16 * 1024];
+	uint32 chunkRead = 0;
+	bool finished = false;
+	while (chunkRead < kHashChunkSize) {
+		uint32 read = sum->stream->read(buffer, sizeof(buffer));
+		sum->context.update(buffer, read);
+		chunkRead += read;
+		if (read < sizeof(buffer)) {
+			finished = true;
+			break;
+		}
+	}
+	sum->hashed += chunkRead;
+
+	Common::StackLock lock(*_mutex);
+	if (finished || sum->hashed >= sum->size) {
+		delete sum->stream;
+		sum->stream = nullptr;
+		sum->md5 = sum->context.finishAsString();
+		sum->state = kHashDone;
+	} else {
+		sum->state = kHashQueued;
+	}
+
+	return true;
+}
+
+void MD5Check::stopHashing() {
+	// Waits for the chunk being hashed by the timer proc, if any
+	g_system->getTimerManager()->removeTimerProc(hashHandler);
+
+	if (!_files) {
+		return;
+	}
+
+	for (uint i = 0; i < _files->size(); i++) {
+		MD5Sum &sum = (*_files)[i];
+		delete sum.stream;
+		sum.stream = nullptr;
+		if (sum.state != kHashDone) {
+			sum.state = kHashDone;
+			sum.md5.clear();
+		}
+	}
+}
+
+Common::String MD5Check::getCacheFilename() {
+	return ConfMan.getActiveDomainName() + ".md5";
+}
+
+void MD5Check::loadCache() {
+	CachedSumMap cachedSums;
+
+	Common::InSaveFile *cacheFile = g_system->getSavefileManager()->openForLoading(getCacheFilename());
+	if (cacheFile) {
+		// Each line holds the MD5 sum, the size and the modification time of a file, then its path
+		while (!cacheFile->eos() && !cacheFile->err()) {
+			Common::String line = cacheFile->readLine();
+
+			char md5[33];
+			CachedSum cachedSum;
+			int namePos = 0;
+			if (sscanf(line.c_str(), "%32s %u %u %n", md5, &cachedSum.size, &cachedSum.modificationTime, &namePos) < 3 || namePos == 0) {
+				continue;
+			}
+
+			cachedSum.md5 = md5;
+			cachedSums[line.c_str() + namePos] = cachedSum;
+		}
+		delete cacheFile;
+	}
+
+	for (uint i = 0; i < _files->size(); i++) {
+		MD5Sum &sum = (*_files)[i];
+		sum.md5.clear();
+		sum.path.clear();
+		sum.size = 0;
+		sum.modificationTime = 0;
+		sum.context = Common::MD5Context();
+		sum.hashed = 0;
+
+		// The files which can't be opened are reported when they are reached
+		Common::ArchiveMemberPtr member = SearchMan.getMember(sum.filename);
+		sum.stream = member ? member->createReadStream() : nullptr;
+		if (!sum.stream) {
+			sum.state = kHashDone;
+			continue;
+		}
+
+		sum.path = member->getPath();
+		sum.size = sum.stream->size();
+		sum.modificationTime = member->getModificationTime();
+
+		// The same file name may be found in another directory next time.
+		// Files whose path or modification time is not known are always hashed.
+		CachedSumMap::const_iterator it = cachedSums.find(sum.path);
+		if (!sum.path.empty() && sum.modificationTime != 0 && it != cachedSums.end() &&
+				it->_value.size == sum.size && it->_value.modificationTime == sum.modificationTime) {
+			sum.md5 = it->_value.md5;
+			sum.state = kHashDone;
+			delete sum.stream;
+			sum.stream = nullptr;
+		} else {
+			sum.state = kHashQueued;
+		}
+	}
+}
+
+void MD5Check::saveCache() {
+	Common::OutSaveFile *cacheFile = g_system->getSavefileManager()->openForSaving(getCacheFilename(), false);
+	if (!cacheFile) {
+		warning("MD5Check: Could not save the MD5 sums to %s", getCacheFilename().c_str());
+		return;
+	}
+
+	for (uint i = 0; i < _files->size(); i++) {
+		const MD5Sum &sum = (*_files)[i];
+		if (sum.md5.empty() || sum.path.empty() || sum.modificationTime == 0) {
+			continue;
+		}
+
+		cacheFile->writeString(Common::String::format("%s %u %u %s\n", sum.md5.c_str(), sum.size, sum.modificationTime, sum.path.c_str()));
+	}
+
+	cacheFile->finalize();
+	delete cacheFile;
+}
+
 }
@@ -24,9 +24,24 @@
 #define GRIM_MD5CHECK_H
 
 #include "common/array.h"
+#include "common/md5.h"
+#include "common/str.h"
+
+namespace Common {
+class Mutex;
+class SeekableReadStream;
+}
 
 namespace Grim {
 
+/**
+ * Verifies the MD5 sums of the game data files.
+ *
+ * While the files are checked one at a time, a timer proc hashes the next
+ * ones in the background, a bounded chunk per tick. The sums are saved along
+ * with the path, the size and the modification time of the files, and the
+ * files which did not change are not hashed again on the next check.
+ */
 class MD5Check {
 public:
 	static bool checkFiles();
@@ -38,17 +53,44 @@ public:
 private:
 	static void init();
 
+	enum HashState {
+		kHashQueued,
+		kHashRunning,
+		kHashDone
+	};
+
 	struct MD5Sum {
-		MD5Sum(const char *fn, const char **s, int n) : filename(fn), sums(s), numSums(n) {}
+		MD5Sum(const char *fn, const char **s, int n) : filename(fn), sums(s), numSums(n),
+			stream(nullptr), size(0), modificationTime(0), hashed(0), state(kHashDone) {}
 		const char *filename;
 		const char **sums;
 		int numSums;
+
+		/** The file being checked, guarded by the mutex along with the state */
+		Common::SeekableReadStream *stream;
+		Common::String path;
+		uint32 size;
+		uint32 modificationTime;
+		/** The sum of the part of the file hashed so far */
+		Common::MD5Context context;
+		uint32 hashed;
+		HashState state;
+		Common::String md5;
 	};
 	static bool checkMD5(const MD5Sum &sums, const char *md5);
 
+	static void hashHandler(void *refCon);
+	static bool hashNextChunk(int index);
+	static void stopHashing();
+
+	static Common::String getCacheFilename();
+	static void loadCache();
+	static void saveCache();
+
 	static bool _initted;
 	static Common::Array<MD5Sum> *_files;
 	static int _iterator;
+	static Common::Mutex *_mutex;
 };
 
 }
@@ -0,0 +1,96 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * SSE2 helpers for the whole block copies and fills of the SMUSH codecs.
+ *
+ * They move a full row with a single load and store, where the scalar code
+ * goes four bytes at a time. The results only differ when the source of a
+ * copy overlaps the destination row just before it, so the callers keep the
+ * scalar code for these motion vectors.
+ */
+
+#ifndef GRIM_BLOCKS_SSE2_H
+#define GRIM_BLOCKS_SSE2_H
+
+#include "common/scummsys.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+namespace Grim {
+
+/** Copy rows of 8 bytes from src to dst. */
+inline void copyRows8SSE2(byte *dst, int dstPitch, const byte *src, int srcPitch, int rows) {
+	for (int i = 0; i < rows; i++) {
+		_mm_storel_epi64((__m128i *)dst, _mm_loadl_epi64((const __m128i *)src));
+		dst += dstPitch;
+		src += srcPitch;
+	}
+}
+
+/** Copy rows of 16 bytes from src to dst. */
+inline void copyRows16SSE2(byte *dst, int dstPitch, const byte *src, int srcPitch, int rows) {
+	for (int i = 0; i < rows; i++) {
+		_mm_storeu_si128((__m128i *)dst, _mm_loadu_si128((const __m128i *)src));
+		dst += dstPitch;
+		src += srcPitch;
+	}
+}
+
+/** Fill rows of 8 bytes with a repeated 32-bit value. */
+inline void fillRows8SSE2(byte *dst, int pitch, uint32 value, int rows) {
+	const __m128i v = _mm_set1_epi32((int32)value);
+	for (int i = 0; i < rows; i++) {
+		_mm_storel_epi64((__m128i *)dst, v);
+		dst += pitch;
+	}
+}
+
+/** Fill rows of 16 bytes with a repeated 32-bit value. */
+inline void fillRows16SSE2(byte *dst, int pitch, uint32 value, int rows) {
+	const __m128i v = _mm_set1_epi32((int32)value);
+	for (int i = 0; i < rows; i++) {
+		_mm_storeu_si128((__m128i *)dst, v);
+		dst += pitch;
+	}
+}
+
+/** Scale a 4x4 block of 8-bit pixels to an 8x8 block. */
+inline void scaleBlockSSE2(byte *dst, int pitch, const byte *src) {
+	for (int i = 0; i < 4; i++) {
+		const __m128i row = _mm_cvtsi32_si128(*(const int32 *)src);
+		const __m128i scaled = _mm_unpacklo_epi8(row, row);
+		_mm_storel_epi64((__m128i *)dst, scaled);
+		_mm_storel_epi64((__m128i *)(dst + pitch), scaled);
+		src += 4;
+		dst += pitch * 2;
+	}
+}
+
+} // end of namespace Grim
+
+#endif
+
+#endif
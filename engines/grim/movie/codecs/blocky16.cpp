@@ -25,6 +25,7 @@
 #include "common/textconsole.h"
 
 #include "engines/grim/movie/codecs/blocky16.h"
+#include "engines/grim/movie/codecs/blocks_sse2.h"
 
 namespace Grim {
 
@@ -442,6 +443,12 @@ void Blocky16::level2(byte *d_dst) {
 			tmp2 = _table[code] * 2;
 		}
 		tmp2 += _offset1;
+#ifdef __SSE2__
+		if (tmp2 <= -8 || tmp2 >= 0) {
+			copyRows8SSE2(d_dst, _d_pitch, d_dst + tmp2, _d_pitch, 4);
+			return;
+		}
+#endif
 		for (i = 0; i < 4; i++) {
 			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
 			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
@@ -457,6 +464,12 @@ void Blocky16::level2(byte *d_dst) {
 		level3(d_dst);
 	} else if (code == 0xF6) {
 		tmp2 = _offset2;
+#ifdef __SSE2__
+		if (tmp2 <= -8 || tmp2 >= 0) {
+			copyRows8SSE2(d_dst, _d_pitch, d_dst + tmp2, _d_pitch, 4);
+			return;
+		}
+#endif
 		for (i = 0; i < 4; i++) {
 			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
 			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
@@ -500,11 +513,15 @@ void Blocky16::level2(byte *d_dst) {
 			t = READ_LE_UINT16(_paramPtr + code * 2);
 			t = (t << 16) | t;
 		}
+#ifdef __SSE2__
+		fillRows8SSE2(d_dst, _d_pitch, t, 4);
+#else
 		for (i = 0; i < 4; i++) {
 			WRITE_4X1_LINE(d_dst + 0, t);
 			WRITE_4X1_LINE(d_dst + 4, t);
 			d_dst += _d_pitch;
 		}
+#endif
 	}
 }
 
@@ -523,6 +540,12 @@ void Blocky16::level1(byte *d_dst) {
 			tmp2 = _table[code] * 2;
 		}
 		tmp2 += _offset1;
+#ifdef __SSE2__
+		if (tmp2 <= -16 || tmp2 >= 0) {
+			copyRows16SSE2(d_dst, _d_pitch, d_dst + tmp2, _d_pitch, 8);
+			return;
+		}
+#endif
 		for (i = 0; i < 8; i++) {
 			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
 			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
@@ -540,6 +563,12 @@ void Blocky16::level1(byte *d_dst) {
 		level2(d_dst);
 	} else if (code == 0xF6) {
 		tmp2 = _offset2;
+#ifdef __SSE2__
+		if (tmp2 <= -16 || tmp2 >= 0) {
+			copyRows16SSE2(d_dst, _d_pitch, d_dst + tmp2, _d_pitch, 8);
+			return;
+		}
+#endif
 		for (i = 0; i < 8; i++) {
 			COPY_4X1_LINE(d_dst +  0, d_dst + tmp2 +  0);
 			COPY_4X1_LINE(d_dst +  4, d_dst + tmp2 +  4);
@@ -585,6 +614,9 @@ void Blocky16::level1(byte *d_dst) {
 			t = READ_LE_UINT16(_paramPtr + code * 2);
 			t = (t << 16) | t;
 		}
+#ifdef __SSE2__
+		fillRows16SSE2(d_dst, _d_pitch, t, 8);
+#else
 		for (i = 0; i < 8; i++) {
 			WRITE_4X1_LINE(d_dst +  0, t);
 			WRITE_4X1_LINE(d_dst +  4, t);
@@ -592,6 +624,7 @@ void Blocky16::level1(byte *d_dst) {
 			WRITE_4X1_LINE(d_dst + 12, t);
 			d_dst += _d_pitch;
 		}
+#endif
 	}
 }
 
@@ -25,6 +25,7 @@
 #include "common/textconsole.h"
 
 #include "engines/grim/movie/codecs/codec48.h"
+#include "engines/grim/movie/codecs/blocks_sse2.h"
 
 namespace Grim {
 
@@ -503,6 +504,9 @@ void Codec48Decoder::decode3(byte *dst, const byte *src, int bufOffset) {
 				break;
 			case 0xF7:
 				// Raw 8x8 block
+#ifdef __SSE2__
+				copyRows8SSE2(dst, _pitch, src, 8, 8);
+#else
 				*((uint32 *)dst) = *((const uint32 *)src);
 				*((uint32 *)(dst + 4)) = *((const uint32 *)(src + 4));
 				*((uint32 *)(dst + _pitch)) = *((const uint32 *)(src + 8));
@@ -519,6 +523,7 @@ void Codec48Decoder::decode3(byte *dst, const byte *src, int bufOffset) {
 				*((uint32 *)(dst + _pitch * 6 + 4)) = *((const uint32 *)(src + 52));
 				*((uint32 *)(dst + _pitch * 7)) = *((const uint32 *)(src + 56));
 				*((uint32 *)(dst + _pitch * 7 + 4)) = *((const uint32 *)(src + 60));
+#endif
 
 				src += 64;
 				break;
@@ -538,6 +543,13 @@ void Codec48Decoder::decode3(byte *dst, const byte *src, int bufOffset) {
 void Codec48Decoder::copyBlock(byte *dst, int deltaBufOffset, int offset) {
 	const byte *src = dst + deltaBufOffset + offset;
 
+#ifdef __SSE2__
+	if (src <= dst - 8 || src >= dst) {
+		copyRows8SSE2(dst, _pitch, src, _pitch, 8);
+		return;
+	}
+#endif
+
 	for (int i = 0; i < 8; i++) {
 		*((uint32 *)(dst + _pitch * i)) = *((const uint32 *)(src + _pitch * i));
 		*((uint32 *)(dst + _pitch * i + 4)) = *((const uint32 *)(src + _pitch * i + 4));
@@ -547,6 +559,9 @@ void Codec48Decoder::copyBlock(byte *dst, int deltaBufOffset, int offset) {
 void Codec48Decoder::scaleBlock(byte *dst, const byte *src) {
 	// This is doing a 2x scale of data
 
+#ifdef __SSE2__
+	scaleBlockSSE2(dst, _pitch, src);
+#else
 	for (int i = 0; i < 4; i++) {
 		uint16 pixels = src[0];
 		pixels = (pixels << 8) | pixels;
@@ -567,6 +582,7 @@ void Codec48Decoder::scaleBlock(byte *dst, const byte *src) {
 		src += 4;
 		dst += _pitch * 2;
 	}
+#endif
 }
 
 } // end of namespace Grim
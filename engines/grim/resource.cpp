@@ -72,8 +72,14 @@ public:
 };
 
 ResourceLoader::ResourceLoader() {
-	_cacheDirty = false;
 	_cacheMemorySize = 0;
+	_cacheHits = 0;
+	_cacheMisses = 0;
+	_cacheEvictions = 0;
+
+	// The size of the cached files, in kilobytes, up to 4 GB
+	ConfMan.registerDefault("resource_cache_size", 32 * 1024);
+	_cacheMemoryBudget = (uint32)CLIP<int>(ConfMan.getInt("resource_cache_size"), 0, 0xFFFFFFFF / 1024) * 1024;
 
 	Lab *l;
 	Common::ArchiveMemberList files, updFiles;
@@ -221,11 +227,12 @@ void clearList(Common::List<T> &list) {
 }
 
 ResourceLoader::~ResourceLoader() {
-	for (Common::Array<ResourceCache>::iterator i = _cache.begin(); i != _cache.end(); ++i) {
-		ResourceCache &r = *i;
-		delete[] r.fname;
-		delete[] r.resPtr;
-	}
+	Common::StackLock lock(_cacheMutex);
+	// The sounds being played may still have views of the cached files
+	for (ResourceCacheMap::iterator it = _cache.begin(); it != _cache.end(); ++it)
+		Common::MemoryReadStreamView::releaseParent(it->_value.data);
+	_cache.clear();
+	_cacheLRU.clear();
 	clearList(_models);
 	clearList(_colormaps);
 	clearList(_keyframeAnims);
@@ -233,32 +240,22 @@ ResourceLoader::~ResourceLoader() {
 	MD5Check::clear();
 }
 
-static int sortCallback(const void *entry1, const void *entry2) {
-	return scumm_stricmp(((const ResourceLoader::ResourceCache *)entry1)->fname, ((const ResourceLoader::ResourceCache *)entry2)->fname);
-}
-
 Common::SeekableReadStream *ResourceLoader::getFileFromCache(const Common::String &filename) const {
-	ResourceLoader::ResourceCache *entry = getEntryFromCache(filename);
-	if (!entry)
-		return nullptr;
-
-	return new Common::MemoryReadStream(entry->resPtr, entry->len);
-
-}
-
-ResourceLoader::ResourceCache *ResourceLoader::getEntryFromCache(const Common::String &filename) const {
-	if (_cache.empty())
+	Common::StackLock lock(_cacheMutex);
+	ResourceCacheMap::iterator it = _cache.find(filename);
+	if (it == _cache.end()) {
+		_cacheMisses++;
 		return nullptr;
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
 	}
 
-	ResourceCache key;
-	key.fname = const_cast<char *>(filename.c_str());
+	// Move the entry to the most recently used end
+	ResourceCache &entry = it->_value;
+	_cacheLRU.erase(entry.lruPosition);
+	_cacheLRU.push_back(it->_key);
+	entry.lruPosition = _cacheLRU.reverse_begin();
+	_cacheHits++;
 
-	return (ResourceLoader::ResourceCache *)bsearch(&key, _cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
+	return new Common::MemoryReadStreamView(entry.data, 0, entry.data->size());
 }
 
 Common::SeekableReadStream *ResourceLoader::loadFile(const Common::String &filename) const {
@@ -283,29 +280,75 @@ Common::SeekableReadStream *ResourceLoader::openNewStreamFile(Common::String fna
 			if (!s)
 				return nullptr;
 
+			// A file larger than the whole cache would only evict everything else
 			uint32 size = s->size();
-			byte *buf = new byte[size];
-			s->read(buf, size);
-			putIntoCache(fname, buf, size);
-			delete s;
-			s = new Common::MemoryReadStream(buf, size);
+			if (size <= _cacheMemoryBudget) {
+				byte *buf = (byte *)malloc(size);
+				s->read(buf, size);
+				delete s;
+				s = putIntoCache(fname, buf, size);
+			}
 		}
 	} else {
 		s = loadFile(fname);
 	}
 	// This will only have an effect if the stream is actually compressed.
-	return Common::wrapCompressedReadStream(s);
+	// The checkpoints keep the backward seeks from inflating the file again
+	// from its start.
+	return Common::wrapCompressedReadStream(s, 0, 256 * 1024);
 }
 
-void ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
-	ResourceCache entry;
-	entry.resPtr = res;
-	entry.len = len;
-	entry.fname = new char[fname.size() + 1];
-	strcpy(entry.fname, fname.c_str());
+Common::SeekableReadStream *ResourceLoader::putIntoCache(const Common::String &fname, byte *res, uint32 len) const {
+	Common::StackLock lock(_cacheMutex);
+
+	// The file may have been cached by another thread in the meantime
+	ResourceCacheMap::iterator it = _cache.find(fname);
+	if (it != _cache.end()) {
+		free(res);
+		return new Common::MemoryReadStreamView(it->_value.data, 0, it->_value.data->size());
+	}
+
+	// Make room for the new entry first, so that it is never evicted itself
+	evictFromCache(_cacheMemoryBudget > len ? _cacheMemoryBudget - len : 0);
+
+	_cacheLRU.push_back(fname);
+
+	ResourceCache &entry = _cache[fname];
+	entry.data = Common::SharedPtr<Common::MemoryReadStream>(new Common::MemoryReadStream(res, len, DisposeAfterUse::YES));
+	entry.lruPosition = _cacheLRU.reverse_begin();
 	_cacheMemorySize += len;
-	_cache.push_back(entry);
-	_cacheDirty = true;
+
+	return new Common::MemoryReadStreamView(entry.data, 0, len);
+}
+
+void ResourceLoader::evictFromCache(uint32 memoryBudget) const {
+	Common::List<Common::String>::iterator it = _cacheLRU.begin();
+	while (_cacheMemorySize > memoryBudget && it != _cacheLRU.end()) {
+		ResourceCacheMap::iterator entry = _cache.find(*it);
+
+		// Evicting files which are still being read would not free anything
+		if (!entry->_value.data.unique()) {
+			++it;
+			continue;
+		}
+
+		_cacheMemorySize -= entry->_value.data->size();
+		_cache.erase(entry);
+		it = _cacheLRU.erase(it);
+		_cacheEvictions++;
+	}
+}
+
+ResourceLoader::CacheStats ResourceLoader::getCacheStats() const {
+	Common::StackLock lock(_cacheMutex);
+	CacheStats stats;
+	stats.hits = _cacheHits;
+	stats.misses = _cacheMisses;
+	stats.evictions = _cacheEvictions;
+	stats.entries = _cache.size();
+	stats.memorySize = _cacheMemorySize;
+	stats.memoryBudget = _cacheMemoryBudget;
+	return stats;
 }
 
 CMap *ResourceLoader::loadColormap(const Common::String &filename) {
@@ -516,23 +559,15 @@ AnimationEmi *ResourceLoader::loadAnimationEmi(const Common::String &filename) {
 }
 
 void ResourceLoader::uncache(const char *filename) const {
-	Common::String fname = filename;
-	fname.toLowercase();
-
-	if (_cacheDirty) {
-		qsort(_cache.begin(), _cache.size(), sizeof(ResourceCache), sortCallback);
-		_cacheDirty = false;
-	}
-
-	for (unsigned int i = 0; i < _cache.size(); i++) {
-		if (fname.compareTo(_cache[i].fname) == 0) {
-			delete[] _cache[i].fname;
-			_cacheMemorySize -= _cache[i].len;
-			delete[] _cache[i].resPtr;
-			_cache.remove_at(i);
-			_cacheDirty = true;
-		}
-	}
+	Common::StackLock lock(_cacheMutex);
+	ResourceCacheMap::iterator it = _cache.find(filename);
+	if (it == _cache.end())
+		return;
+
+	_cacheMemorySize -= it->_value.data->size();
+	_cacheLRU.erase(it->_value.lruPosition);
+	Common::MemoryReadStreamView::releaseParent(it->_value.data);
+	_cache.erase(it);
 }
 
 void ResourceLoader::uncacheModel(Model *m) {
@@ -25,6 +25,12 @@
 
 #include "common/archive.h"
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/memstream.h"
+#include "common/mutex.h"
+#include "common/ptr.h"
 
 #include "engines/grim/object.h"
 
@@ -84,24 +90,46 @@ public:
 	void uncacheLipSync(LipSync *l);
 	void uncacheAnimationEmi(AnimationEmi *a);
 
-	struct ResourceCache {
-		char *fname;
-		byte *resPtr;
-		uint32 len;
+	struct CacheStats {
+		uint32 hits;
+		uint32 misses;
+		uint32 evictions;
+		uint32 entries;
+		uint32 memorySize;
+		uint32 memoryBudget;
 	};
 
+	CacheStats getCacheStats() const;
+
 	static Common::String fixFilename(const Common::String &filename, bool append = true);
 
 private:
+	/**
+	 * A file kept in memory by openNewStreamFile. The streams handed out
+	 * share the data, so that an entry can be evicted while they are in use.
+	 */
+	struct ResourceCache {
+		Common::SharedPtr<Common::MemoryReadStream> data;
+		Common::List<Common::String>::iterator lruPosition;
+	};
+
+	typedef Common::HashMap<Common::String, ResourceCache, Common::IgnoreCase_Hash, Common::IgnoreCase_EqualTo> ResourceCacheMap;
+
 	Common::SeekableReadStream *loadFile(const Common::String &filename) const;
 	Common::SeekableReadStream *getFileFromCache(const Common::String &filename) const;
-	ResourceLoader::ResourceCache *getEntryFromCache(const Common::String &filename) const;
-	void putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
+	Common::SeekableReadStream *putIntoCache(const Common::String &fname, byte *res, uint32 len) const;
+	void evictFromCache(uint32 memoryBudget) const; // With _cacheMutex held
 	void uncache(const char *fname) const;
 
-	mutable Common::Array<ResourceCache> _cache;
-	mutable bool _cacheDirty;
-	mutable int32 _cacheMemorySize;
+	mutable ResourceCacheMap _cache;
+	mutable Common::List<Common::String> _cacheLRU; // Least recently used first
+	mutable uint32 _cacheMemorySize;
+	uint32 _cacheMemoryBudget;
+	mutable uint32 _cacheHits;
+	mutable uint32 _cacheMisses;
+	mutable uint32 _cacheEvictions;
+	// The iMuse timer callback opens files as well, to fade out a track on a jump
+	mutable Common::Mutex _cacheMutex;
 
 	Common::List<EMIModel *> _emiModels;
 	Common::List<Model *> _models;
@@ -29,29 +29,47 @@
 #include "common/substream.h"
 
 #include "engines/myst3/lzo.h"
+#include "engines/myst3/lzo_stream.h"
 
 namespace Myst3 {
 
 static const uint32 kLZO1X = MKTAG('L', 'Z', 'O', 'X');
 
-Archive::Archive(Common::SeekableReadStream *file, const Common::String &roomName) :
+Archive::Archive(Common::SeekableReadStream *file, const Common::String &roomName, LzoBufferPool *bufferPool) :
 		_roomName(roomName),
-		_file(file) {
+		_file(file),
+		_bufferPool(bufferPool) {
 	assert(file);
 	readDirectory();
 }
 
+Archive::Archive(const Common::SharedPtr<Common::MemoryReadStream> &mapping, const Common::String &roomName, LzoBufferPool *bufferPool) :
+		_roomName(roomName),
+		_file(new Common::MemoryReadStreamView(mapping, 0, mapping->size())),
+		_mapping(mapping),
+		_bufferPool(bufferPool) {
+	readDirectory();
+}
+
 Archive::~Archive() {
 	delete _file;
+	// The sounds being played may still have views of the mapping
+	Common::MemoryReadStreamView::releaseParent(_mapping);
 }
 
-Archive *Archive::createFromFile(const Common::String &filename, const Common::String &roomName) {
+Archive *Archive::createFromFile(const Common::String &filename, const Common::String &roomName, LzoBufferPool *bufferPool) {
+	// Prefer mapping the archive into memory, so that the resources can be read in place
+	Common::MemoryReadStream *mapping = SearchMan.createMappedReadStreamForMember(filename);
+	if (mapping) {
+		return new Archive(Common::SharedPtr<Common::MemoryReadStream>(mapping), roomName, bufferPool);
+	}
+
 	Common::SeekableReadStream *file = SearchMan.createReadStreamForMember(filename);
 	if (!file) {
 		return nullptr;
 	}
 
-	return new Archive(file, roomName);
+	return new Archive(file, roomName, bufferPool);
 }
 
 void Archive::decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream) {
@@ -148,6 +166,34 @@ void Archive::readDirectory() {
 	while (directory.pos() + 4 < directory.size()) {
 		_directory.push_back(readEntry(directory));
 	}
+
+	buildIndex();
+}
+
+void Archive::buildIndex() {
+	_entryIndex.clear();
+	_subEntryIndex.clear();
+
+	// The directory is not modified once read, pointing into it is safe.
+	// When there are duplicates, the first one wins, as with a linear search.
+	for (uint i = 0; i < _directory.size(); i++) {
+		const DirectoryEntry &entry = _directory[i];
+
+		EntryKey entryKey(entry.roomName, entry.index);
+		if (_entryIndex.contains(entryKey)) {
+			continue;
+		}
+		_entryIndex.setVal(entryKey, &entry);
+
+		for (uint j = 0; j < entry.subentries.size(); j++) {
+			const DirectorySubEntry &subentry = entry.subentries[j];
+
+			SubEntryKey subEntryKey(entry.roomName, entry.index, subentry.face, subentry.type);
+			if (!_subEntryIndex.contains(subEntryKey)) {
+				_subEntryIndex.setVal(subEntryKey, &subentry);
+			}
+		}
+	}
 }
 
 void Archive::visit(ArchiveVisitor &visitor) {
@@ -163,57 +209,48 @@ void Archive::visit(ArchiveVisitor &visitor) {
 }
 
 Common::SeekableReadStream *Archive::dumpToMemory(uint32 offset, uint32 size) {
+	if (_mapping && offset + size <= (uint32)_mapping->size()) {
+		// Uncompressed resources are read from the mapped archive without a copy,
+		// the compressed ones are decompressed from it
+		Common::MemoryReadStreamView *view = new Common::MemoryReadStreamView(_mapping, offset, size);
+		if (size >= 8 && READ_LE_UINT32(view->getData()) == kLZO1X) {
+			return createLzoReadStream(view, _bufferPool);
+		}
+
+		return view;
+	}
+
 	_file->seek(offset);
 
 	byte *data = (byte *)malloc(size);
 	_file->read(data, size);
 
-	uint32 signature = READ_LE_UINT32(data);
-	if (signature == kLZO1X) {
-		uint32 uncompressedSize = READ_LE_UINT32(data + 4);
-		byte *uncompressed = (byte *)malloc(uncompressedSize);
-
-		size_t uncompressedWritten = 0;
-		LzoResult decompressResult = lzoDecompress(data + 8, size - 8, uncompressed, uncompressedSize, uncompressedWritten);
-		if (decompressResult != kLzoSuccess) {
-			error("Unable to decompress at offset %d", offset);
-		}
-
-		assert(uncompressedWritten == uncompressedSize);
-
-		free(data);
-		return new Common::MemoryReadStream(uncompressed, uncompressedSize, DisposeAfterUse::YES);
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	if (size >= 8 && READ_LE_UINT32(data) == kLZO1X) {
+		return createLzoReadStream(stream, _bufferPool);
 	}
 
-	return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	return stream;
 }
 
 const Archive::DirectoryEntry *Archive::getEntry(const Common::String &room, uint32 index) const {
-	for (uint i = 0; i < _directory.size(); i++) {
-		const DirectoryEntry &entry = _directory[i];
-		if (entry.index == index && entry.roomName == room) {
-			return &entry;
-		}
+	EntryIndex::const_iterator it = _entryIndex.find(EntryKey(room, index));
+	if (it == _entryIndex.end()) {
+		return nullptr;
 	}
 
-	return nullptr;
+	return it->_value;
 }
 
 ResourceDescription Archive::getDescription(const Common::String &room, uint32 index, uint16 face,
                                                  ResourceType type) {
-	const DirectoryEntry *entry = getEntry(room, index);
-	if (!entry) {
+	SubEntryIndex::const_iterator it = _subEntryIndex.find(SubEntryKey(room, index, face, type));
+	if (it == _subEntryIndex.end()) {
 		return ResourceDescription();
 	}
 
-	for (uint i = 0; i < entry->subentries.size(); i++) {
-		const DirectorySubEntry &subentry = entry->subentries[i];
-		if (subentry.face == face && subentry.type == type) {
-			return ResourceDescription(this, *entry, subentry);
-		}
-	}
-
-	return ResourceDescription();
+	const DirectoryEntry *entry = getEntry(room, index);
+	return ResourceDescription(this, *entry, *it->_value);
 }
 
 ResourceDescriptionArray Archive::listFilesMatching(const Common::String &room, uint32 index, ResourceType type) {
@@ -24,6 +24,10 @@
 #define MYST3_ARCHIVE_H
 
 #include "common/array.h"
+#include "common/hash-str.h"
+#include "common/hashmap.h"
+#include "common/memstream.h"
+#include "common/ptr.h"
 #include "common/stream.h"
 
 #include "math/vector3d.h"
@@ -31,6 +35,7 @@
 namespace Myst3 {
 
 class ArchiveVisitor;
+class LzoBufferPool;
 class ResourceDescription;
 
 typedef Common::Array<ResourceDescription> ResourceDescriptionArray;
@@ -81,10 +86,17 @@ public:
 		DirectoryEntry() : index(0) {}
 	};
 
-	Archive(Common::SeekableReadStream *file, const Common::String &roomName);
+	Archive(Common::SeekableReadStream *file, const Common::String &roomName, LzoBufferPool *bufferPool = nullptr);
+	Archive(const Common::SharedPtr<Common::MemoryReadStream> &mapping, const Common::String &roomName, LzoBufferPool *bufferPool = nullptr);
 	~Archive();
 
-	static Archive *createFromFile(const Common::String &filename, const Common::String &roomName);
+	/**
+	 * Open an archive
+	 *
+	 * @param bufferPool where the compressed resources are decompressed to, optional.
+	 *                   It must be kept until the streams of the resources are deleted.
+	 */
+	static Archive *createFromFile(const Common::String &filename, const Common::String &roomName, LzoBufferPool *bufferPool = nullptr);
 
 	ResourceDescription getDescription(const Common::String &room, uint32 index, uint16 face,
 	                                   ResourceType type);
@@ -95,13 +107,61 @@ public:
 
 	const Common::String &getRoomName() const { return _roomName; }
 
+	/** Whether the resources are read from the archive mapped into memory, rather than from the disk */
+	bool isMapped() const { return _mapping.get() != nullptr; }
+
 private:
+	struct EntryKey {
+		Common::String room;
+		uint32 index;
+
+		EntryKey(const Common::String &r, uint32 i) : room(r), index(i) {}
+
+		bool operator==(const EntryKey &k) const {
+			return index == k.index && room == k.room;
+		}
+	};
+
+	struct EntryKeyHash {
+		uint operator()(const EntryKey &v) const {
+			return Common::hashit(v.room) + v.index * 31;
+		}
+	};
+
+	struct SubEntryKey {
+		EntryKey entry;
+		uint16 face;
+		ResourceType type;
+
+		SubEntryKey(const Common::String &r, uint32 i, uint16 f, ResourceType t) : entry(r, i), face(f), type(t) {}
+
+		bool operator==(const SubEntryKey &k) const {
+			return face == k.face && type == k.type && entry == k.entry;
+		}
+	};
+
+	struct SubEntryKeyHash {
+		uint operator()(const SubEntryKey &v) const {
+			return EntryKeyHash()(v.entry) + (v.face << 8) + (uint)v.type * 7919;
+		}
+	};
+
+	typedef Common::HashMap<EntryKey, const DirectoryEntry *, EntryKeyHash> EntryIndex;
+	typedef Common::HashMap<SubEntryKey, const DirectorySubEntry *, SubEntryKeyHash> SubEntryIndex;
+
 	Common::String _roomName;
 	Common::SeekableReadStream *_file;
+	Common::SharedPtr<Common::MemoryReadStream> _mapping;
+	LzoBufferPool *_bufferPool;
 	Common::Array<DirectoryEntry> _directory;
 
+	/** Lookup tables into the directory, built once it is read */
+	EntryIndex _entryIndex;
+	SubEntryIndex _subEntryIndex;
+
 	void decryptHeader(Common::SeekableReadStream &inStream, Common::WriteStream &outStream);
 	void readDirectory();
+	void buildIndex();
 	DirectorySubEntry readSubEntry(Common::ReadStream &stream);
 	DirectoryEntry readEntry(Common::ReadStream &stream);
 	const DirectoryEntry *getEntry(const Common::String &room, uint32 index) const;
@@ -133,6 +193,7 @@ public:
 	bool isValid() const { return _archive && _entry && _subentry; }
 
 	Common::SeekableReadStream *createReadStream() const;
+	bool isMapped() const { return _archive->isMapped(); }
 
 	const Common::String &room() const { return _entry->roomName; }
 	uint16 index() const { return _entry->index; }
@@ -0,0 +1,347 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/myst3/face_cache.h"
+
+#include "engines/myst3/myst3.h"
+#include "engines/myst3/resource_loader.h"
+
+#include "common/config-manager.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+namespace Myst3 {
+
+// How often the timer proc looks for faces to decode, in microseconds
+static const int32 kDecodeInterval = 10000;
+
+FaceCache::FaceCache(const ResourceLoader &resourceLoader) :
+		_resourceLoader(resourceLoader),
+		_memorySize(0),
+		_memoryBudget(0) {
+	// The size of the cached bitmaps, in kilobytes. A cube node takes about 10 MB.
+	ConfMan.registerDefault("node_cache_size", 64 * 1024);
+	_memoryBudget = MAX(ConfMan.getInt("node_cache_size"), 0) * 1024;
+
+	g_system->getTimerManager()->installTimerProc(decodeHandler, kDecodeInterval, this, "myst3FaceDecode");
+}
+
+FaceCache::~FaceCache() {
+	g_system->getTimerManager()->removeTimerProc(decodeHandler);
+
+	// The timer proc is gone, the queued jobs can be dropped
+	for (Common::List<DecodeJob>::iterator it = _jobs.begin(); it != _jobs.end(); it++) {
+		delete it->stream;
+	}
+	_jobs.clear();
+	freeDecodedStreams();
+
+	for (CachedNodeList::iterator it = _prefetchedNodes.begin(); it != _prefetchedNodes.end(); it++) {
+		freeNode(*it);
+	}
+	_prefetchedNodes.clear();
+
+	clear();
+}
+
+void FaceCache::clear() {
+	for (CachedNodeList::iterator it = _nodes.begin(); it != _nodes.end(); it++) {
+		freeNode(*it);
+	}
+	_nodes.clear();
+	_memorySize = 0;
+}
+
+void FaceCache::getNodeFaces(const Common::String &room, uint16 nodeId, Node::Type type, Common::Array<Graphics::Surface> &faces) {
+	bool cube = type == Node::kCube;
+
+	collectPrefetchedNodes();
+
+	CachedNode *node = findNode(_nodes, room, nodeId, cube);
+	if (node) {
+		// Move the node to the front of the list
+		_nodes.remove(node);
+		_nodes.push_front(node);
+	} else {
+		node = findNode(_prefetchedNodes, room, nodeId, cube);
+		if (node) {
+			// The player was faster than the prefetcher, help it finish
+			_prefetchedNodes.remove(node);
+			node->prefetched = false;
+		} else {
+			node = new CachedNode();
+			node->room = room;
+			node->nodeId = nodeId;
+			node->cube = cube;
+			queueNode(node, true);
+		}
+
+		finishNode(node);
+
+		// Even a node over the budget is inserted, it is dropped once released
+		insertNode(node);
+	}
+
+	node->users++;
+	faces = node->faces;
+}
+
+void FaceCache::releaseNodeFaces(const Common::String &room, uint16 nodeId, Node::Type type) {
+	CachedNode *node = findNode(_nodes, room, nodeId, type == Node::kCube);
+	if (!node || node->users == 0) {
+		warning("Releasing the faces of node %s %d, which are not in use", room.c_str(), nodeId);
+		return;
+	}
+
+	node->users--;
+	evict(0);
+}
+
+void FaceCache::prefetchNode(const Common::String &room, uint16 nodeId) {
+	if (_memoryBudget == 0) {
+		return;
+	}
+
+	collectPrefetchedNodes();
+
+	if (findNode(_nodes, room, nodeId, true) || findNode(_prefetchedNodes, room, nodeId, true)) {
+		return;
+	}
+
+	// Only the nodes with cube faces in the loaded archives are prefetched.
+	// The archives can only be read from the engine thread, so when they are
+	// not mapped, reading the faces for the timer proc would not save any time.
+	ResourceDescription face = _resourceLoader.getFileDescription(room, nodeId, 1, Archive::kCubeFace);
+	if (!face.isValid() || !face.isMapped()) {
+		return;
+	}
+
+	CachedNode *node = new CachedNode();
+	node->room = room;
+	node->nodeId = nodeId;
+	node->cube = true;
+	node->prefetched = true;
+	queueNode(node, false);
+
+	_prefetchedNodes.push_back(node);
+}
+
+void FaceCache::cancelPrefetch() {
+	Common::StackLock lock(_jobsMutex);
+
+	for (Common::List<DecodeJob>::iterator it = _jobs.begin(); it != _jobs.end(); ) {
+		CachedNode *node = it->node;
+		if (node->prefetched) {
+			delete it->stream;
+			node->pendingFaces--;
+			node->cancelled = true;
+			it = _jobs.erase(it);
+		} else {
+			it++;
+		}
+	}
+
+	// The faces being decoded still need to finish,
+	// the cancelled nodes are freed once they are done
+}
+
+FaceCache::CachedNode *FaceCache::findNode(const CachedNodeList &list, const Common::String &room, uint16 nodeId, bool cube) {
+	for (CachedNodeList::const_iterator it = list.begin(); it != list.end(); it++) {
+		CachedNode *node = *it;
+		if (node->nodeId == nodeId && node->cube == cube && !node->cancelled && node->room == room) {
+			return node;
+		}
+	}
+
+	return nullptr;
+}
+
+void FaceCache::queueNode(CachedNode *node, bool urgent) {
+	node->faces.resize(node->cube ? 6 : 1);
+
+	// The archives can only be read from the engine thread,
+	// the compressed faces are read before queuing them
+	Common::Array<DecodeJob> jobs;
+	for (uint faceId = 0; faceId < node->faces.size(); faceId++) {
+		ResourceDescription resource;
+		if (node->cube) {
+			resource = _resourceLoader.getCubeBitmap(node->room, node->nodeId, faceId);
+		} else {
+			resource = _resourceLoader.getFrameBitmap(node->room, node->nodeId);
+		}
+
+		DecodeJob job;
+		job.node = node;
+		job.stream = resource.createReadStream();
+		job.surface = &node->faces[faceId];
+		jobs.push_back(job);
+	}
+
+	Common::StackLock lock(_jobsMutex);
+	node->pendingFaces = jobs.size();
+
+	// The node the engine is waiting for goes before the prefetched ones
+	for (uint i = 0; i < jobs.size(); i++) {
+		if (urgent) {
+			_jobs.push_front(jobs[jobs.size() - 1 - i]);
+		} else {
+			_jobs.push_back(jobs[i]);
+		}
+	}
+}
+
+void FaceCache::finishNode(CachedNode *node) {
+	// Decode faces along with the timer proc until there are none left
+	// in the queue, then wait for the ones it is still working on
+	while (true) {
+		{
+			Common::StackLock lock(_jobsMutex);
+			if (node->pendingFaces == 0) {
+				break;
+			}
+		}
+
+		if (!decodeNextJob(node)) {
+			// The timer proc is decoding the last faces of the node, wait for it
+			Common::StackLock lock(_timerJobMutex);
+		}
+	}
+
+	freeDecodedStreams();
+
+	node->memorySize = 0;
+	for (uint i = 0; i < node->faces.size(); i++) {
+		const Graphics::Surface &face = node->faces[i];
+		node->memorySize += face.h * face.pitch;
+	}
+}
+
+void FaceCache::decodeHandler(void *refCon) {
+	// One face at a time, the other timer procs share the thread
+	FaceCache *faceCache = (FaceCache *)refCon;
+
+	Common::StackLock lock(faceCache->_timerJobMutex);
+	faceCache->decodeNextJob(nullptr);
+}
+
+bool FaceCache::decodeNextJob(CachedNode *node) {
+	DecodeJob job;
+	{
+		Common::StackLock lock(_jobsMutex);
+
+		// Take the first job, or the first one of the node, if one was given
+		Common::List<DecodeJob>::iterator it = _jobs.begin();
+		while (node && it != _jobs.end() && it->node != node) {
+			it++;
+		}
+
+		if (it == _jobs.end()) {
+			return false;
+		}
+
+		job = *it;
+		_jobs.erase(it);
+	}
+
+	Myst3Engine::decodeJpeg(*job.stream, *job.surface);
+
+	Common::StackLock lock(_jobsMutex);
+	job.node->pendingFaces--;
+	_decodedStreams.push_back(job.stream);
+
+	return true;
+}
+
+void FaceCache::freeDecodedStreams() {
+	Common::List<Common::SeekableReadStream *> streams;
+	{
+		Common::StackLock lock(_jobsMutex);
+		streams = _decodedStreams;
+		_decodedStreams.clear();
+	}
+
+	for (Common::List<Common::SeekableReadStream *>::iterator it = streams.begin(); it != streams.end(); it++) {
+		delete *it;
+	}
+}
+
+void FaceCache::collectPrefetchedNodes() {
+	freeDecodedStreams();
+
+	CachedNodeList readyNodes;
+	{
+		Common::StackLock lock(_jobsMutex);
+		for (CachedNodeList::iterator it = _prefetchedNodes.begin(); it != _prefetchedNodes.end(); ) {
+			if ((*it)->pendingFaces == 0) {
+				readyNodes.push_back(*it);
+				it = _prefetchedNodes.erase(it);
+			} else {
+				it++;
+			}
+		}
+	}
+
+	for (CachedNodeList::iterator it = readyNodes.begin(); it != readyNodes.end(); it++) {
+		CachedNode *node = *it;
+		finishNode(node);
+
+		if (node->cancelled || node->memorySize > _memoryBudget) {
+			freeNode(node);
+		} else {
+			insertNode(node);
+		}
+	}
+}
+
+void FaceCache::insertNode(CachedNode *node) {
+	evict(node->memorySize);
+	_nodes.push_front(node);
+	_memorySize += node->memorySize;
+}
+
+void FaceCache::freeNode(CachedNode *node) {
+	for (uint i = 0; i < node->faces.size(); i++) {
+		node->faces[i].free();
+	}
+
+	delete node;
+}
+
+void FaceCache::evict(uint32 neededSize) {
+	CachedNodeList::iterator it = _nodes.end();
+	while (it != _nodes.begin() && _memorySize + neededSize > _memoryBudget) {
+		it--;
+
+		// The faces in use stay, even over the budget
+		CachedNode *node = *it;
+		if (node->users > 0) {
+			continue;
+		}
+
+		_memorySize -= node->memorySize;
+		freeNode(node);
+		it = _nodes.erase(it);
+	}
+}
+
+} // End of namespace Myst3
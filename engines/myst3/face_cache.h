@@ -0,0 +1,159 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MYST3_FACE_CACHE_H
+#define MYST3_FACE_CACHE_H
+
+#include "engines/myst3/node.h"
+
+#include "common/array.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+#include "graphics/surface.h"
+
+namespace Common {
+class SeekableReadStream;
+}
+
+namespace Myst3 {
+
+class ResourceLoader;
+
+/**
+ * Decodes the bitmaps of the nodes, and keeps the ones of the recently
+ * visited nodes.
+ *
+ * The faces of a cube node are decoded in parallel, the engine thread and a
+ * timer proc both take faces from the same queue. The decoded bitmaps are kept
+ * until the budget set by the "node_cache_size" setting, in kilobytes, is
+ * reached. The least recently used nodes are then dropped, unless their
+ * faces are still in use.
+ *
+ * The nodes the player is likely to go to next can be prefetched, when their
+ * archive is mapped into memory. Their faces are decoded by the timer proc,
+ * one per tick, and added to the cache once they are all ready.
+ */
+class FaceCache {
+public:
+	FaceCache(const ResourceLoader &resourceLoader);
+	~FaceCache();
+
+	/**
+	 * Get the decoded bitmaps of a node
+	 *
+	 * Cube nodes have six faces, the other node types have one. The faces
+	 * belong to the cache and must not be drawn onto. They remain valid until
+	 * releaseNodeFaces() is called for the node.
+	 */
+	void getNodeFaces(const Common::String &room, uint16 nodeId, Node::Type type, Common::Array<Graphics::Surface> &faces);
+
+	/** Let the cache drop the faces of a node again, once they are not used any more */
+	void releaseNodeFaces(const Common::String &room, uint16 nodeId, Node::Type type);
+
+	/**
+	 * Start decoding the faces of a cube node in the background
+	 *
+	 * The node must be in the room whose archives are loaded. Frame nodes
+	 * are a single image and are not prefetched.
+	 */
+	void prefetchNode(const Common::String &room, uint16 nodeId);
+
+	/** Stop decoding the prefetched nodes that are not ready yet */
+	void cancelPrefetch();
+
+	/** Drop all the cached bitmaps */
+	void clear();
+
+	uint32 getMemorySize() const { return _memorySize; }
+	uint32 getMemoryBudget() const { return _memoryBudget; }
+
+private:
+	struct CachedNode {
+		Common::String room;
+		uint16 nodeId;
+		bool cube;
+
+		Common::Array<Graphics::Surface> faces;
+		uint32 memorySize;
+
+		/** How many times the faces were handed out and not released yet */
+		uint users;
+
+		/** Faces queued or being decoded, guarded by the jobs mutex */
+		uint pendingFaces;
+		bool prefetched;
+		bool cancelled;
+
+		CachedNode() : nodeId(0), cube(false), memorySize(0), users(0), pendingFaces(0), prefetched(false), cancelled(false) {}
+	};
+
+	struct DecodeJob {
+		CachedNode *node;
+		Common::SeekableReadStream *stream;
+		Graphics::Surface *surface;
+	};
+
+	typedef Common::List<CachedNode *> CachedNodeList;
+
+	static void decodeHandler(void *refCon);
+
+	CachedNode *findNode(const CachedNodeList &list, const Common::String &room, uint16 nodeId, bool cube);
+	void queueNode(CachedNode *node, bool urgent);
+	void finishNode(CachedNode *node);
+	bool decodeNextJob(CachedNode *node);
+	void freeDecodedStreams();
+	void collectPrefetchedNodes();
+	void insertNode(CachedNode *node);
+	void freeNode(CachedNode *node);
+	void evict(uint32 neededSize);
+
+	const ResourceLoader &_resourceLoader;
+
+	/** The cached nodes, the most recently used first */
+	CachedNodeList _nodes;
+	uint32 _memorySize;
+	uint32 _memoryBudget;
+
+	/** The prefetched nodes whose faces are not all decoded yet */
+	CachedNodeList _prefetchedNodes;
+
+	Common::Mutex _jobsMutex;
+	Common::List<DecodeJob> _jobs;
+
+	/**
+	 * Held by the timer proc from taking a job until it is done, so that the
+	 * engine thread can wait for it by locking it.
+	 */
+	Common::Mutex _timerJobMutex;
+
+	/**
+	 * The streams of the decoded faces, deleted by the engine thread.
+	 * They may share the archive mapping with the streams the engine creates.
+	 */
+	Common::List<Common::SeekableReadStream *> _decodedStreams;
+};
+
+} // End of namespace Myst3
+
+#endif
@@ -60,31 +60,12 @@ namespace Myst3 {
 
 static const size_t Max255Count = size_t(~0) / 255 - 2;
 
-#define NEEDS_IN(count)                 \
-	if (inp + (count) > inp_end) {      \
-		dstSize = outp - dst;           \
-		return kLzoInputOverrun; \
-	}
-
 #define NEEDS_OUT(count)                 \
 	if (outp + (count) > outp_end) {     \
 		dstSize = outp - dst;            \
 		return kLzoOutputOverrun; \
 	}
 
-#define CONSUME_ZERO_BYTE_LENGTH     \
-	size_t offset;                   \
-	{                                \
-		const uint8 *old_inp = inp;  \
-		while (*inp == 0)            \
-			++inp;                   \
-		offset = inp - old_inp;      \
-		if (offset > Max255Count) {  \
-			dstSize = outp - dst;    \
-			return kLzoError; \
-		}                            \
-	}
-
 #define WRITE_ZERO_BYTE_LENGTH(length)        \
 	{                                         \
 		size_t l;                             \
@@ -116,59 +97,107 @@ static const uint32 M4Marker = 0x10;
 static const uint32 MaxMatchByLengthLen = 34; /* Max M3 len + 1 */
 static const uint16 UInt16Max = 65535u;
 
-LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
-                        uint8 *dst, size_t initDstSize,
-                        size_t &dstSize) {
-	dstSize = initDstSize;
+LzoDecoder::LzoDecoder(const uint8 *src, size_t srcSize) :
+		_src(src),
+		_inEnd(src + srcSize) {
+	reset();
+}
 
-	if (srcSize < 3) {
-		dstSize = 0;
-		return kLzoInputOverrun;
-	}
+void LzoDecoder::reset() {
+	_s.in = _src;
+	_s.state = 0;
+	_s.matchDistance = 0;
+	_s.matchLength = 0;
+	_s.literalLength = 0;
+	_s.started = false;
+	_s.finished = false;
+}
 
-	const uint8 *inp = src;
-	const uint8 *inp_end = src + srcSize;
-	uint8 *outp = dst;
-	uint8 *outp_end = dst + dstSize;
-	uint8 *lbcur;
-	size_t lblen;
-	size_t state = 0;
-	size_t nstate = 0;
-
-	/* First byte encoding */
-	if (*inp >= 22) {
-		/* 22..255 : copy literal string
-		 *           length = (byte - 17) = 4..238
-		 *           state = 4 [ don't copy extra literals ]
-		 *           skip byte
-		 */
-		size_t len = *inp++ - uint8(17);
-		NEEDS_IN(len)
-		NEEDS_OUT(len)
-		for (size_t i = 0; i < len; ++i)
-			*outp++ = *inp++;
-		state = 4;
-	} else if (*inp >= 18) {
-		/* 18..21 : copy 0..3 literals
-		 *          state = (byte - 17) = 0..3  [ copy <state> literals ]
-		 *          skip byte
-		 */
-		nstate = *inp++ - uint8(17);
-		state = nstate;
-		NEEDS_IN(nstate)
-		NEEDS_OUT(nstate)
-		for (size_t i = 0; i < nstate; ++i)
-			*outp++ = *inp++;
-	}
-	/* 0..17 : follow regular instruction encoding, see below. It is worth
-	 *         noting that codes 16 and 17 will represent a block copy from
-	 *         the dictionary which is empty, and that they will always be
-	 *         invalid at this place.
-	 */
+LzoResult LzoDecoder::decompress(const uint8 *window, uint8 *&out, uint8 *outEnd) {
+	// The state is kept in locals while decompressing, as the bytes written could alias the members
+	DecoderState s = _s;
+	const uint8 *inEnd = _inEnd;
+	uint8 *outp = out;
+	LzoResult result;
 
 	while (true) {
-		NEEDS_IN(1)
-		uint8 inst = *inp++;
+		if (s.matchLength > 0) {
+			/* Copy lookbehind, the copy may overlap so it is done byte per byte */
+			size_t count = MIN<size_t>(s.matchLength, outEnd - outp);
+			const uint8 *match = outp - s.matchDistance;
+			for (size_t i = 0; i < count; ++i)
+				*outp++ = *match++;
+			s.matchLength -= count;
+			if (s.matchLength > 0) {
+				result = kLzoOutputOverrun;
+				break;
+			}
+		}
+
+		if (s.literalLength > 0) {
+			/* Copy literal */
+			if (s.literalLength > size_t(inEnd - s.in)) {
+				result = kLzoInputOverrun;
+				break;
+			}
+			size_t count = MIN<size_t>(s.literalLength, outEnd - outp);
+			memcpy(outp, s.in, count);
+			s.in += count;
+			outp += count;
+			s.literalLength -= count;
+			if (s.literalLength > 0) {
+				result = kLzoOutputOverrun;
+				break;
+			}
+		}
+
+		if (s.finished) {
+			result = kLzoSuccess;
+			break;
+		}
+
+		if (!s.started) {
+			s.started = true;
+
+			/* First byte encoding */
+			if (s.in >= inEnd) {
+				result = kLzoInputOverrun;
+				break;
+			}
+			if (*s.in >= 22) {
+				/* 22..255 : copy literal string
+				 *           length = (byte - 17) = 4..238
+				 *           state = 4 [ don't copy extra literals ]
+				 *           skip byte
+				 */
+				s.literalLength = *s.in++ - uint8(17);
+				s.state = 4;
+				continue;
+			} else if (*s.in >= 18) {
+				/* 18..21 : copy 0..3 literals
+				 *          state = (byte - 17) = 0..3  [ copy <state> literals ]
+				 *          skip byte
+				 */
+				s.literalLength = *s.in++ - uint8(17);
+				s.state = s.literalLength;
+				continue;
+			}
+			/* 0..17 : follow regular instruction encoding, see below. It is worth
+			 *         noting that codes 16 and 17 will represent a block copy from
+			 *         the dictionary which is empty, and that they will always be
+			 *         invalid at this place.
+			 */
+		}
+
+		if (s.in >= inEnd) {
+			result = kLzoInputOverrun;
+			break;
+		}
+
+		uint8 inst = *s.in++;
+		size_t length;
+		size_t distance;
+		uint32 nextState;
 		if (inst & 0xC0) {
 			/* [M2]
 			 * 1 L L D D D S S  (128..255)
@@ -185,10 +214,13 @@ LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
 			 * Always followed by exactly one byte : H H H H H H H H
 			 *   distance = (H << 3) + D + 1
 			 */
-			NEEDS_IN(1)
-			lbcur = outp - ((*inp++ << 3) + ((inst >> 2) & 0x7) + 1);
-			lblen = size_t(inst >> 5) + 1;
-			nstate = inst & uint8(0x3);
+			if (s.in >= inEnd) {
+				result = kLzoInputOverrun;
+				break;
+			}
+			distance = (*s.in++ << 3) + ((inst >> 2) & 0x7) + 1;
+			length = size_t(inst >> 5) + 1;
+			nextState = inst & uint8(0x3);
 		} else if (inst & M3Marker) {
 			/* [M3]
 			 * 0 0 1 L L L L L  (32..63)
@@ -198,17 +230,20 @@ LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
 			 *   distance = D + 1
 			 *   state = S (copy S literals after this block)
 			 */
-			lblen = size_t(inst & uint8(0x1f)) + 2;
-			if (lblen == 2) {
-				CONSUME_ZERO_BYTE_LENGTH
-				NEEDS_IN(1)
-				lblen += offset * 255 + 31 + *inp++;
+			length = size_t(inst & uint8(0x1f)) + 2;
+			if (length == 2) {
+				result = readLength(s, inEnd, 31, length);
+				if (result != kLzoSuccess)
+					break;
+			}
+			if (s.in + 2 > inEnd) {
+				result = kLzoInputOverrun;
+				break;
 			}
-			NEEDS_IN(2)
-			nstate = READ_LE_UINT16(inp);
-			inp += 2;
-			lbcur = outp - ((nstate >> 2) + 1);
-			nstate &= 0x3;
+			uint16 value = READ_LE_UINT16(s.in);
+			s.in += 2;
+			distance = (value >> 2) + 1;
+			nextState = value & 0x3;
 		} else if (inst & M4Marker) {
 			/* [M4]
 			 * 0 0 0 1 H L L L  (16..31)
@@ -219,45 +254,54 @@ LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
 			 *   state = S (copy S literals after this block)
 			 *   End of stream is reached if distance == 16384
 			 */
-			lblen = size_t(inst & uint8(0x7)) + 2;
-			if (lblen == 2) {
-				CONSUME_ZERO_BYTE_LENGTH
-				NEEDS_IN(1)
-				lblen += offset * 255 + 7 + *inp++;
+			length = size_t(inst & uint8(0x7)) + 2;
+			if (length == 2) {
+				result = readLength(s, inEnd, 7, length);
+				if (result != kLzoSuccess)
+					break;
+			}
+			if (s.in + 2 > inEnd) {
+				result = kLzoInputOverrun;
+				break;
 			}
-			NEEDS_IN(2)
-			nstate = READ_LE_UINT16(inp);
-			inp += 2;
-			lbcur = outp - (((inst & 0x8) << 11) + (nstate >> 2));
-			nstate &= 0x3;
-			if (lbcur == outp)
-				break; /* Stream finished */
-			lbcur -= 16384;
+			uint16 value = READ_LE_UINT16(s.in);
+			s.in += 2;
+			distance = ((inst & 0x8) << 11) + (value >> 2);
+			nextState = value & 0x3;
+			if (distance == 0) {
+				/* Stream finished, the terminating M4 has a length of 3 */
+				s.finished = true;
+				result = length == 3 ? kLzoSuccess : kLzoError;
+				break;
+			}
+			distance += 16384;
+		} else if (s.state == 0) {
+			/* [M1] Depends on the number of literals copied by the last instruction.
+			 *
+			 * If last instruction did not copy any literal (state == 0), this
+			 * encoding will be a copy of 4 or more literal, and must be interpreted
+			 * like this :
+			 *
+			 *    0 0 0 0 L L L L  (0..15)  : copy long literal string
+			 *    length = 3 + (L ?: 15 + (zero_bytes * 255) + non_zero_byte)
+			 *    state = 4  (no extra literals are copied)
+			 */
+			length = inst + 3;
+			if (length == 3) {
+				result = readLength(s, inEnd, 15, length);
+				if (result != kLzoSuccess)
+					break;
+			}
+			s.literalLength = length;
+			s.state = 4;
+			continue;
 		} else {
-			/* [M1] Depends on the number of literals copied by the last instruction. */
-			if (state == 0) {
-				/* If last instruction did not copy any literal (state == 0), this
-				 * encoding will be a copy of 4 or more literal, and must be interpreted
-				 * like this :
-				 *
-				 *    0 0 0 0 L L L L  (0..15)  : copy long literal string
-				 *    length = 3 + (L ?: 15 + (zero_bytes * 255) + non_zero_byte)
-				 *    state = 4  (no extra literals are copied)
-				 */
-				size_t len = inst + 3;
-				if (len == 3) {
-					CONSUME_ZERO_BYTE_LENGTH
-					NEEDS_IN(1)
-					len += offset * 255 + 15 + *inp++;
-				}
-				/* copy_literal_run */
-				NEEDS_IN(len)
-				NEEDS_OUT(len)
-				for (size_t i = 0; i < len; ++i)
-					*outp++ = *inp++;
-				state = 4;
-				continue;
-			} else if (state != 4) {
+			if (s.in >= inEnd) {
+				result = kLzoInputOverrun;
+				break;
+			}
+			nextState = inst & uint8(0x3);
+			if (s.state != 4) {
 				/* If last instruction used to copy between 1 to 3 literals (encoded in
 				 * the instruction's opcode or distance), the instruction is a copy of a
 				 * 2-byte block from the dictionary within a 1kB distance. It is worth
@@ -271,10 +315,8 @@ LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
 				 *  Always followed by exactly one byte : H H H H H H H H
 				 *    distance = (H << 2) + D + 1
 				 */
-				NEEDS_IN(1)
-				nstate = inst & uint8(0x3);
-				lbcur = outp - ((inst >> 2) + (*inp++ << 2) + 1);
-				lblen = 2;
+				distance = (inst >> 2) + (*s.in++ << 2) + 1;
+				length = 2;
 			} else {
 				/* If last instruction used to copy 4 or more literals (as detected by
 				 * state == 4), the instruction becomes a copy of a 3-byte block from the
@@ -286,36 +328,77 @@ LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
 				 *  Always followed by exactly one byte : H H H H H H H H
 				 *    distance = (H << 2) + D + 2049
 				 */
-				NEEDS_IN(1)
-				nstate = inst & uint8(0x3);
-				lbcur = outp - ((inst >> 2) + (*inp++ << 2) + 2049);
-				lblen = 3;
+				distance = (inst >> 2) + (*s.in++ << 2) + 2049;
+				length = 3;
 			}
 		}
-		if (lbcur < dst) {
-			dstSize = outp - dst;
-			return kLzoLookbehindOverrun;
+
+		if (distance > size_t(outp - window)) {
+			result = kLzoLookbehindOverrun;
+			break;
+		}
+
+		s.matchDistance = distance;
+		s.matchLength = length;
+		s.literalLength = nextState;
+		s.state = nextState;
+
+		/* Unless the output is almost full, the whole instruction is copied right
+		 * away. The copies use locals, as the bytes written could alias the state. */
+		size_t matchLength = s.matchLength;
+		size_t literalLength = s.literalLength;
+		const uint8 *inp = s.in;
+		if (matchLength + literalLength <= size_t(outEnd - outp) && literalLength <= size_t(inEnd - inp)) {
+			const uint8 *match = outp - s.matchDistance;
+			for (size_t i = 0; i < matchLength; ++i)
+				*outp++ = *match++;
+			for (size_t i = 0; i < literalLength; ++i)
+				*outp++ = *inp++;
+			s.in = inp;
+			s.matchLength = 0;
+			s.literalLength = 0;
 		}
-		NEEDS_IN(nstate)
-		NEEDS_OUT(lblen + nstate)
-		/* Copy lookbehind */
-		for (size_t i = 0; i < lblen; ++i)
-			*outp++ = *lbcur++;
-		state = nstate;
-		/* Copy literal */
-		for (size_t i = 0; i < nstate; ++i)
-			*outp++ = *inp++;
 	}
 
-	dstSize = outp - dst;
-	if (lblen != 3) /* Ensure terminating M4 was encountered */
+	_s = s;
+	out = outp;
+	return result;
+}
+
+inline LzoResult LzoDecoder::readLength(DecoderState &s, const uint8 *inEnd, uint32 base, size_t &length) {
+	/* Long lengths are a run of zero bytes, each adding 255, and a final non-zero byte */
+	const uint8 *zeroBytes = s.in;
+	while (s.in < inEnd && *s.in == 0)
+		++s.in;
+	if (s.in >= inEnd)
+		return kLzoInputOverrun;
+
+	size_t offset = s.in - zeroBytes;
+	if (offset > Max255Count)
 		return kLzoError;
-	if (inp == inp_end)
-		return kLzoSuccess;
-	else if (inp < inp_end)
-		return kLzoInputNotConsumed;
-	else
+
+	length += offset * 255 + base + *s.in++;
+	return kLzoSuccess;
+}
+
+LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
+                        uint8 *dst, size_t dstSize,
+                        size_t &outSize) {
+	if (srcSize < 3) {
+		outSize = 0;
 		return kLzoInputOverrun;
+	}
+
+	LzoDecoder decoder(src, srcSize);
+	uint8 *outp = dst;
+	LzoResult result = decoder.decompress(dst, outp, dst + dstSize);
+	outSize = outp - dst;
+
+	if (result != kLzoSuccess)
+		return result;
+	if (decoder.getRemainingInput() > 0)
+		return kLzoInputNotConsumed;
+	return kLzoSuccess;
 }
 
 static const uint32 DictHashSize = 0x4000;
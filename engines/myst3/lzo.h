@@ -36,6 +36,53 @@ enum LzoResult {
 	kLzoInputNotConsumed = 1
 };
 
+/**
+ * A LZO1X decoder which stops when its output buffer is full, and
+ * resumes where it stopped with the next one.
+ */
+class LzoDecoder {
+public:
+	LzoDecoder(const uint8 *src, size_t srcSize);
+
+	/** Start decompressing again from the beginning of the input */
+	void reset();
+
+	/**
+	 * Decompress until the end of the data or until the output is full
+	 *
+	 * @param window the start of the decompressed data the matches can refer to.
+	 *               When resuming, out must be preceded by the data decompressed
+	 *               so far, at least the 48 kB matches can reach.
+	 * @param out    where to decompress to, advanced past the decompressed data
+	 * @param outEnd the end of the output buffer
+	 * @return kLzoSuccess at the end of the data, kLzoOutputOverrun when the
+	 *         output is full and there is more to decompress, or an error
+	 */
+	LzoResult decompress(const uint8 *window, uint8 *&out, uint8 *outEnd);
+
+	/** The number of input bytes after the end of the compressed data */
+	size_t getRemainingInput() const { return _inEnd - _s.in; }
+
+private:
+	struct DecoderState {
+		const uint8 *in;
+		/** The literals copied by the last instruction, see decompress */
+		uint32 state;
+		/** What is left to copy of the current instruction, the match goes first */
+		size_t matchDistance;
+		size_t matchLength;
+		size_t literalLength;
+		bool started;
+		bool finished;
+	};
+
+	static LzoResult readLength(DecoderState &s, const uint8 *inEnd, uint32 base, size_t &length);
+
+	const uint8 *_src;
+	const uint8 *_inEnd;
+	DecoderState _s;
+};
+
 LzoResult lzoDecompress(const uint8 *src, size_t srcSize,
                         uint8 *dst, size_t dstSize,
                         size_t &outSize);
@@ -0,0 +1,323 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/myst3/lzo_stream.h"
+#include "engines/myst3/lzo.h"
+
+#include "common/endian.h"
+#include "common/memstream.h"
+#include "common/textconsole.h"
+#include "common/util.h"
+
+namespace Myst3 {
+
+// The resources larger than this are decompressed as they are read
+static const uint32 kLzoStreamingThreshold = 256 * 1024;
+
+// The farthest back a LZO1X match can refer to
+static const uint32 kLzoHistorySize = 0xC000;
+
+// How much is decompressed at once by the streams
+static const uint32 kLzoChunkSize = 64 * 1024;
+
+// The sizes of the pooled buffers are rounded, so that they fit more resources
+static const uint32 kLzoBufferGranularity = 4 * 1024;
+
+LzoBufferPool::LzoBufferPool(uint32 maxFreeSize) :
+		_freeSize(0),
+		_maxFreeSize(maxFreeSize),
+		_takenCount(0),
+		_released(false) {
+}
+
+LzoBufferPool::~LzoBufferPool() {
+	for (uint i = 0; i < _freeBuffers.size(); i++) {
+		free(_freeBuffers[i].data);
+	}
+}
+
+void LzoBufferPool::release() {
+	bool unused;
+	{
+		Common::StackLock lock(_mutex);
+		_released = true;
+		unused = _takenCount == 0;
+	}
+
+	if (unused) {
+		delete this;
+	}
+}
+
+byte *LzoBufferPool::take(uint32 size, uint32 &capacity) {
+	Common::StackLock lock(_mutex);
+	_takenCount++;
+
+	// Pick the smallest free buffer the data fits in,
+	// but don't waste a large buffer on a small resource
+	int best = -1;
+	for (uint i = 0; i < _freeBuffers.size(); i++) {
+		uint32 freeCapacity = _freeBuffers[i].capacity;
+		if (freeCapacity >= size && freeCapacity / 2 <= size
+				&& (best < 0 || freeCapacity < _freeBuffers[best].capacity)) {
+			best = i;
+		}
+	}
+
+	if (best >= 0) {
+		byte *buffer = _freeBuffers[best].data;
+		capacity = _freeBuffers[best].capacity;
+		_freeSize -= capacity;
+		_freeBuffers.remove_at(best);
+		return buffer;
+	}
+
+	capacity = (size + kLzoBufferGranularity - 1) / kLzoBufferGranularity * kLzoBufferGranularity;
+	return (byte *)malloc(capacity);
+}
+
+void LzoBufferPool::giveBack(byte *buffer, uint32 capacity) {
+	bool unused;
+	{
+		Common::StackLock lock(_mutex);
+		_takenCount--;
+		unused = _released && _takenCount == 0;
+
+		if (!_released && _freeSize + capacity <= _maxFreeSize) {
+			FreeBuffer freeBuffer;
+			freeBuffer.data = buffer;
+			freeBuffer.capacity = capacity;
+			_freeBuffers.push_back(freeBuffer);
+			_freeSize += capacity;
+			buffer = nullptr;
+		}
+	}
+
+	free(buffer);
+
+	if (unused) {
+		delete this;
+	}
+}
+
+static byte *takeBuffer(LzoBufferPool *pool, uint32 size, uint32 &capacity) {
+	if (pool) {
+		return pool->take(size, capacity);
+	}
+
+	capacity = size;
+	return (byte *)malloc(size);
+}
+
+static void giveBackBuffer(LzoBufferPool *pool, byte *buffer, uint32 capacity) {
+	if (pool) {
+		pool->giveBack(buffer, capacity);
+	} else {
+		free(buffer);
+	}
+}
+
+/** A memory stream over a buffer taken from a pool */
+class PooledMemoryReadStream : public Common::MemoryReadStream {
+public:
+	PooledMemoryReadStream(LzoBufferPool *pool, byte *buffer, uint32 capacity, uint32 size) :
+			MemoryReadStream(buffer, size, DisposeAfterUse::NO),
+			_pool(pool),
+			_buffer(buffer),
+			_capacity(capacity) {
+	}
+
+	~PooledMemoryReadStream() override {
+		giveBackBuffer(_pool, _buffer, _capacity);
+	}
+
+private:
+	LzoBufferPool *_pool;
+	byte *_buffer;
+	uint32 _capacity;
+};
+
+/**
+ * A stream decompressing LZO1X data in chunks, as it is read
+ *
+ * The decompressed data is kept in a buffer holding the last chunk and the
+ * history the next matches can refer to. Seeking backwards past the buffer
+ * starts decompressing again from the beginning.
+ */
+class LzoReadStream : public Common::SeekableReadStream {
+public:
+	LzoReadStream(Common::MemoryReadStream *compressed, LzoBufferPool *pool);
+	~LzoReadStream() override;
+
+	// ReadStream API
+	bool eos() const override { return _eos; }
+	uint32 read(void *dataPtr, uint32 dataSize) override;
+
+	// SeekableReadStream API
+	int32 pos() const override { return _pos; }
+	int32 size() const override { return _size; }
+	bool seek(int32 offset, int whence = SEEK_SET) override;
+
+private:
+	void restart();
+	void decompressChunk();
+
+	Common::MemoryReadStream *_compressed;
+	LzoDecoder _decoder;
+
+	uint32 _size;
+	uint32 _pos;
+	bool _eos;
+
+	LzoBufferPool *_pool;
+	byte *_buffer;
+	uint32 _bufferCapacity;
+	/** The position of the first byte of the buffer in the decompressed data */
+	uint32 _bufferStart;
+	uint32 _bufferFill;
+};
+
+LzoReadStream::LzoReadStream(Common::MemoryReadStream *compressed, LzoBufferPool *pool) :
+		_compressed(compressed),
+		_decoder(compressed->getData() + 8, compressed->size() - 8),
+		_size(READ_LE_UINT32(compressed->getData() + 4)),
+		_pos(0),
+		_eos(false),
+		_pool(pool),
+		_buffer(nullptr),
+		_bufferCapacity(0) {
+	_buffer = takeBuffer(_pool, MIN(_size, kLzoHistorySize + kLzoChunkSize), _bufferCapacity);
+	restart();
+}
+
+LzoReadStream::~LzoReadStream() {
+	giveBackBuffer(_pool, _buffer, _bufferCapacity);
+	delete _compressed;
+}
+
+uint32 LzoReadStream::read(void *dataPtr, uint32 dataSize) {
+	byte *dst = (byte *)dataPtr;
+	uint32 total = 0;
+
+	while (total < dataSize) {
+		if (_pos >= _size) {
+			_eos = true;
+			break;
+		}
+
+		if (_pos < _bufferStart) {
+			restart();
+		}
+
+		uint32 bufferEnd = _bufferStart + _bufferFill;
+		if (_pos >= bufferEnd) {
+			decompressChunk();
+			continue;
+		}
+
+		uint32 count = MIN(dataSize - total, bufferEnd - _pos);
+		memcpy(dst + total, _buffer + (_pos - _bufferStart), count);
+		total += count;
+		_pos += count;
+	}
+
+	return total;
+}
+
+bool LzoReadStream::seek(int32 offset, int whence) {
+	int32 newPos;
+	switch (whence) {
+	case SEEK_END:
+		newPos = _size + offset;
+		break;
+	case SEEK_CUR:
+		newPos = _pos + offset;
+		break;
+	case SEEK_SET:
+	default:
+		newPos = offset;
+		break;
+	}
+
+	if (newPos < 0 || newPos > (int32)_size) {
+		return false;
+	}
+
+	// The data is decompressed when it is read
+	_pos = newPos;
+	_eos = false;
+	return true;
+}
+
+void LzoReadStream::restart() {
+	_bufferStart = 0;
+	_bufferFill = 0;
+	_decoder.reset();
+}
+
+void LzoReadStream::decompressChunk() {
+	if (_bufferFill == _bufferCapacity) {
+		// Keep the data the next matches can refer to
+		uint32 dropped = _bufferFill - kLzoHistorySize;
+		memmove(_buffer, _buffer + dropped, kLzoHistorySize);
+		_bufferStart += dropped;
+		_bufferFill = kLzoHistorySize;
+	}
+
+	// The matches can refer to the history kept at the start of the buffer
+	byte *out = _buffer + _bufferFill;
+	LzoResult result = _decoder.decompress(_buffer, out, _buffer + _bufferCapacity);
+	if (result != kLzoSuccess && result != kLzoOutputOverrun) {
+		error("Unable to decompress LZO data, result %d", result);
+	}
+
+	_bufferFill = out - _buffer;
+
+	if (result == kLzoSuccess && _bufferStart + _bufferFill != _size) {
+		error("Unable to decompress LZO data, expected %d bytes, got %d", _size, _bufferStart + _bufferFill);
+	}
+}
+
+Common::SeekableReadStream *createLzoReadStream(Common::MemoryReadStream *compressed, LzoBufferPool *pool) {
+	assert(compressed->size() >= 8);
+
+	const byte *data = compressed->getData();
+	uint32 size = READ_LE_UINT32(data + 4);
+
+	if (size > kLzoStreamingThreshold) {
+		return new LzoReadStream(compressed, pool);
+	}
+
+	uint32 capacity;
+	byte *buffer = takeBuffer(pool, size, capacity);
+
+	size_t written = 0;
+	LzoResult result = lzoDecompress(data + 8, compressed->size() - 8, buffer, size, written);
+	if (result != kLzoSuccess || written != size) {
+		error("Unable to decompress LZO data, result %d", result);
+	}
+
+	delete compressed;
+	return new PooledMemoryReadStream(pool, buffer, capacity, size);
+}
+
+} // End of namespace Myst3
@@ -0,0 +1,93 @@
+/* ResidualVM - A 3D game interpreter
+ *
+ * ResidualVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the AUTHORS
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MYST3_LZO_STREAM_H
+#define MYST3_LZO_STREAM_H
+
+#include "common/array.h"
+#include "common/mutex.h"
+#include "common/stream.h"
+
+namespace Common {
+class MemoryReadStream;
+}
+
+namespace Myst3 {
+
+/**
+ * Keeps the buffers of the decompressed resources, so that they can be
+ * reused by the next ones instead of going back to the allocator.
+ *
+ * The buffers can be given back from any thread. The pool is deleted once
+ * its owner has released it and all the buffers have been given back.
+ */
+class LzoBufferPool {
+public:
+	/**
+	 * @param maxFreeSize the total size of the unused buffers kept for reuse, in bytes
+	 */
+	LzoBufferPool(uint32 maxFreeSize);
+
+	/** Give up ownership of the pool */
+	void release();
+
+	/**
+	 * Get a buffer of at least size bytes
+	 *
+	 * @param capacity set to the actual size of the buffer
+	 */
+	byte *take(uint32 size, uint32 &capacity);
+
+	/** Give back a buffer obtained with take() */
+	void giveBack(byte *buffer, uint32 capacity);
+
+private:
+	~LzoBufferPool();
+
+	struct FreeBuffer {
+		byte *data;
+		uint32 capacity;
+	};
+
+	Common::Mutex _mutex;
+	Common::Array<FreeBuffer> _freeBuffers;
+	uint32 _freeSize;
+	uint32 _maxFreeSize;
+	uint _takenCount;
+	bool _released;
+};
+
+/**
+ * Create a stream decompressing a LZO1X compressed resource
+ *
+ * Small resources are decompressed at once into a buffer from the pool.
+ * The larger ones are decompressed in chunks as they are read.
+ *
+ * @param compressed the compressed data, starting with the 'LZOX' signature and
+ *                   the uncompressed size. The returned stream takes ownership.
+ * @param pool       the pool to take the buffers from, or nullptr to allocate them
+ */
+Common::SeekableReadStream *createLzoReadStream(Common::MemoryReadStream *compressed, LzoBufferPool *pool);
+
+} // End of namespace Myst3
+
+#endif
@@ -8,6 +8,7 @@ MODULE_OBJS := \
 	database.o \
 	detection.o \
 	effects.o \
+	face_cache.o \
 	gfx.o \
 	gfx_opengl.o \
 	gfx_opengl_shaders.o \
@@ -17,6 +18,7 @@ MODULE_OBJS := \
 	hotspot.o \
 	inventory.o \
 	lzo.o \
+	lzo_stream.o \
 	menu.o \
 	movie.o \
 	myst3.o \
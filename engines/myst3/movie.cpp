@@ -84,6 +84,8 @@ Movie::Movie(Myst3Engine *vm, const Common::String &room, uint16 id) :
 
 	_bink.setDefaultHighColorFormat(Texture::getRGBAPixelFormat());
 	_bink.setSoundType(Audio::Mixer::kSFXSoundType);
+	// Several movies can play at once, only keep a couple of frames ready for each
+	_bink.setDecodeAhead(2);
 
 	if (!_bink.loadStream(binkStream)) {
 		error("Invalid Bink video file '%s-%d'", room.c_str(), id);
@@ -39,6 +39,7 @@
 #include "engines/myst3/database.h"
 #include "engines/myst3/debug.h"
 #include "engines/myst3/effects.h"
+#include "engines/myst3/face_cache.h"
 #include "engines/myst3/myst3.h"
 #include "engines/myst3/resource_loader.h"
 #include "engines/myst3/node.h"
@@ -1007,6 +1008,39 @@ void Myst3Engine::loadNode(uint16 nodeID, uint32 roomID, uint32 ageID) {
 	// Releeshan to the player when he is trapped between both shields.
 	if (nodeID == 9 && roomID == kRoomNarayan)
 		_state->setVar(39, 0);
+
+	prefetchNeighbourNodes();
+}
+
+void Myst3Engine::prefetchNeighbourNodes() {
+	// Start decoding the nodes the hotspots of the current node lead to,
+	// so they are ready when the player clicks
+	static const uint kMaxPrefetchedNodes = 4;
+
+	FaceCache &faceCache = _resourceLoader->getFaceCache();
+	faceCache.cancelPrefetch();
+
+	if (_state->getViewType() == kMenu)
+		return;
+
+	NodePtr nodeData = _db->getNodeData(_state->getLocationNode(), _state->getLocationRoom(), _state->getLocationAge());
+	if (!nodeData)
+		return;
+
+	Common::Array<uint16> nodes;
+	for (uint i = 0; i < nodeData->hotspots.size(); i++) {
+		if (nodeData->hotspots[i].isEnabled(_state))
+			_scriptEngine->listTargetNodes(nodeData->hotspots[i].script, nodes);
+	}
+
+	uint prefetched = 0;
+	for (uint i = 0; i < nodes.size() && prefetched < kMaxPrefetchedNodes; i++) {
+		if (nodes[i] == _node->id())
+			continue;
+
+		faceCache.prefetchNode(_node->room(), nodes[i]);
+		prefetched++;
+	}
 }
 
 void Myst3Engine::unloadNode() {
@@ -1486,20 +1520,22 @@ bool Myst3Engine::hasNodeSubtitlesToDraw() {
 Graphics::Surface Myst3Engine::decodeJpeg(const ResourceDescription &jpegDesc) {
 	Common::SeekableReadStream *jpegStream = jpegDesc.createReadStream();
 
+	Graphics::Surface rgbaSurface;
+	decodeJpeg(*jpegStream, rgbaSurface);
+	delete jpegStream;
+
+	return rgbaSurface;
+}
+
+void Myst3Engine::decodeJpeg(Common::SeekableReadStream &jpegStream, Graphics::Surface &surface) {
 	Image::JPEGDecoder jpeg;
 	jpeg.setOutputPixelFormat(Texture::getRGBAPixelFormat());
 
-	if (!jpeg.loadStream(*jpegStream))
+	// Decode straight into the caller's surface, there is no copy to make
+	if (!jpeg.loadStreamInto(jpegStream, surface))
 		error("Could not decode Myst III JPEG");
-	delete jpegStream;
 
-	const Graphics::Surface *bitmap = jpeg.getSurface();
-	assert(bitmap->format == Texture::getRGBAPixelFormat());
-
-	// JPEGDecoder owns the decoded surface, we have to make a copy...
-	Graphics::Surface rgbaSurface;
-	rgbaSurface.copyFrom(*bitmap);
-	return rgbaSurface;
+	assert(surface.format == Texture::getRGBAPixelFormat());
 }
 
 int16 Myst3Engine::openDialog(uint16 id) {
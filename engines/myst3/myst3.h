@@ -40,6 +40,7 @@ struct Surface;
 
 namespace Common {
 struct Event;
+class SeekableReadStream;
 }
 
 namespace Myst3 {
@@ -133,6 +134,7 @@ public:
 	Common::Error saveGameState(const Common::String &desc, const Graphics::Surface *thumbnail);
 
 	static Graphics::Surface decodeJpeg(const ResourceDescription &jpegDesc);
+	static void decodeJpeg(Common::SeekableReadStream &jpegStream, Graphics::Surface &surface);
 
 	void goToNode(uint16 nodeID, TransitionType transition);
 	void loadNode(uint16 nodeID, uint32 roomID = 0, uint32 ageID = 0);
@@ -140,6 +142,7 @@ public:
 	void loadNodeCubeFaces(uint16 nodeID);
 	void loadNodeFrame(uint16 nodeID);
 	void loadNodeMenu(uint16 nodeID);
+	void prefetchNeighbourNodes();
 
 	void setupTransition();
 	void drawTransition(TransitionType transitionType);
@@ -23,6 +23,7 @@
 #include "engines/myst3/node_software.h"
 
 #include "engines/myst3/effects.h"
+#include "engines/myst3/face_cache.h"
 #include "engines/myst3/myst3.h"
 #include "engines/myst3/node.h"
 #include "engines/myst3/resource_loader.h"
@@ -37,20 +38,14 @@ NodeSoftwareRenderer::NodeSoftwareRenderer(Node &node, Layout &layout, Renderer
 		_gfx(gfx),
 		_state(state),
 		_resourceLoader(resourceLoader) {
-	_faces.resize(_node.type() == Node::kCube ? 6 : 1);
+	Common::Array<Graphics::Surface> bitmaps;
+	resourceLoader.getFaceCache().getNodeFaces(_node.room(), _node.id(), _node.type(), bitmaps);
+
+	_faces.resize(bitmaps.size());
 	for (uint faceId = 0; faceId < _faces.size(); faceId++) {
 		Face &face = _faces[faceId];
 
-		Graphics::Surface bitmap;
-		if (_node.type() == Node::kCube)  {
-			ResourceDescription resource = resourceLoader.getCubeBitmap(_node.room(), _node.id(), faceId);
-			bitmap = Myst3Engine::decodeJpeg(resource);
-		} else {
-			ResourceDescription resource = resourceLoader.getFrameBitmap(_node.room(), _node.id());
-			bitmap = Myst3Engine::decodeJpeg(resource);
-		}
-
-		face.bitmap  = bitmap;
+		face.bitmap  = bitmaps[faceId];
 		face.texture = _gfx.createTexture(face.bitmap);
 
 		addFaceTextureDirtyRect(face, Common::Rect(face.bitmap.w, face.bitmap.h));
@@ -60,9 +55,11 @@ NodeSoftwareRenderer::NodeSoftwareRenderer(Node &node, Layout &layout, Renderer
 NodeSoftwareRenderer::~NodeSoftwareRenderer() {
 	for (uint i = 0; i < _faces.size(); i++) {
 		delete _faces[i].texture;
-		_faces[i].bitmap.free();
+		if (_faces[i].bitmapCopied)
+			_faces[i].bitmap.free();
 		_faces[i].finalBitmap.free();
 	}
+	_resourceLoader.getFaceCache().releaseNodeFaces(_node.room(), _node.id(), _node.type());
 
 	for (uint i = 0; i < _spotItemImages.size(); i++) {
 		_spotItemImages[i].drawBitmap.free();
@@ -71,6 +68,8 @@ NodeSoftwareRenderer::~NodeSoftwareRenderer() {
 }
 
 void NodeSoftwareRenderer::drawSpotItemImage(SpotItemImage &spotItemImage, Face &face) {
+	copyFaceBitmap(face);
+
 	Common::Rect faceRect = spotItemImage.getFaceRect();
 
 	Graphics::Surface &faceBitmap = face.bitmap;
@@ -86,6 +85,8 @@ void NodeSoftwareRenderer::drawSpotItemImage(SpotItemImage &spotItemImage, Face
 }
 
 void NodeSoftwareRenderer::undrawSpotItemImage(SpotItemImage &spotItemImage, Face &face) {
+	copyFaceBitmap(face);
+
 	Common::Rect faceRect = spotItemImage.getFaceRect();
 
 	Graphics::Surface &faceBitmap = face.bitmap;
@@ -100,6 +101,8 @@ void NodeSoftwareRenderer::undrawSpotItemImage(SpotItemImage &spotItemImage, Fac
 }
 
 void NodeSoftwareRenderer::fadeDrawSpotItemImage(SpotItemImage &spotItemImage, Face &face, uint16 fadeValue) {
+	copyFaceBitmap(face);
+
 	Common::Rect faceRect = spotItemImage.getFaceRect();
 
 	const Graphics::Surface &spotItemDrawBitmap = spotItemImage.drawBitmap;
@@ -214,6 +217,17 @@ bool NodeSoftwareRenderer::isFaceVisible(uint faceId) {
 	return false;
 }
 
+void NodeSoftwareRenderer::copyFaceBitmap(Face &face) {
+	if (face.bitmapCopied)
+		return;
+
+	// The bitmap from the face cache is shared, spot items are drawn onto a copy
+	Graphics::Surface bitmap;
+	bitmap.copyFrom(face.bitmap);
+	face.bitmap = bitmap;
+	face.bitmapCopied = true;
+}
+
 void NodeSoftwareRenderer::addFaceTextureDirtyRect(Face &face, const Common::Rect &rect) {
 	if (!face.textureDirty) {
 		face.textureDirtyRect = rect;
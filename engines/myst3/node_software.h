@@ -50,14 +50,16 @@ public:
 
 private:
 	struct Face {
+		/** The face cache's bitmap, until a spot item is drawn and it gets copied */
 		Graphics::Surface bitmap;
+		bool bitmapCopied;
 		Graphics::Surface finalBitmap;
 
 		Texture *texture;
 		bool textureDirty;
 		Common::Rect textureDirtyRect;
 
-		Face() : texture(nullptr), textureDirty(false) {}
+		Face() : bitmapCopied(false), texture(nullptr), textureDirty(false) {}
 	};
 
 	struct SpotItemImage {
@@ -97,6 +99,7 @@ private:
 
 	bool isFaceVisible(uint faceId);
 
+	void copyFaceBitmap(Face &face);
 	void addFaceTextureDirtyRect(Face &face, const Common::Rect &rect);
 	void uploadFaceTexture(Face &face);
 
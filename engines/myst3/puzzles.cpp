@@ -1511,9 +1511,11 @@ void Puzzles::mainMenu(uint16 action) {
 	_vm->setMenuAction(action);
 }
 
-static void copySurfaceRect(Graphics::Surface *dest, const Common::Point &destPoint, const Graphics::Surface *src) {
-	for (uint16 i = 0; i < src->h; i++)
-		memcpy(dest->getBasePtr(destPoint.x, i + destPoint.y), src->getBasePtr(0, i), src->pitch);
+static void decodeFrameToRect(Video::BinkDecoder &bink, Graphics::Surface *dest, const Common::Point &destPoint) {
+	// The frame is decoded straight into the destination surface
+	Common::Rect rect(destPoint.x, destPoint.y, destPoint.x + bink.getWidth(), destPoint.y + bink.getHeight());
+	Graphics::Surface area = dest->getSubArea(rect);
+	bink.decodeNextFrameInto(area);
 }
 
 void Puzzles::projectorLoadBitmap(uint16 bitmap) {
@@ -1540,8 +1542,7 @@ void Puzzles::projectorLoadBitmap(uint16 bitmap) {
 
 	for (uint i = 0; i < 1024; i += 256) {
 		for (uint j = 0; j < 1024; j += 256) {
-			const Graphics::Surface *frame = bink.decodeNextFrame();
-			copySurfaceRect(_vm->_projectorBackground, Common::Point(j, i), frame);
+			decodeFrameToRect(bink, _vm->_projectorBackground, Common::Point(j, i));
 		}
 	}
 }
@@ -1568,8 +1569,7 @@ void Puzzles::projectorAddSpotItem(uint16 bitmap, uint16 x, uint16 y) {
 
 	bink.start();
 
-	const Graphics::Surface *frame = bink.decodeNextFrame();
-	copySurfaceRect(_vm->_projectorBackground, Common::Point(x, y), frame);
+	decodeFrameToRect(bink, _vm->_projectorBackground, Common::Point(x, y));
 }
 
 void Puzzles::projectorUpdateCoordinates() {
@@ -24,7 +24,9 @@
 
 #include "engines/myst3/archive.h"
 #include "engines/myst3/debug.h"
+#include "engines/myst3/face_cache.h"
 #include "engines/myst3/gfx.h"
+#include "engines/myst3/lzo_stream.h"
 
 #include "common/archive.h"
 #include "common/config-manager.h"
@@ -37,12 +39,25 @@
 
 namespace Myst3 {
 
+// The total size of the decompression buffers kept for reuse
+static const uint32 kDecompressionPoolSize = 4 * 1024 * 1024;
+
+ResourceLoader::ResourceLoader() {
+	_bufferPool = new LzoBufferPool(kDecompressionPoolSize);
+	_faceCache = new FaceCache(*this);
+}
+
 ResourceLoader::~ResourceLoader() {
+	delete _faceCache;
+
 	unloadRoomArchives();
 
 	for (uint i = 0; i < _commonArchives.size(); i++) {
 		delete _commonArchives[i];
 	}
+
+	// The pool stays until the streams still using its buffers are deleted
+	_bufferPool->release();
 }
 
 void ResourceLoader::addMod(const Common::String &name) {
@@ -53,14 +68,14 @@ void ResourceLoader::addMod(const Common::String &name) {
 void ResourceLoader::addArchive(const Common::String &filename, bool mandatory) {
 	for (uint i = 0; i < _mods.size(); i++) {
 		Common::String modFilename = Common::String::format("mods/%s/%s.patch", _mods[i].c_str(), filename.c_str());
-		Archive *modArchive = Archive::createFromFile(modFilename, "");
+		Archive *modArchive = Archive::createFromFile(modFilename, "", _bufferPool);
 		if (modArchive) {
 			_commonArchives.push_back(modArchive);
 			debugC(kDebugModding, "Loaded mod archive '%s'", modFilename.c_str());
 		}
 	}
 
-	Archive *archive = Archive::createFromFile(filename, "");
+	Archive *archive = Archive::createFromFile(filename, "", _bufferPool);
 	if (archive) {
 		_commonArchives.push_back(archive);
 		return;
@@ -84,7 +99,7 @@ void ResourceLoader::loadRoomArchives(const Common::String &room) {
 
 	for (uint i = 0; i < _mods.size(); i++) {
 		Common::String modNodeFile = Common::String::format("mods/%s/%snodes.m3a.patch", _mods[i].c_str(), room.c_str());
-		Archive *modNodeArchive = Archive::createFromFile(modNodeFile, room);
+		Archive *modNodeArchive = Archive::createFromFile(modNodeFile, room, _bufferPool);
 		if (modNodeArchive) {
 			_roomArchives.push_back(modNodeArchive);
 			debugC(kDebugModding, "Loaded mod archive '%s'", modNodeFile.c_str());
@@ -92,7 +107,7 @@ void ResourceLoader::loadRoomArchives(const Common::String &room) {
 	}
 
 	Common::String roomFile = Common::String::format("%snodes.m3a", room.c_str());
-	Archive *roomArchive = Archive::createFromFile(roomFile, room);
+	Archive *roomArchive = Archive::createFromFile(roomFile, room, _bufferPool);
 	if (!roomArchive) {
 		error("Unable to open archive %s", roomFile.c_str());
 	}
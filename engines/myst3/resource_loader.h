@@ -33,11 +33,14 @@
 
 namespace Myst3 {
 
+class FaceCache;
+class LzoBufferPool;
 class Renderer;
 class Texture;
 
 class ResourceLoader {
 public:
+	ResourceLoader();
 	~ResourceLoader();
 
 	void addMod(const Common::String &name);
@@ -59,6 +62,9 @@ public:
 	ResourceDescription getRawData(const Common::String &room, uint16 id) const;
 	ResourceDescriptionArray listSpotItemImages(const Common::String &room, uint16 spotItemId) const;
 
+	/** The decoded bitmaps of the recently visited nodes */
+	FaceCache &getFaceCache() { return *_faceCache; }
+
 	static Common::String computeExtractedFileName(const Archive::DirectoryEntry &directoryEntry,
 	                                               const Archive::DirectorySubEntry &directorySubEntry);
 	static Common::String computeExtractedFileName(const Archive::DirectoryEntry &directoryEntry,
@@ -74,6 +80,10 @@ private:
 
 	Common::String _currentRoom;
 	Common::Array<Archive *> _roomArchives;
+
+	/** The buffers the compressed resources are decompressed to */
+	LzoBufferPool *_bufferPool;
+	FaceCache *_faceCache;
 };
 
 class TexDecoder {
@@ -34,6 +34,7 @@
 #include "engines/myst3/sound.h"
 #include "engines/myst3/state.h"
 
+#include "common/algorithm.h"
 #include "common/events.h"
 
 namespace Myst3 {
@@ -382,6 +383,31 @@ const Common::String Script::describeOpcode(const Opcode &opcode) {
 	return d;
 }
 
+void Script::listTargetNodes(const Common::Array<Opcode> &script, Common::Array<uint16> &nodes) {
+	for (uint i = 0; i < script.size(); i++) {
+		const Opcode &cmd = script[i];
+
+		switch (cmd.op) {
+		case 136: // goToNodeTransition
+		case 137: // goToNodeTrans2
+		case 138: // goToNodeTrans1
+		case 140: // zipToNode
+		case 151: // moviePlayChangeNode
+		case 152: // moviePlayChangeNodeTrans
+		case 164: // changeNode
+			if (!cmd.args.empty()) {
+				uint16 nodeId = _vm->_state->valueOrVarValue(cmd.args[0]);
+				if (nodeId && Common::find(nodes.begin(), nodes.end(), nodeId) == nodes.end()) {
+					nodes.push_back(nodeId);
+				}
+			}
+			break;
+		default:
+			break;
+		}
+	}
+}
+
 const Common::String Script::describeArgument(char type, int16 value) {
 	switch (type) {
 	case kVar:
@@ -43,6 +43,13 @@ public:
 
 	const Common::String describeOpcode(const Opcode &opcode);
 
+	/**
+	 * List the nodes of the current room a script can move the player to
+	 *
+	 * The variables used as node ids are read with their current value.
+	 */
+	void listTargetNodes(const Common::Array<Opcode> &script, Common::Array<uint16> &nodes);
+
 private:
 	struct Context {
 		bool endScript;
@@ -95,6 +95,11 @@ Common::String XARCMember::readString(Common::ReadStream &stream) {
 
 // ARCHIVE
 
+XARCArchive::~XARCArchive() {
+	// The sounds being played may still have views of the mapping
+	Common::MemoryReadStreamView::releaseParent(_mapping);
+}
+
 bool XARCArchive::open(const Common::String &filename) {
 	Common::File stream;
 	if (!stream.open(filename)) {
@@ -126,6 +131,9 @@ bool XARCArchive::open(const Common::String &filename) {
 		offset += member->getLength();
 	}
 
+	// Read the members in place when the file can be mapped into memory
+	_mapping = Common::SharedPtr<Common::MemoryReadStream>(SearchMan.createMappedReadStreamForMember(filename));
+
 	return true;
 }
 
@@ -193,7 +201,16 @@ Common::SeekableReadStream *XARCArchive::createReadStreamForMember(const Common:
 	return 0;
 }
 
+void XARCArchive::setData(byte *data, uint32 size) {
+	assert(!_mapping);
+	_mapping = Common::SharedPtr<Common::MemoryReadStream>(new Common::MemoryReadStream(data, size, DisposeAfterUse::YES));
+}
+
 Common::SeekableReadStream *XARCArchive::createReadStreamForMember(const XARCMember *member) const {
+	if (_mapping && member->getOffset() + member->getLength() <= (uint32)_mapping->size()) {
+		return new Common::MemoryReadStreamView(_mapping, member->getOffset(), member->getLength());
+	}
+
 	// Open the xarc file
 	Common::File *f = new Common::File;
 	if (!f)
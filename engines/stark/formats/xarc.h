@@ -24,6 +24,7 @@
 #define STARK_ARCHIVE_H
 
 #include "common/archive.h"
+#include "common/memstream.h"
 #include "common/stream.h"
 
 namespace Stark {
@@ -33,6 +34,8 @@ class XARCMember;
 
 class XARCArchive : public Common::Archive {
 public:
+	~XARCArchive();
+
 	bool open(const Common::String &filename);
 	Common::String getFilename() const;
 
@@ -45,9 +48,16 @@ public:
 
 	Common::SeekableReadStream *createReadStreamForMember(const XARCMember *member) const;
 
+	/** The archive file mapped or copied into memory, if any */
+	const Common::MemoryReadStream *getData() const { return _mapping.get(); }
+
+	/** Read the members from a copy of the archive file in memory, when it could not be mapped */
+	void setData(byte *data, uint32 size);
+
 private:
 	Common::String _filename;
 	Common::ArchiveMemberList _members;
+	Common::SharedPtr<Common::MemoryReadStream> _mapping;
 };
 
 } // End of namespace Formats
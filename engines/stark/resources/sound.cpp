@@ -23,6 +23,7 @@
 #include "engines/stark/resources/sound.h"
 
 #include "audio/decoders/vorbis.h"
+#include "audio/pcmcache.h"
 
 #include "common/system.h"
 
@@ -64,6 +65,16 @@ Audio::RewindableAudioStream *Sound::makeAudioStream() {
 	Common::SeekableReadStream *stream = nullptr;
 	Audio::RewindableAudioStream *audioStream = nullptr;
 
+	// Sound effects are short and replayed often, keep them decoded
+	Common::String cacheKey;
+	if (_soundType == kSoundTypeEffect) {
+		cacheKey = _archiveName + "/" + _filename;
+		audioStream = PCMCacheMan.find(cacheKey);
+		if (audioStream) {
+			return audioStream;
+		}
+	}
+
 	// First try the .iss / isn files
 	if (_loadFromFile) {
 		stream = StarkArchiveLoader->getExternalFile(_filename, _archiveName);
@@ -95,6 +106,8 @@ Audio::RewindableAudioStream *Sound::makeAudioStream() {
 
 	if (!audioStream) {
 		warning("Unable to load sound '%s'", _filename.c_str());
+	} else if (!cacheKey.empty()) {
+		audioStream = PCMCacheMan.add(cacheKey, audioStream);
 	}
 
 	return audioStream;
@@ -26,14 +26,29 @@
 #include "engines/stark/resources/level.h"
 #include "engines/stark/resources/location.h"
 
+#include "common/file.h"
+#include "common/system.h"
+#include "common/timer.h"
+
 namespace Stark {
 
-ArchiveLoader::LoadedArchive::LoadedArchive(const Common::String& archiveName) :
+// How many prefetched but not yet loaded archives are kept around.
+static const uint kMaxPrefetchedArchives = 8;
+// How often the prefetcher reads a chunk of the queued archives, in microseconds.
+static const int32 kPrefetchInterval = 10000;
+// How much the prefetcher reads at a time, in bytes.
+static const uint32 kPrefetchChunkSize = 256 * 1024;
+
+ArchiveLoader::LoadedArchive::LoadedArchive(const Common::String& archiveName, Formats::XARCArchive *xarc) :
 		_filename(archiveName),
+		_xarc(xarc),
 		_root(nullptr),
 		_useCount(0) {
-	if (!_xarc.open(archiveName)) {
-		error("Unable to open archive '%s'", archiveName.c_str());
+	if (!_xarc) {
+		_xarc = new Formats::XARCArchive();
+		if (!_xarc->open(archiveName)) {
+			error("Unable to open archive '%s'", archiveName.c_str());
+		}
 	}
 }
 
@@ -42,14 +57,22 @@ ArchiveLoader::LoadedArchive::~LoadedArchive() {
 	_root->onPreDestroy();
 
 	delete _root;
+	delete _xarc;
 }
 
 void ArchiveLoader::LoadedArchive::importResources() {
 	// Import the resource tree
-	_root = Formats::XRCReader::importTree(&_xarc);
+	_root = Formats::XRCReader::importTree(_xarc);
+}
+
+ArchiveLoader::ArchiveLoader() {
+	g_system->getTimerManager()->installTimerProc(prefetchHandler, kPrefetchInterval, this, "starkArchivePrefetch");
 }
 
 ArchiveLoader::~ArchiveLoader() {
+	g_system->getTimerManager()->removeTimerProc(prefetchHandler);
+	freePrefetchedArchives();
+
 	for (LoadedArchiveList::iterator it = _archives.begin(); it != _archives.end(); it++) {
 		delete *it;
 	}
@@ -61,7 +84,7 @@ bool ArchiveLoader::load(const Common::String &archiveName) {
 		return false;
 	}
 
-	LoadedArchive *archive = new LoadedArchive(archiveName);
+	LoadedArchive *archive = new LoadedArchive(archiveName, takePrefetchedArchive(archiveName));
 	_archives.push_back(archive);
 
 	archive->importResources();
@@ -69,16 +92,169 @@ bool ArchiveLoader::load(const Common::String &archiveName) {
 	return true;
 }
 
-void ArchiveLoader::unloadUnused() {
-	for (LoadedArchiveList::iterator it = _archives.begin(); it != _archives.end(); it++) {
-		if (!(*it)->isInUse()) {
-			delete *it;
-			it = _archives.erase(it);
+void ArchiveLoader::unloadUnused(uint keepCount) {
+	// The most recently returned archives are at the end of the list
+	uint kept = 0;
+	for (LoadedArchiveList::iterator it = _archives.reverse_begin(); it != _archives.end(); ) {
+		if ((*it)->isInUse() || kept < keepCount) {
+			if (!(*it)->isInUse()) {
+				kept++;
+			}
 			it--;
+		} else {
+			delete *it;
+			it = _archives.reverse_erase(it);
+		}
+	}
+}
+
+void ArchiveLoader::prefetch(const Common::String &archiveName) {
+	if (hasArchive(archiveName)) {
+		return;
+	}
+
+	{
+		Common::StackLock lock(_prefetchMutex);
+		for (PrefetchedArchiveList::iterator it = _prefetchedArchives.begin(); it != _prefetchedArchives.end(); it++) {
+			if (it->filename == archiveName) {
+				return;
+			}
+		}
+	}
+
+	// The files are looked up here, as SearchMan is not thread safe.
+	// Only reading the data is left to the prefetcher.
+	PrefetchedArchive prefetched;
+	prefetched.filename = archiveName;
+	prefetched.xarc = new Formats::XARCArchive();
+	prefetched.file = nullptr;
+	prefetched.data = nullptr;
+	prefetched.position = 0;
+
+	if (!prefetched.xarc->open(archiveName)) {
+		delete prefetched.xarc;
+		return;
+	}
+
+	const Common::MemoryReadStream *mapping = prefetched.xarc->getData();
+	if (mapping) {
+		prefetched.size = mapping->size();
+	} else {
+		Common::File *file = new Common::File();
+		if (!file->open(archiveName)) {
+			delete file;
+			delete prefetched.xarc;
+			return;
+		}
+
+		prefetched.file = file;
+		prefetched.size = file->size();
+		prefetched.data = (byte *)malloc(prefetched.size);
+	}
+
+	PrefetchedArchive evicted;
+	evicted.xarc = nullptr;
+	{
+		Common::StackLock lock(_prefetchMutex);
+		if (_prefetchedArchives.size() >= kMaxPrefetchedArchives) {
+			evicted = _prefetchedArchives.front();
+			_prefetchedArchives.pop_front();
+		}
+		_prefetchedArchives.push_back(prefetched);
+	}
+
+	if (evicted.xarc) {
+		freePrefetchedArchive(evicted);
+	}
+}
+
+void ArchiveLoader::prefetchHandler(void *refCon) {
+	ArchiveLoader *archiveLoader = (ArchiveLoader *)refCon;
+	archiveLoader->processPrefetchQueue();
+}
+
+void ArchiveLoader::processPrefetchQueue() {
+	// The resource trees are not thread safe, so they are still imported when the
+	// archive is loaded, but the data is then already in memory.
+	Common::StackLock lock(_prefetchMutex);
+	for (PrefetchedArchiveList::iterator it = _prefetchedArchives.begin(); it != _prefetchedArchives.end(); it++) {
+		if (it->position < it->size) {
+			readPrefetchedChunk(*it, kPrefetchChunkSize);
+			return;
 		}
 	}
 }
 
+void ArchiveLoader::readPrefetchedChunk(PrefetchedArchive &prefetched, uint32 size) {
+	uint32 end = prefetched.position + MIN(size, prefetched.size - prefetched.position);
+
+	if (prefetched.file) {
+		uint32 read = prefetched.file->read(prefetched.data + prefetched.position, end - prefetched.position);
+		if (read < end - prefetched.position) {
+			// The members past the end of the copy are read from the file instead
+			end = prefetched.position + read;
+			prefetched.size = end;
+		}
+	} else {
+		// Touch every page of the chunk, so that the system reads the mapping from the disk
+		const byte *data = prefetched.xarc->getData()->getData();
+		volatile byte touched = 0;
+		for (uint32 i = prefetched.position; i < end; i += 4096) {
+			touched += data[i];
+		}
+	}
+
+	prefetched.position = end;
+	if (prefetched.position == prefetched.size) {
+		delete prefetched.file;
+		prefetched.file = nullptr;
+	}
+}
+
+Formats::XARCArchive *ArchiveLoader::takePrefetchedArchive(const Common::String &archiveName) {
+	PrefetchedArchive prefetched;
+	prefetched.xarc = nullptr;
+	{
+		Common::StackLock lock(_prefetchMutex);
+		for (PrefetchedArchiveList::iterator it = _prefetchedArchives.begin(); it != _prefetchedArchives.end(); it++) {
+			if (it->filename == archiveName) {
+				prefetched = *it;
+				_prefetchedArchives.erase(it);
+				break;
+			}
+		}
+	}
+
+	if (!prefetched.xarc) {
+		return nullptr;
+	}
+
+	// Finish reading the copy of the archive, what the prefetcher read is not read again
+	if (prefetched.file) {
+		readPrefetchedChunk(prefetched, prefetched.size - prefetched.position);
+	}
+
+	if (prefetched.data) {
+		prefetched.xarc->setData(prefetched.data, prefetched.size);
+	}
+
+	return prefetched.xarc;
+}
+
+void ArchiveLoader::freePrefetchedArchive(PrefetchedArchive &prefetched) {
+	delete prefetched.file;
+	free(prefetched.data);
+	delete prefetched.xarc;
+}
+
+void ArchiveLoader::freePrefetchedArchives() {
+	Common::StackLock lock(_prefetchMutex);
+	for (PrefetchedArchiveList::iterator it = _prefetchedArchives.begin(); it != _prefetchedArchives.end(); it++) {
+		freePrefetchedArchive(*it);
+	}
+	_prefetchedArchives.clear();
+}
+
 ArchiveReadStream *ArchiveLoader::getFile(const Common::String &fileName, const Common::String &archiveName) {
 	LoadedArchive *archive = findArchive(archiveName);
 	const Formats::XARCArchive &xarc = archive->getXArc();
@@ -95,7 +271,15 @@ bool ArchiveLoader::returnRoot(const Common::String &archiveName) {
 	LoadedArchive *archive = findArchive(archiveName);
 	archive->decUsage();
 
-	return !archive->isInUse();
+	if (archive->isInUse()) {
+		return false;
+	}
+
+	// Keep the unused archives in the order they were returned, for unloadUnused
+	_archives.remove(archive);
+	_archives.push_back(archive);
+
+	return true;
 }
 
 bool ArchiveLoader::hasArchive(const Common::String &archiveName) const {
@@ -133,12 +317,16 @@ Common::String ArchiveLoader::buildArchiveName(Resources::Level *level, Resource
 			error("Unknown level type %d", level->getSubType());
 		}
 	} else {
-		archive = Common::String::format("%02x/%02x/%02x.xarc", level->getIndex(), location->getIndex(), location->getIndex());
+		archive = buildArchiveName(level->getIndex(), location->getIndex());
 	}
 
 	return archive;
 }
 
+Common::String ArchiveLoader::buildArchiveName(uint16 levelIndex, uint16 locationIndex) const {
+	return Common::String::format("%02x/%02x/%02x.xarc", levelIndex, locationIndex, locationIndex);
+}
+
 Common::String ArchiveLoader::getExternalFilePath(const Common::String &fileName, const Common::String &archiveName) const {
 	static const char separator = '/';
 
@@ -24,6 +24,7 @@
 #define STARK_SERVICES_ARCHIVE_LOADER_H
 
 #include "common/list.h"
+#include "common/mutex.h"
 #include "common/str.h"
 #include "common/substream.h"
 #include "common/util.h"
@@ -65,13 +66,25 @@ public:
 class ArchiveLoader {
 
 public:
+	ArchiveLoader();
 	~ArchiveLoader();
 
 	/** Load a Xarc archive, and add it to the managed archives list */
 	bool load(const Common::String &archiveName);
 
-	/** Unload all the unused Xarc archives */
-	void unloadUnused();
+	/**
+	 * Unload the unused Xarc archives
+	 *
+	 * The keepCount archives which were used most recently are kept loaded,
+	 * so that going back to a location does not need to load it again.
+	 */
+	void unloadUnused(uint keepCount = 0);
+
+	/**
+	 * Open a Xarc archive, and queue it to be read into memory by the background
+	 * prefetcher, so that loading it later does not have to wait for the disk
+	 */
+	void prefetch(const Common::String &archiveName);
 
 	/** Retrieve a file from a specified archive */
 	ArchiveReadStream *getFile(const Common::String &fileName, const Common::String &archiveName);
@@ -86,6 +99,9 @@ public:
 	/** Build the archive filename for a level or a location */
 	Common::String buildArchiveName(Resources::Level *level, Resources::Location *location = nullptr) const;
 
+	/** Build the archive filename for a location from its level and location indices */
+	Common::String buildArchiveName(uint16 levelIndex, uint16 locationIndex) const;
+
 	/** Retrieve a file relative to a specified archive */
 	Common::SeekableReadStream *getExternalFile(const Common::String &fileName, const Common::String &archiveName) const;
 	Common::String getExternalFilePath(const Common::String &fileName, const Common::String &archiveName) const;
@@ -93,11 +109,11 @@ public:
 private:
 	class LoadedArchive {
 	public:
-		explicit LoadedArchive(const Common::String &archiveName);
+		LoadedArchive(const Common::String &archiveName, Formats::XARCArchive *xarc);
 		~LoadedArchive();
 
 		const Common::String &getFilename() const { return _filename; }
-		const Formats::XARCArchive &getXArc() const { return _xarc; }
+		const Formats::XARCArchive &getXArc() const { return *_xarc; }
 		Resources::Object *getRoot() const { return _root; }
 
 		void importResources();
@@ -109,16 +125,42 @@ private:
 	private:
 		uint _useCount;
 		Common::String _filename;
-		Formats::XARCArchive _xarc;
+		Formats::XARCArchive *_xarc;
 		Resources::Object *_root;
 	};
 
+	struct PrefetchedArchive {
+		Common::String filename;
+		Formats::XARCArchive *xarc;
+		// The archive file and the copy of it being read, when it could not be mapped
+		Common::SeekableReadStream *file;
+		byte *data;
+		uint32 size;
+		// How much of the archive has been read so far
+		uint32 position;
+	};
+
 	typedef Common::List<LoadedArchive *> LoadedArchiveList;
+	typedef Common::List<PrefetchedArchive> PrefetchedArchiveList;
 
 	bool hasArchive(const Common::String &archiveName) const;
 	LoadedArchive *findArchive(const Common::String &archiveName) const;
 
+	static void prefetchHandler(void *refCon);
+	void processPrefetchQueue();
+	Formats::XARCArchive *takePrefetchedArchive(const Common::String &archiveName);
+	static void readPrefetchedChunk(PrefetchedArchive &prefetched, uint32 size);
+	static void freePrefetchedArchive(PrefetchedArchive &prefetched);
+	void freePrefetchedArchives();
+
+	// Loaded archives, the ones which are not in use anymore are moved to the end
 	LoadedArchiveList _archives;
+
+	// The archives are read in the order they were prefetched
+	PrefetchedArchiveList _prefetchedArchives;
+	// Guards the prefetched archives, which are read by the prefetch timer callback.
+	// The callback reads a bounded chunk at a time with it held.
+	Common::Mutex _prefetchMutex;
 };
 
 template <class T>
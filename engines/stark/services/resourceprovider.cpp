@@ -24,6 +24,7 @@
 
 #include "engines/stark/resources/bookmark.h"
 #include "engines/stark/resources/camera.h"
+#include "engines/stark/resources/command.h"
 #include "engines/stark/resources/floor.h"
 #include "engines/stark/resources/item.h"
 #include "engines/stark/resources/knowledgeset.h"
@@ -255,6 +256,7 @@ void ResourceProvider::performLocationChange() {
 
 	current->getLocation()->resetAnimationBlending();
 	purgeOldLocations();
+	prefetchLocationExits(current->getLocation());
 
 	_locationChangeRequest = false;
 }
@@ -330,7 +332,35 @@ void ResourceProvider::purgeOldLocations() {
 		_locations.pop_front();
 	}
 
-	_archiveLoader->unloadUnused();
+	// Keep a few of the released archives, going back to a location
+	// visited recently does not need to read and parse it again
+	_archiveLoader->unloadUnused(kWarmArchiveCount);
+}
+
+void ResourceProvider::prefetchLocationExits(Resources::Location *location) {
+	Resources::Root *root = _global->getRoot();
+
+	Common::Array<Resources::Command *> commands = location->listChildrenRecursive<Resources::Command>();
+	for (uint i = 0; i < commands.size(); i++) {
+		uint32 subType = commands[i]->getSubType();
+		if (subType != Resources::Command::kLocationGoTo
+		        && subType != Resources::Command::kLocationGoToNewCD
+		        && subType != Resources::Command::kGoto2DLocation) {
+			continue;
+		}
+
+		Common::Array<Resources::Command::Argument> arguments = commands[i]->getArguments();
+		uint levelIndex = strtol(arguments[0].stringValue.c_str(), nullptr, 16);
+		uint locationIndex = strtol(arguments[1].stringValue.c_str(), nullptr, 16);
+
+		Resources::Level *level = root->findChildWithIndex<Resources::Level>(levelIndex);
+		if (!level) {
+			continue;
+		}
+
+		_archiveLoader->prefetch(_archiveLoader->buildArchiveName(level));
+		_archiveLoader->prefetch(_archiveLoader->buildArchiveName(levelIndex, locationIndex));
+	}
 }
 
 void ResourceProvider::commitActiveLocationsState() {
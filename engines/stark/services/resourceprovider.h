@@ -48,6 +48,9 @@ class StateProvider;
  */
 class ResourceProvider {
 public:
+	/** How many released archives are kept loaded when changing locations */
+	static const uint kWarmArchiveCount = 4;
+
 	ResourceProvider(ArchiveLoader *archiveLoader, StateProvider *stateProvider, Global *global);
 
 	/** Load the global archives and fill the global object */
@@ -112,6 +115,7 @@ private:
 	Current *findLocation(uint16 level, uint16 location) const;
 
 	void purgeOldLocations();
+	void prefetchLocationExits(Resources::Location *location);
 
 	void runLocationChangeScripts(Resources::Object *resource, uint32 scriptCallMode);
 	void setAprilInitialPosition();
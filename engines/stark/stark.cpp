@@ -46,6 +46,7 @@
 #include "engines/stark/gfx/framelimiter.h"
 
 #include "audio/mixer.h"
+#include "audio/pcmcache.h"
 #include "common/config-manager.h"
 #include "common/debug-channels.h"
 #include "common/events.h"
@@ -96,6 +97,9 @@ StarkEngine::~StarkEngine() {
 
 	StarkServices::destroy();
 
+	// The cached sound clips are of no use to the next game
+	PCMCacheMan.clear();
+
 	delete _console;
 	delete _frameLimiter;
 }
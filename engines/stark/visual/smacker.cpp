@@ -37,6 +37,9 @@
 
 namespace Stark {
 
+// Many animations can play at once, only keep a couple of frames ready for each
+static const uint kDecodeAheadFrames = 2;
+
 VisualSmacker::VisualSmacker(Gfx::Driver *gfx) :
 		Visual(TYPE),
 		_gfx(gfx),
@@ -62,6 +65,7 @@ void VisualSmacker::loadSmacker(Common::SeekableReadStream *stream) {
 
 	_decoder = new Video::SmackerDecoder();
 	_decoder->setSoundType(Audio::Mixer::kSFXSoundType);
+	_decoder->setDecodeAhead(kDecodeAheadFrames);
 	_decoder->loadStream(stream);
 
 	init();
@@ -73,6 +77,7 @@ void VisualSmacker::loadBink(Common::SeekableReadStream *stream) {
 
 	_decoder = new Video::BinkDecoder();
 	_decoder->setSoundType(Audio::Mixer::kSFXSoundType);
+	_decoder->setDecodeAhead(kDecodeAheadFrames);
 	_decoder->setDefaultHighColorFormat(Gfx::Driver::getRGBAPixelFormat());
 	_decoder->loadStream(stream);
 
@@ -28,6 +28,7 @@ MODULE_OBJS := \
 	VectorRendererSpec.o \
 	wincursor.o \
 	yuv_to_rgb.o \
+	yuv_to_rgb_sse2.o \
 	yuva_to_rgba.o \
 	pixelbuffer.o \
 	opengl/context.o \
@@ -83,8 +83,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
+#include "graphics/yuv_to_rgb_sse2.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVToRGBManager);
@@ -158,7 +161,7 @@ YUVToRGBLookup::YUVToRGBLookup(Graphics::PixelFormat format, YUVToRGBManager::Lu
 }
 
 YUVToRGBManager::YUVToRGBManager() {
-	_lookup = 0;
+	_mutex = g_system ? new Common::Mutex() : nullptr;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -180,16 +183,31 @@ YUVToRGBManager::YUVToRGBManager() {
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
-	delete _lookup;
+	for (Common::List<YUVToRGBLookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		delete *it;
+	delete _mutex;
 }
 
 const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, YUVToRGBManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	if (_mutex)
+		_mutex->lock();
+
+	const YUVToRGBLookup *lookup = nullptr;
+	for (Common::List<YUVToRGBLookup *>::const_iterator it = _lookups.begin(); it != _lookups.end(); ++it) {
+		if ((*it)->getFormat() == format && (*it)->getScale() == scale) {
+			lookup = *it;
+			break;
+		}
+	}
+
+	if (!lookup) {
+		_lookups.push_back(new YUVToRGBLookup(format, scale));
+		lookup = _lookups.back();
+	}
 
-	delete _lookup;
-	_lookup = new YUVToRGBLookup(format, scale);
-	return _lookup;
+	if (_mutex)
+		_mutex->unlock();
+	return lookup;
 }
 
 #define PUT_PIXEL(s, d) \
@@ -204,9 +222,17 @@ void convertYUV444ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const bool scaleITU = lookup->getScale() == YUVToRGBManager::kScaleITU;
 
 	for (int h = 0; h < yHeight; h++) {
-		for (int w = 0; w < yWidth; w++) {
+		// Convert what we can with SIMD, and the rest with the tables
+		int w = convertYUV444RowSSE2(dstPtr, lookup->getFormat(), scaleITU, colorTab, ySrc, uSrc, vSrc, yWidth);
+		dstPtr += w * sizeof(PixelInt);
+		ySrc += w;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < yWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -253,9 +279,17 @@ void convertYUV420ToRGB(byte *dstPtr, int dstPitch, const YUVToRGBLookup *lookup
 	const int16 *Cb_g_tab = Cr_g_tab + 256;
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
+	const bool scaleITU = lookup->getScale() == YUVToRGBManager::kScaleITU;
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Convert what we can with SIMD, and the rest with the tables
+		int w = convertYUV420RowsSSE2(dstPtr, dstPitch, lookup->getFormat(), scaleITU, colorTab, ySrc, uSrc, vSrc, 0, yWidth, yPitch) / 2;
+		dstPtr += w * 2 * sizeof(PixelInt);
+		ySrc += w * 2;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < halfWidth; w++) {
 			const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
@@ -36,6 +36,8 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/list.h"
+#include "common/mutex.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
 
@@ -109,7 +111,11 @@ private:
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale);
 
-	YUVToRGBLookup *_lookup;
+	// The lookups built so far. Videos may be decoded on several threads, so the
+	// lookups are kept until the manager goes away, and the list is guarded by
+	// _mutex. Without g_system there is only one thread, and no mutex.
+	Common::List<YUVToRGBLookup *> _lookups;
+	Common::Mutex *_mutex;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 };
 
@@ -0,0 +1,202 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_sse2.h"
+
+#ifdef __SSE2__
+
+#include "graphics/pixelformat.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+namespace {
+
+/**
+ * Packs 16-bit channel values into pixels, the same way
+ * PixelFormat::ARGBToColor() does.
+ */
+struct PixelPacker {
+	PixelPacker(const PixelFormat &format) {
+		rLoss = _mm_cvtsi32_si128(format.rLoss);
+		gLoss = _mm_cvtsi32_si128(format.gLoss);
+		bLoss = _mm_cvtsi32_si128(format.bLoss);
+		aLoss = _mm_cvtsi32_si128(format.aLoss);
+		rShift = _mm_cvtsi32_si128(format.rShift);
+		gShift = _mm_cvtsi32_si128(format.gShift);
+		bShift = _mm_cvtsi32_si128(format.bShift);
+		aShift = _mm_cvtsi32_si128(format.aShift);
+	}
+
+	__m128i rLoss, gLoss, bLoss, aLoss;
+	__m128i rShift, gShift, bShift, aShift;
+};
+
+/** Chroma terms for 8 pixels, without the offsets of the lookup tables. */
+struct Chroma {
+	int16 crR[8];
+	int16 crbG[8];
+	int16 cbB[8];
+};
+
+inline void lookupChroma(Chroma &chroma, int i, const int16 *colorTab, byte u, byte v) {
+	chroma.crR[i]  = colorTab[v] - 256;
+	chroma.crbG[i] = colorTab[256 + v] + colorTab[512 + u] - (768 + 256);
+	chroma.cbB[i]  = colorTab[768 + u] - (2 * 768 + 256);
+}
+
+/**
+ * Add the luminance to a chroma term and bring the result to [0, 255],
+ * which the lookup tables do by clamping the index.
+ */
+inline __m128i toChannel(__m128i y, __m128i c, bool scaleITU) {
+	__m128i v = _mm_add_epi16(y, c);
+
+	if (scaleITU) {
+		// (clamp(v, 16, 235) - 16) * 255 / 219
+		v = _mm_min_epi16(_mm_max_epi16(v, _mm_set1_epi16(16)), _mm_set1_epi16(235));
+		v = _mm_mullo_epi16(_mm_sub_epi16(v, _mm_set1_epi16(16)), _mm_set1_epi16(255));
+		return _mm_srli_epi16(_mm_mulhi_epu16(v, _mm_set1_epi16(19153)), 6);
+	}
+
+	return _mm_min_epi16(_mm_max_epi16(v, _mm_setzero_si128()), _mm_set1_epi16(255));
+}
+
+inline __m128i pack16(__m128i c, __m128i loss, __m128i shift) {
+	return _mm_sll_epi16(_mm_srl_epi16(c, loss), shift);
+}
+
+inline __m128i pack32(__m128i c, __m128i loss, __m128i shift) {
+	return _mm_sll_epi32(_mm_srl_epi32(c, loss), shift);
+}
+
+template<int bytesPerPixel>
+inline void storePixels(byte *dst, __m128i r, __m128i g, __m128i b, __m128i a, const PixelPacker &p) {
+	if (bytesPerPixel == 2) {
+		const __m128i pixels = _mm_or_si128(
+				_mm_or_si128(pack16(r, p.rLoss, p.rShift), pack16(g, p.gLoss, p.gShift)),
+				_mm_or_si128(pack16(b, p.bLoss, p.bShift), pack16(a, p.aLoss, p.aShift)));
+
+		_mm_storeu_si128((__m128i *)dst, pixels);
+	} else {
+		const __m128i zero = _mm_setzero_si128();
+
+		const __m128i lo = _mm_or_si128(
+				_mm_or_si128(pack32(_mm_unpacklo_epi16(r, zero), p.rLoss, p.rShift), pack32(_mm_unpacklo_epi16(g, zero), p.gLoss, p.gShift)),
+				_mm_or_si128(pack32(_mm_unpacklo_epi16(b, zero), p.bLoss, p.bShift), pack32(_mm_unpacklo_epi16(a, zero), p.aLoss, p.aShift)));
+		const __m128i hi = _mm_or_si128(
+				_mm_or_si128(pack32(_mm_unpackhi_epi16(r, zero), p.rLoss, p.rShift), pack32(_mm_unpackhi_epi16(g, zero), p.gLoss, p.gShift)),
+				_mm_or_si128(pack32(_mm_unpackhi_epi16(b, zero), p.bLoss, p.bShift), pack32(_mm_unpackhi_epi16(a, zero), p.aLoss, p.aShift)));
+
+		_mm_storeu_si128((__m128i *)dst, lo);
+		_mm_storeu_si128((__m128i *)(dst + 16), hi);
+	}
+}
+
+inline __m128i loadBytes(const byte *src) {
+	return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)src), _mm_setzero_si128());
+}
+
+template<int bytesPerPixel>
+void convertPixels(byte *dst, const byte *ySrc, const byte *aSrc, const Chroma &chroma, bool scaleITU, const PixelPacker &p) {
+	const __m128i y = loadBytes(ySrc);
+	const __m128i a = aSrc ? loadBytes(aSrc) : _mm_set1_epi16(255);
+
+	const __m128i r = toChannel(y, _mm_loadu_si128((const __m128i *)chroma.crR), scaleITU);
+	const __m128i g = toChannel(y, _mm_loadu_si128((const __m128i *)chroma.crbG), scaleITU);
+	const __m128i b = toChannel(y, _mm_loadu_si128((const __m128i *)chroma.cbB), scaleITU);
+
+	storePixels<bytesPerPixel>(dst, r, g, b, a, p);
+}
+
+template<int bytesPerPixel>
+int convertYUV420Rows(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yPitch) {
+	const PixelPacker packer(format);
+	Chroma chroma;
+
+	int x;
+	for (x = 0; x + 8 <= yWidth; x += 8) {
+		// Each chroma sample covers two pixels of both rows
+		for (int i = 0; i < 4; i++) {
+			lookupChroma(chroma, 2 * i, colorTab, uSrc[i], vSrc[i]);
+			lookupChroma(chroma, 2 * i + 1, colorTab, uSrc[i], vSrc[i]);
+		}
+
+		convertPixels<bytesPerPixel>(dstPtr, ySrc, aSrc, chroma, scaleITU, packer);
+		convertPixels<bytesPerPixel>(dstPtr + dstPitch, ySrc + yPitch, aSrc ? aSrc + yPitch : 0, chroma, scaleITU, packer);
+
+		dstPtr += 8 * bytesPerPixel;
+		ySrc += 8;
+		uSrc += 4;
+		vSrc += 4;
+		if (aSrc)
+			aSrc += 8;
+	}
+
+	return x;
+}
+
+template<int bytesPerPixel>
+int convertYUV444Row(byte *dstPtr, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth) {
+	const PixelPacker packer(format);
+	Chroma chroma;
+
+	int x;
+	for (x = 0; x + 8 <= yWidth; x += 8) {
+		for (int i = 0; i < 8; i++)
+			lookupChroma(chroma, i, colorTab, uSrc[i], vSrc[i]);
+
+		convertPixels<bytesPerPixel>(dstPtr, ySrc, 0, chroma, scaleITU, packer);
+
+		dstPtr += 8 * bytesPerPixel;
+		ySrc += 8;
+		uSrc += 8;
+		vSrc += 8;
+	}
+
+	return x;
+}
+
+} // End of anonymous namespace
+
+int convertYUV420RowsSSE2(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yPitch) {
+	if (format.bytesPerPixel == 2)
+		return convertYUV420Rows<2>(dstPtr, dstPitch, format, scaleITU, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch);
+	else
+		return convertYUV420Rows<4>(dstPtr, dstPitch, format, scaleITU, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch);
+}
+
+int convertYUV444RowSSE2(byte *dstPtr, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth) {
+	if (format.bytesPerPixel == 2)
+		return convertYUV444Row<2>(dstPtr, format, scaleITU, colorTab, ySrc, uSrc, vSrc, yWidth);
+	else
+		return convertYUV444Row<4>(dstPtr, format, scaleITU, colorTab, ySrc, uSrc, vSrc, yWidth);
+}
+
+} // End of namespace Graphics
+
+#endif // __SSE2__
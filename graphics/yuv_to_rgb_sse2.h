@@ -0,0 +1,75 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * SSE2 versions of the inner loops of the YUV to RGB conversions.
+ *
+ * They produce exactly the same pixels as the lookup tables used by
+ * YUVToRGBManager and YUVAToRGBAManager, and only handle whole groups
+ * of 8 pixels. The callers convert what is left of a row with their
+ * lookup tables.
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_SSE2_H
+#define GRAPHICS_YUV_TO_RGB_SSE2_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+struct PixelFormat;
+
+#ifdef __SSE2__
+
+/**
+ * Convert two rows of YUV 4:2:0 data.
+ *
+ * @param colorTab	the chroma tables of the conversion manager
+ * @param aSrc		the alpha rows, or 0 for opaque pixels
+ * @return the number of pixels converted in each row
+ */
+int convertYUV420RowsSSE2(byte *dstPtr, int dstPitch, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, const byte *aSrc, int yWidth, int yPitch);
+
+/**
+ * Convert one row of YUV 4:4:4 data.
+ *
+ * @param colorTab	the chroma tables of the conversion manager
+ * @return the number of pixels converted
+ */
+int convertYUV444RowSSE2(byte *dstPtr, const PixelFormat &format, bool scaleITU, const int16 *colorTab,
+		const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth);
+
+#else
+
+inline int convertYUV420RowsSSE2(byte *, int, const PixelFormat &, bool, const int16 *,
+		const byte *, const byte *, const byte *, const byte *, int, int) { return 0; }
+
+inline int convertYUV444RowSSE2(byte *, const PixelFormat &, bool, const int16 *,
+		const byte *, const byte *, const byte *, int) { return 0; }
+
+#endif
+
+} // End of namespace Graphics
+
+#endif
@@ -83,8 +83,11 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/system.h"
+
 #include "graphics/surface.h"
 #include "graphics/yuva_to_rgba.h"
+#include "graphics/yuv_to_rgb_sse2.h"
 
 namespace Common {
 DECLARE_SINGLETON(Graphics::YUVAToRGBAManager);
@@ -165,7 +168,7 @@ YUVAToRGBALookup::YUVAToRGBALookup(Graphics::PixelFormat format, YUVAToRGBAManag
 }
 
 YUVAToRGBAManager::YUVAToRGBAManager() {
-	_lookup = 0;
+	_mutex = g_system ? new Common::Mutex() : nullptr;
 
 	int16 *Cr_r_tab = &_colorTab[0 * 256];
 	int16 *Cr_g_tab = &_colorTab[1 * 256];
@@ -187,16 +190,31 @@ YUVAToRGBAManager::YUVAToRGBAManager() {
 }
 
 YUVAToRGBAManager::~YUVAToRGBAManager() {
-	delete _lookup;
+	for (Common::List<YUVAToRGBALookup *>::iterator it = _lookups.begin(); it != _lookups.end(); ++it)
+		delete *it;
+	delete _mutex;
 }
 
 const YUVAToRGBALookup *YUVAToRGBAManager::getLookup(Graphics::PixelFormat format, YUVAToRGBAManager::LuminanceScale scale) {
-	if (_lookup && _lookup->getFormat() == format && _lookup->getScale() == scale)
-		return _lookup;
+	if (_mutex)
+		_mutex->lock();
+
+	const YUVAToRGBALookup *lookup = nullptr;
+	for (Common::List<YUVAToRGBALookup *>::const_iterator it = _lookups.begin(); it != _lookups.end(); ++it) {
+		if ((*it)->getFormat() == format && (*it)->getScale() == scale) {
+			lookup = *it;
+			break;
+		}
+	}
+
+	if (!lookup) {
+		_lookups.push_back(new YUVAToRGBALookup(format, scale));
+		lookup = _lookups.back();
+	}
 
-	delete _lookup;
-	_lookup = new YUVAToRGBALookup(format, scale);
-	return _lookup;
+	if (_mutex)
+		_mutex->unlock();
+	return lookup;
 }
 
 #define PUT_PIXELA(s, a, d) \
@@ -215,9 +233,18 @@ void convertYUVA420ToRGBA(byte *dstPtr, int dstPitch, const YUVAToRGBALookup *lo
 	const int16 *Cb_b_tab = Cb_g_tab + 256;
 	const uint32 *rgbToPix = lookup->getRGBToPix();
 	const uint32 *aToPix = lookup->getAlphaToPix();
+	const bool scaleITU = lookup->getScale() == YUVAToRGBAManager::kScaleITU;
 
 	for (int h = 0; h < halfHeight; h++) {
-		for (int w = 0; w < halfWidth; w++) {
+		// Convert what we can with SIMD, and the rest with the tables
+		int w = convertYUV420RowsSSE2(dstPtr, dstPitch, lookup->getFormat(), scaleITU, colorTab, ySrc, uSrc, vSrc, aSrc, yWidth, yPitch) / 2;
+		dstPtr += w * 2 * sizeof(PixelInt);
+		ySrc += w * 2;
+		aSrc += w * 2;
+		uSrc += w;
+		vSrc += w;
+
+		for (; w < halfWidth; w++) {
 			register const uint32 *L;
 
 			int16 cr_r  = Cr_r_tab[*vSrc];
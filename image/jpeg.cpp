@@ -229,10 +229,14 @@ J_COLOR_SPACE fromScummvmPixelFormat(const Graphics::PixelFormat &format) {
 #endif
 
 bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
-#ifdef USE_JPEG
 	// Reset member variables from previous decodings
 	destroy();
 
+	return loadStreamInto(stream, _surface);
+}
+
+bool JPEGDecoder::loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst) {
+#ifdef USE_JPEG
 	jpeg_decompress_struct cinfo;
 	jpeg_error_mgr jerr;
 
@@ -274,44 +278,42 @@ bool JPEGDecoder::loadStream(Common::SeekableReadStream &stream) {
 	jpeg_start_decompress(&cinfo);
 
 	// Allocate buffers for the output data
+	Graphics::PixelFormat outputPixelFormat;
 	switch (_colorSpace) {
-	case kColorSpaceRGB: {
-		Graphics::PixelFormat outputPixelFormat;
+	case kColorSpaceRGB:
 		if (cinfo.out_color_space == JCS_RGB) {
 			outputPixelFormat = getByteOrderRgbPixelFormat();
 		} else {
 			outputPixelFormat = _requestedPixelFormat;
 		}
-		_surface.create(cinfo.output_width, cinfo.output_height, outputPixelFormat);
 		break;
-	}
 	case kColorSpaceYUV:
 		// We use YUV with 3 bytes per pixel otherwise.
 		// This is pretty ugly since our PixelFormat cannot express YUV...
-		_surface.create(cinfo.output_width, cinfo.output_height, Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0));
+		outputPixelFormat = Graphics::PixelFormat(3, 0, 0, 0, 0, 0, 0, 0, 0);
 		break;
 	}
 
-	// Allocate buffer for one scanline
-	JDIMENSION pitch = cinfo.output_width * _surface.format.bytesPerPixel;
-	assert(_surface.pitch >= pitch);
-	JSAMPARRAY buffer = (*cinfo.mem->alloc_sarray)((j_common_ptr)&cinfo, JPOOL_IMAGE, pitch, 1);
-
-	// Go through the image data scanline by scanline
-	while (cinfo.output_scanline < cinfo.output_height) {
-		byte *dst = (byte *)_surface.getBasePtr(0, cinfo.output_scanline);
+	if (!dst.getPixels() || dst.w != (int16)cinfo.output_width || dst.h != (int16)cinfo.output_height
+	        || dst.format != outputPixelFormat) {
+		dst.free();
+		dst.create(cinfo.output_width, cinfo.output_height, outputPixelFormat);
+	}
 
-		jpeg_read_scanlines(&cinfo, buffer, 1);
+	assert(dst.pitch >= (int16)(cinfo.output_width * dst.format.bytesPerPixel));
 
-		memcpy(dst, buffer[0], pitch);
+	// Go through the image data scanline by scanline, straight into the surface
+	while (cinfo.output_scanline < cinfo.output_height) {
+		JSAMPROW row = (JSAMPROW)dst.getBasePtr(0, cinfo.output_scanline);
+		jpeg_read_scanlines(&cinfo, &row, 1);
 	}
 
 	// We are done with decompressing, thus free all the data
 	jpeg_finish_decompress(&cinfo);
 	jpeg_destroy_decompress(&cinfo);
 
-	if (_colorSpace == kColorSpaceRGB && _surface.format != _requestedPixelFormat) {
-		_surface.convertToInPlace(_requestedPixelFormat); // Slow path
+	if (_colorSpace == kColorSpaceRGB && dst.format != _requestedPixelFormat) {
+		dst.convertToInPlace(_requestedPixelFormat); // Slow path
 	}
 
 	return true;
@@ -99,6 +99,23 @@ public:
 	 */
 	void setOutputPixelFormat(const Graphics::PixelFormat &format) { _requestedPixelFormat = format; }
 
+	/**
+	 * Decode an image into a surface owned by the caller, rather than into
+	 * the surface of the decoder returned by getSurface().
+	 *
+	 * The surface is reused if it already has the size and the pixel format
+	 * of the image, otherwise it is freed and created again. It must not
+	 * point to pixels it does not own.
+	 *
+	 * Decoders do not share any state, so several of them may decode
+	 * images at the same time from different threads.
+	 *
+	 * @param stream The stream to decode the image from
+	 * @param dst    The surface to decode the image into
+	 * @return true if the image was decoded
+	 */
+	bool loadStreamInto(Common::SeekableReadStream &stream, Graphics::Surface &dst);
+
 private:
 	Graphics::Surface _surface;
 	ColorSpace _colorSpace;
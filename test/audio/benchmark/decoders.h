@@ -0,0 +1,364 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/decoders/adpcm.h"
+#include "audio/decoders/aiff.h"
+#include "audio/decoders/asf.h"
+#include "audio/decoders/flac.h"
+#include "audio/decoders/mp3.h"
+#include "audio/decoders/quicktime.h"
+#include "audio/decoders/raw.h"
+#include "audio/decoders/voc.h"
+#include "audio/decoders/vorbis.h"
+#include "audio/decoders/wave.h"
+#include "audio/decoders/xa.h"
+
+#include "common/endian.h"
+#include "common/memstream.h"
+
+namespace {
+
+const int kRate = 22050;
+const int kChunkSamples = 4096;
+
+// Two seconds of stereo 16-bit PCM, the sources for the compressed
+// formats are sized to decode to about as many samples.
+const uint32 kDataSize = kRate * 2 * 2 * 2;
+
+typedef Audio::AudioStream *(*StreamFactory)(Common::SeekableReadStream *stream, void *param);
+
+/**
+ * Decode the given data repeatedly until at least kMinDuration seconds
+ * have passed and report the decoding speed.
+ */
+void benchmarkDecoder(const char *name, const byte *data, uint32 size, StreamFactory factory, void *param = 0) {
+	int16 *buffer = new int16[kChunkSamples];
+	double samples = 0;
+	double elapsed = 0;
+	const double start = Benchmark::getTime();
+
+	do {
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, size);
+		Audio::AudioStream *audioStream = factory(stream, param);
+		if (!audioStream) {
+			Benchmark::skip(name, "could not create stream");
+			delete[] buffer;
+			return;
+		}
+
+		int read;
+		while (!audioStream->endOfData() && (read = audioStream->readBuffer(buffer, kChunkSamples)) > 0)
+			samples += read;
+		delete audioStream;
+
+		elapsed = Benchmark::getTime() - start;
+	} while (elapsed < Benchmark::kMinDuration);
+
+	Benchmark::report(name, samples, "sample", elapsed);
+	delete[] buffer;
+}
+
+/** Run a benchmark on a file from the BENCHMARK_DATA directory. */
+void benchmarkDataFile(const char *name, const char *filename, StreamFactory factory) {
+	uint32 size;
+	byte *data = Benchmark::loadDataFile(filename, size);
+	if (!data) {
+		Benchmark::skip(name, "reference file not found");
+		return;
+	}
+
+	benchmarkDecoder(name, data, size, factory);
+	free(data);
+}
+
+struct ADPCMParams {
+	Audio::ADPCMType type;
+	int channels;
+	uint32 blockAlign;
+};
+
+struct ADPCMVariant {
+	const char *name;
+	ADPCMParams params;
+};
+
+const ADPCMVariant kADPCMVariants[] = {
+	{ "ADPCM Oki",              { Audio::kADPCMOki,    1,    0 } },
+	{ "ADPCM DVI",              { Audio::kADPCMDVI,    2,    0 } },
+	{ "ADPCM MS IMA",           { Audio::kADPCMMSIma,  2, 1024 } },
+	{ "ADPCM MS",               { Audio::kADPCMMS,     2, 1024 } },
+	{ "ADPCM Apple",            { Audio::kADPCMApple,  2,    0 } },
+	{ "ADPCM DK3",              { Audio::kADPCMDK3,    2, 1024 } }
+};
+
+// 4 bits per sample, in whole blocks
+const uint32 kADPCMDataSize = kDataSize / 4 / 1024 * 1024;
+
+Audio::AudioStream *createADPCM(Common::SeekableReadStream *stream, void *param) {
+	const ADPCMParams *p = (const ADPCMParams *)param;
+	return Audio::makeADPCMStream(stream, DisposeAfterUse::YES, 0, p->type, kRate, p->channels, p->blockAlign);
+}
+
+Audio::AudioStream *createRaw(Common::SeekableReadStream *stream, void *param) {
+	return Audio::makeRawStream(stream, kRate, *(const byte *)param, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createWAV(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeWAVStream(stream, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createAIFF(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeAIFFStream(stream, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createVOC(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeVOCStream(stream, Audio::FLAG_UNSIGNED, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createXA(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeXAStream(stream, kRate, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createASF(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeASFStream(stream, DisposeAfterUse::YES);
+}
+
+Audio::AudioStream *createQuickTime(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeQuickTimeStream(stream, DisposeAfterUse::YES);
+}
+
+#ifdef USE_MAD
+Audio::AudioStream *createMP3(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeMP3Stream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+#ifdef USE_VORBIS
+Audio::AudioStream *createVorbis(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeVorbisStream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+#ifdef USE_FLAC
+Audio::AudioStream *createFLAC(Common::SeekableReadStream *stream, void *) {
+	return Audio::makeFLACStream(stream, DisposeAfterUse::YES);
+}
+#endif
+
+/**
+ * Fill data with random ADPCM nibbles, and give each block a header
+ * the decoders accept.
+ */
+void createADPCMData(const ADPCMParams &params, byte *data, uint32 size) {
+	Benchmark::fillRandom(data, size);
+
+	if (!params.blockAlign)
+		return;
+
+	for (uint32 block = 0; block + params.blockAlign <= size; block += params.blockAlign) {
+		byte *header = data + block;
+
+		switch (params.type) {
+		case Audio::kADPCMMSIma:
+			// Initial sample and step index for each channel
+			for (int i = 0; i < params.channels; i++) {
+				header[i * 4 + 2] %= 89;
+				header[i * 4 + 3] = 0;
+			}
+			break;
+		case Audio::kADPCMDK3:
+			WRITE_LE_UINT16(header + 2, kRate);
+			header[14] %= 89;
+			header[15] %= 89;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+/** Wrap data in a RIFF WAVE container. */
+byte *createWAVData(uint16 type, uint16 channels, uint16 bitsPerSample, uint16 blockAlign, const byte *data, uint32 dataSize, uint32 &size) {
+	size = 44 + dataSize;
+	byte *wav = (byte *)malloc(size);
+
+	memcpy(wav, "RIFF", 4);
+	WRITE_LE_UINT32(wav + 4, size - 8);
+	memcpy(wav + 8, "WAVEfmt ", 8);
+	WRITE_LE_UINT32(wav + 16, 16);
+	WRITE_LE_UINT16(wav + 20, type);
+	WRITE_LE_UINT16(wav + 22, channels);
+	WRITE_LE_UINT32(wav + 24, kRate);
+	WRITE_LE_UINT32(wav + 28, kRate * blockAlign);
+	WRITE_LE_UINT16(wav + 32, blockAlign);
+	WRITE_LE_UINT16(wav + 34, bitsPerSample);
+	memcpy(wav + 36, "data", 4);
+	WRITE_LE_UINT32(wav + 40, dataSize);
+	memcpy(wav + 44, data, dataSize);
+
+	return wav;
+}
+
+} // End of anonymous namespace
+
+class AudioDecoderBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		_pcm = (byte *)malloc(kDataSize);
+		Benchmark::fillRandom(_pcm, kDataSize);
+	}
+
+	void tearDown() {
+		free(_pcm);
+	}
+
+	void test_raw() {
+		byte flags = Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN | Audio::FLAG_STEREO;
+		benchmarkDecoder("Raw 16-bit LE stereo", _pcm, kDataSize, createRaw, &flags);
+
+		flags = Audio::FLAG_16BITS | Audio::FLAG_STEREO;
+		benchmarkDecoder("Raw 16-bit BE stereo", _pcm, kDataSize, createRaw, &flags);
+
+		flags = Audio::FLAG_UNSIGNED;
+		benchmarkDecoder("Raw 8-bit unsigned mono", _pcm, kDataSize / 4, createRaw, &flags);
+	}
+
+	void test_adpcm() {
+		byte *data = (byte *)malloc(kADPCMDataSize);
+
+		for (uint i = 0; i < ARRAYSIZE(kADPCMVariants); i++) {
+			ADPCMParams params = kADPCMVariants[i].params;
+			createADPCMData(params, data, kADPCMDataSize);
+			benchmarkDecoder(kADPCMVariants[i].name, data, kADPCMDataSize, createADPCM, &params);
+		}
+
+		free(data);
+	}
+
+	void test_wave() {
+		uint32 size;
+		byte *wav = createWAVData(1, 2, 16, 4, _pcm, kDataSize, size);
+		benchmarkDecoder("WAVE PCM", wav, size, createWAV);
+		free(wav);
+
+		const uint32 adpcmSize = kADPCMDataSize;
+		byte *adpcm = (byte *)malloc(adpcmSize);
+
+		ADPCMParams msIma = { Audio::kADPCMMSIma, 2, 1024 };
+		createADPCMData(msIma, adpcm, adpcmSize);
+		wav = createWAVData(17, 2, 4, 1024, adpcm, adpcmSize, size);
+		benchmarkDecoder("WAVE MS IMA ADPCM", wav, size, createWAV);
+		free(wav);
+
+		ADPCMParams ms = { Audio::kADPCMMS, 2, 1024 };
+		createADPCMData(ms, adpcm, adpcmSize);
+		wav = createWAVData(2, 2, 4, 1024, adpcm, adpcmSize, size);
+		benchmarkDecoder("WAVE MS ADPCM", wav, size, createWAV);
+		free(wav);
+
+		free(adpcm);
+	}
+
+	void test_aiff() {
+		const uint32 frames = kDataSize / 4;
+		const uint32 size = 54 + kDataSize;
+		byte *aiff = (byte *)malloc(size);
+
+		// 22050 Hz as an 80-bit IEEE extended float
+		static const byte rate[] = { 0x40, 0x0D, 0xAC, 0x44, 0, 0, 0, 0, 0, 0 };
+
+		memcpy(aiff, "FORM", 4);
+		WRITE_BE_UINT32(aiff + 4, size - 8);
+		memcpy(aiff + 8, "AIFFCOMM", 8);
+		WRITE_BE_UINT32(aiff + 16, 18);
+		WRITE_BE_UINT16(aiff + 20, 2);
+		WRITE_BE_UINT32(aiff + 22, frames);
+		WRITE_BE_UINT16(aiff + 26, 16);
+		memcpy(aiff + 28, rate, sizeof(rate));
+		memcpy(aiff + 38, "SSND", 4);
+		WRITE_BE_UINT32(aiff + 42, kDataSize + 8);
+		WRITE_BE_UINT32(aiff + 46, 0);
+		WRITE_BE_UINT32(aiff + 50, 0);
+		memcpy(aiff + 54, _pcm, kDataSize);
+
+		benchmarkDecoder("AIFF", aiff, size, createAIFF);
+		free(aiff);
+	}
+
+	void test_voc() {
+		const uint32 samples = kDataSize / 4;
+		const uint32 size = 26 + 6 + samples + 1;
+		byte *voc = (byte *)malloc(size);
+
+		memcpy(voc, "Creative Voice File\x1A", 20);
+		WRITE_LE_UINT16(voc + 20, 26);
+		WRITE_LE_UINT16(voc + 22, 0x010A);
+		WRITE_LE_UINT16(voc + 24, ~0x010A + 0x1234);
+
+		// Sound data block, 8-bit unsigned PCM
+		byte *block = voc + 26;
+		block[0] = 1;
+		WRITE_LE_UINT16(block + 1, (samples + 2) & 0xFFFF);
+		block[3] = (samples + 2) >> 16;
+		block[4] = 256 - 1000000 / kRate;
+		block[5] = 0;
+		memcpy(block + 6, _pcm, samples);
+
+		// Terminator
+		voc[size - 1] = 0;
+
+		benchmarkDecoder("VOC", voc, size, createVOC);
+		free(voc);
+	}
+
+	void test_xa() {
+		// 16 bytes decode to 28 samples
+		const uint32 size = kDataSize / 4 / 28 * 16;
+		byte *xa = (byte *)malloc(size);
+		Benchmark::fillRandom(xa, size);
+
+		for (uint32 i = 0; i < size; i += 16) {
+			// Predictor 0-4 and shift, followed by regular block flags
+			xa[i] = ((xa[i] >> 4) % 5) << 4 | (xa[i] & 0x0F);
+			xa[i + 1] = 0;
+		}
+
+		benchmarkDecoder("XA", xa, size, createXA);
+		free(xa);
+	}
+
+	void test_wma() {
+		benchmarkDataFile("WMA", "audio.wma", createASF);
+	}
+
+	void test_qdm2() {
+		benchmarkDataFile("QDM2", "qdm2.mov", createQuickTime);
+	}
+
+	void test_mp3() {
+#ifdef USE_MAD
+		benchmarkDataFile("MP3", "audio.mp3", createMP3);
+#else
+		Benchmark::skip("MP3", "not compiled in");
+#endif
+	}
+
+	void test_vorbis() {
+#ifdef USE_VORBIS
+		benchmarkDataFile("Vorbis", "audio.ogg", createVorbis);
+#else
+		Benchmark::skip("Vorbis", "not compiled in");
+#endif
+	}
+
+	void test_flac() {
+#ifdef USE_FLAC
+		benchmarkDataFile("FLAC", "audio.flac", createFLAC);
+#else
+		Benchmark::skip("FLAC", "not compiled in");
+#endif
+	}
+
+private:
+	byte *_pcm;
+};
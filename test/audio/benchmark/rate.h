@@ -0,0 +1,114 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+namespace {
+
+// Output frames produced per flow() call, about what the backends ask
+// the mixer for in one callback.
+const uint32 kOutputFrames = 2048;
+
+// One second of 16-bit stereo source data, looped forever
+const uint32 kSourceSize = 48000 * 2 * 2;
+
+const Audio::st_volume_t kFullVolume = 0x100;
+
+/** Create an endless stream from the given 16-bit PCM data. */
+Audio::AudioStream *createSourceStream(const byte *data, uint rate, bool stereo) {
+	byte flags = Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN;
+	if (stereo)
+		flags |= Audio::FLAG_STEREO;
+
+	Audio::RewindableAudioStream *stream = Audio::makeRawStream(data, kSourceSize, rate, flags, DisposeAfterUse::NO);
+	return Audio::makeLoopingAudioStream(stream, 0);
+}
+
+/**
+ * Mix numChannels streams into one output buffer the way
+ * MixerImpl::mixCallback does, and report the number of output frames
+ * produced per second.
+ */
+void benchmarkMix(const char *name, const byte *data, uint inRate, uint outRate, bool stereo, int numChannels) {
+	Audio::AudioStream **streams = new Audio::AudioStream *[numChannels];
+	Audio::RateConverter **converters = new Audio::RateConverter *[numChannels];
+	for (int i = 0; i < numChannels; i++) {
+		streams[i] = createSourceStream(data, inRate, stereo);
+		converters[i] = Audio::makeRateConverter(inRate, outRate, stereo);
+	}
+
+	Audio::st_sample_t *buffer = new Audio::st_sample_t[kOutputFrames * 2];
+	double frames = 0;
+	double elapsed = 0;
+	const double start = Benchmark::getTime();
+
+	do {
+		for (int n = 0; n < 64; n++) {
+			memset(buffer, 0, kOutputFrames * 2 * sizeof(Audio::st_sample_t));
+			for (int i = 0; i < numChannels; i++)
+				converters[i]->flow(*streams[i], buffer, kOutputFrames, kFullVolume, kFullVolume);
+			frames += kOutputFrames;
+		}
+
+		elapsed = Benchmark::getTime() - start;
+	} while (elapsed < Benchmark::kMinDuration);
+
+	Benchmark::report(name, frames, "sample", elapsed);
+
+	delete[] buffer;
+	for (int i = 0; i < numChannels; i++) {
+		delete converters[i];
+		delete streams[i];
+	}
+	delete[] converters;
+	delete[] streams;
+}
+
+} // End of anonymous namespace
+
+class RateConverterBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		_source = (byte *)malloc(kSourceSize);
+		Benchmark::fillRandom(_source, kSourceSize);
+	}
+
+	void tearDown() {
+		free(_source);
+	}
+
+	void test_flow() {
+		static const struct {
+			uint inRate;
+			uint outRate;
+		} pairs[] = {
+			{ 44100, 44100 },
+			{ 22050, 44100 },
+			{ 11025, 44100 },
+			{  8000, 22050 },
+			{ 44100, 48000 },
+			{ 48000, 44100 }
+		};
+
+		for (uint i = 0; i < ARRAYSIZE(pairs); i++) {
+			for (int stereo = 0; stereo < 2; stereo++) {
+				Common::String name = Common::String::format("Rate %u -> %u %s", pairs[i].inRate, pairs[i].outRate, stereo ? "stereo" : "mono");
+				benchmarkMix(name.c_str(), _source, pairs[i].inRate, pairs[i].outRate, stereo, 1);
+			}
+		}
+	}
+
+	void test_mix() {
+		static const int channels[] = { 1, 4, 16, 32 };
+
+		// Typical game sound effects, mixed to the usual output rate
+		for (uint i = 0; i < ARRAYSIZE(channels); i++) {
+			Common::String name = Common::String::format("Mix %d x 22050 Hz mono", channels[i]);
+			benchmarkMix(name.c_str(), _source, 22050, 44100, false, channels[i]);
+		}
+	}
+
+private:
+	byte *_source;
+};
@@ -0,0 +1,110 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/decoders/mp3.h"
+#include "audio/audiostream.h"
+
+#include "common/memstream.h"
+
+#ifdef USE_MAD
+
+/**
+ * Counts how many bytes the decoder pulls from the underlying stream,
+ * which is what a seek in a large file costs.
+ */
+class CountingReadStream : public Common::SeekableReadStream {
+public:
+	CountingReadStream(Common::SeekableReadStream *parent) : _parent(parent), _bytesRead(0) {}
+	~CountingReadStream() { delete _parent; }
+
+	uint32 read(void *dataPtr, uint32 dataSize) {
+		uint32 size = _parent->read(dataPtr, dataSize);
+		_bytesRead += size;
+		return size;
+	}
+
+	bool eos() const { return _parent->eos(); }
+	int32 pos() const { return _parent->pos(); }
+	int32 size() const { return _parent->size(); }
+	bool seek(int32 offset, int whence = SEEK_SET) { return _parent->seek(offset, whence); }
+
+	uint32 _bytesRead;
+
+private:
+	Common::SeekableReadStream *_parent;
+};
+
+/**
+ * Create a stream of silent MPEG-1 Layer III frames (128 kbit/s,
+ * 44.1 kHz, mono). Each frame decodes to 1152 samples.
+ */
+static CountingReadStream *createSilentMP3Stream(const int numFrames, int32 &size) {
+	const int frameSize = 144 * 128000 / 44100;
+	size = frameSize * numFrames;
+
+	byte *data = (byte *)malloc(size);
+	memset(data, 0, size);
+	for (int i = 0; i < numFrames; ++i) {
+		byte *frame = data + i * frameSize;
+		frame[0] = 0xFF;
+		frame[1] = 0xFB;
+		frame[2] = 0x90;
+		frame[3] = 0xC0;
+	}
+
+	return new CountingReadStream(new Common::MemoryReadStream(data, size, DisposeAfterUse::YES));
+}
+
+#endif
+
+class MP3StreamTestSuite : public CxxTest::TestSuite
+{
+public:
+	void test_seek_position() {
+#ifdef USE_MAD
+		const int numFrames = 500;
+		int32 size;
+		CountingReadStream *file = createSilentMP3Stream(numFrames, size);
+		Audio::SeekableAudioStream *s = Audio::makeMP3Stream(file, DisposeAfterUse::YES);
+		TS_ASSERT(s != 0);
+
+		const int totalSamples = numFrames * 1152;
+		TS_ASSERT_EQUALS(s->getLength().msecs(), totalSamples * 1000 / 44100);
+
+		int16 *buffer = new int16[totalSamples];
+		const int seekFrames[] = { totalSamples / 2, totalSamples / 10, totalSamples - 5000, 1152 * 16 };
+		for (uint i = 0; i < ARRAYSIZE(seekFrames); ++i) {
+			TS_ASSERT(s->seek(Audio::Timestamp(0, seekFrames[i], 44100)));
+
+			// Decoding restarts at a frame boundary at most two frames past the destination
+			const int remaining = s->readBuffer(buffer, totalSamples);
+			TS_ASSERT_LESS_THAN_EQUALS(totalSamples - seekFrames[i] - 2 * 1152, remaining);
+			TS_ASSERT_LESS_THAN_EQUALS(remaining, totalSamples - seekFrames[i]);
+		}
+
+		delete[] buffer;
+		delete s;
+#endif
+	}
+
+	void test_seek_cost() {
+#ifdef USE_MAD
+		// About 4 MB of data, 3 minutes of audio
+		const int numFrames = 10000;
+		int32 size;
+		CountingReadStream *file = createSilentMP3Stream(numFrames, size);
+		Audio::SeekableAudioStream *s = Audio::makeMP3Stream(file, DisposeAfterUse::YES);
+		TS_ASSERT(s != 0);
+
+		// Seeking backwards, or far ahead, should not have to read the
+		// stream up to the destination.
+		const int seekMsecs[] = { 170000, 1000, 90000, 60000, 175000 };
+		for (uint i = 0; i < ARRAYSIZE(seekMsecs); ++i) {
+			file->_bytesRead = 0;
+			TS_ASSERT(s->seek(Audio::Timestamp(seekMsecs[i], 44100)));
+			TS_ASSERT_LESS_THAN(file->_bytesRead, (uint32)size / 16);
+		}
+
+		delete s;
+#endif
+	}
+};
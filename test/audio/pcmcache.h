@@ -0,0 +1,148 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/audiostream.h"
+#include "audio/pcmcache.h"
+#include "audio/decoders/raw.h"
+
+#include "common/endian.h"
+
+#include "test/null_osystem.h"
+
+class PCMCacheTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		// The cache needs g_system for its mutex
+		NullTestSystem::install();
+		PCMCacheMan.clear();
+		PCMCacheMan.setBudget(Audio::PCMCache::kDefaultBudget);
+		PCMCacheMan.setMaxClipSize(Audio::PCMCache::kDefaultMaxClipSize);
+	}
+
+	void tearDown() {
+		PCMCacheMan.clear();
+		PCMCacheMan.setBudget(Audio::PCMCache::kDefaultBudget);
+		PCMCacheMan.setMaxClipSize(Audio::PCMCache::kDefaultMaxClipSize);
+	}
+
+	void test_add_and_find() {
+		const uint32 misses = PCMCacheMan.getMisses();
+		const uint32 hits = PCMCacheMan.getHits();
+
+		TS_ASSERT(!PCMCacheMan.find("clip"));
+		TS_ASSERT_EQUALS(PCMCacheMan.getMisses(), misses + 1);
+
+		Audio::RewindableAudioStream *added = PCMCacheMan.add("clip", createClip(1000, 1));
+		TS_ASSERT(added);
+		TS_ASSERT_EQUALS(PCMCacheMan.getNumClips(), 1u);
+		TS_ASSERT_EQUALS(PCMCacheMan.getSize(), 1000 * sizeof(int16));
+		checkClip(added, 1000, 1);
+		delete added;
+
+		Audio::SeekableAudioStream *found = PCMCacheMan.find("clip");
+		TS_ASSERT(found);
+		TS_ASSERT_EQUALS(PCMCacheMan.getHits(), hits + 1);
+		TS_ASSERT_EQUALS(found->getRate(), 22050);
+		TS_ASSERT(!found->isStereo());
+		TS_ASSERT_EQUALS(found->getLength().totalNumberOfFrames(), 1000);
+		checkClip(found, 1000, 1);
+
+		// Cached streams can be played again
+		TS_ASSERT(found->rewind());
+		checkClip(found, 1000, 1);
+		delete found;
+	}
+
+	void test_lru_eviction() {
+		const uint32 evictions = PCMCacheMan.getEvictions();
+		PCMCacheMan.setBudget(2 * 1000 * sizeof(int16));
+
+		delete PCMCacheMan.add("a", createClip(1000, 1));
+		delete PCMCacheMan.add("b", createClip(1000, 2));
+
+		// Use "a", so that "b" is the least recently used clip
+		delete PCMCacheMan.find("a");
+		delete PCMCacheMan.add("c", createClip(1000, 3));
+
+		TS_ASSERT_EQUALS(PCMCacheMan.getNumClips(), 2u);
+		TS_ASSERT_EQUALS(PCMCacheMan.getSize(), 2 * 1000 * sizeof(int16));
+		TS_ASSERT_EQUALS(PCMCacheMan.getEvictions(), evictions + 1);
+		TS_ASSERT(!PCMCacheMan.find("b"));
+
+		Audio::SeekableAudioStream *stream = PCMCacheMan.find("a");
+		TS_ASSERT(stream);
+		checkClip(stream, 1000, 1);
+		delete stream;
+
+		stream = PCMCacheMan.find("c");
+		TS_ASSERT(stream);
+		checkClip(stream, 1000, 3);
+		delete stream;
+
+		// Shrinking the budget evicts right away
+		PCMCacheMan.setBudget(1000 * sizeof(int16));
+		TS_ASSERT_EQUALS(PCMCacheMan.getNumClips(), 1u);
+		TS_ASSERT_EQUALS(PCMCacheMan.getEvictions(), evictions + 2);
+		TS_ASSERT(!PCMCacheMan.find("a"));
+	}
+
+	void test_stream_outlives_eviction() {
+		Audio::RewindableAudioStream *added = PCMCacheMan.add("clip", createClip(500, 4));
+		Audio::SeekableAudioStream *found = PCMCacheMan.find("clip");
+
+		PCMCacheMan.clear();
+		TS_ASSERT_EQUALS(PCMCacheMan.getNumClips(), 0u);
+		TS_ASSERT_EQUALS(PCMCacheMan.getSize(), 0u);
+
+		checkClip(added, 500, 4);
+		delete added;
+		checkClip(found, 500, 4);
+		delete found;
+	}
+
+	void test_too_long() {
+		PCMCacheMan.setMaxClipSize(100 * sizeof(int16));
+
+		Audio::SeekableAudioStream *clip = createClip(101, 5);
+		Audio::RewindableAudioStream *added = PCMCacheMan.add("long", clip);
+
+		// The stream is handed back, rewound, and the clip is not cached
+		TS_ASSERT_EQUALS(added, clip);
+		TS_ASSERT_EQUALS(PCMCacheMan.getNumClips(), 0u);
+		checkClip(added, 101, 5);
+
+		// The next attempt does not touch the stream at all
+		TS_ASSERT(added->rewind());
+		TS_ASSERT_EQUALS(PCMCacheMan.add("long", added), added);
+		checkClip(added, 101, 5);
+		delete added;
+	}
+
+private:
+	static int16 sampleAt(uint32 i, int seed) {
+		return (int16)(i * 37 * seed - 12345);
+	}
+
+	/** A mono 16 bits clip of numSamples samples, depending on seed */
+	static Audio::SeekableAudioStream *createClip(uint32 numSamples, int seed) {
+		byte *data = (byte *)malloc(numSamples * sizeof(int16));
+		for (uint32 i = 0; i < numSamples; i++)
+			WRITE_LE_UINT16(data + i * sizeof(int16), sampleAt(i, seed));
+
+		return Audio::makeRawStream(data, numSamples * sizeof(int16), 22050,
+				Audio::FLAG_16BITS | Audio::FLAG_LITTLE_ENDIAN, DisposeAfterUse::YES);
+	}
+
+	/** Check a stream plays the clip created with createClip */
+	static void checkClip(Audio::AudioStream *stream, uint32 numSamples, int seed) {
+		int16 *buffer = new int16[numSamples + 1];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, numSamples + 1), (int)numSamples);
+		TS_ASSERT(stream->endOfData());
+
+		bool same = true;
+		for (uint32 i = 0; i < numSamples; i++)
+			same = same && buffer[i] == sampleAt(i, seed);
+		TS_ASSERT(same);
+
+		delete[] buffer;
+	}
+};
@@ -0,0 +1,95 @@
+#ifndef TEST_BENCHMARK_H
+#define TEST_BENCHMARK_H
+
+// Benchmarks measure time with the C library clock and load their
+// reference data with stdio.
+#define FORBIDDEN_SYMBOL_ALLOW_ALL
+
+#include "common/scummsys.h"
+#include "common/str.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/**
+ * Helpers shared by the benchmarks, which are run with "make benchmark".
+ *
+ * Reference files which cannot be generated by the benchmarks themselves
+ * are looked up in the directory named by the BENCHMARK_DATA environment
+ * variable. Benchmarks whose reference file is missing are skipped.
+ */
+namespace Benchmark {
+
+/** Minimum time in seconds a benchmark is repeated for. */
+static const double kMinDuration = 0.5;
+
+/** Process time in seconds. */
+static inline double getTime() {
+	return (double)clock() / CLOCKS_PER_SEC;
+}
+
+/**
+ * Print the throughput of a benchmark.
+ *
+ * @param name		what was measured
+ * @param units		how many units (samples, pixels, bytes...) were processed
+ * @param unit		name of the unit
+ * @param seconds	how long it took
+ */
+static inline void report(const char *name, double units, const char *unit, double seconds) {
+	if (units <= 0 || seconds <= 0) {
+		printf("\n  %-40s no data\n", name);
+		return;
+	}
+	printf("\n  %-40s %14.0f %s/s %10.2f ns/%s", name, units / seconds, unit, seconds * 1e9 / units, unit);
+}
+
+static inline void skip(const char *name, const char *reason) {
+	printf("\n  %-40s skipped: %s", name, reason);
+}
+
+/**
+ * Load a reference file from the BENCHMARK_DATA directory into memory.
+ *
+ * @param filename	name of the file inside BENCHMARK_DATA
+ * @param size		set to the size of the file
+ * @return the file contents, to be freed with free(), or 0 if the file
+ *         is not available
+ */
+static inline byte *loadDataFile(const char *filename, uint32 &size) {
+	const char *dir = getenv("BENCHMARK_DATA");
+	if (!dir)
+		return 0;
+
+	Common::String path = Common::String::format("%s/%s", dir, filename);
+	FILE *file = fopen(path.c_str(), "rb");
+	if (!file)
+		return 0;
+
+	fseek(file, 0, SEEK_END);
+	size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	byte *data = (byte *)malloc(size);
+	if (fread(data, 1, size, file) != size) {
+		free(data);
+		fclose(file);
+		return 0;
+	}
+	fclose(file);
+
+	return data;
+}
+
+/** Fill a buffer with reproducible pseudo-random bytes. */
+static inline void fillRandom(byte *data, uint32 size, uint32 seed = 1) {
+	for (uint32 i = 0; i < size; ++i) {
+		seed = seed * 1103515245 + 12345;
+		data[i] = (seed >> 16) & 0xFF;
+	}
+}
+
+} // End of namespace Benchmark
+
+#endif
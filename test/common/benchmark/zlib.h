@@ -0,0 +1,69 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+namespace {
+
+// About the size of the largest compressed Grim resources
+const uint32 kGZipDataSize = 4 * 1024 * 1024;
+
+/** Seek to random positions and read a few bytes, reporting the seeks per second. */
+void benchmarkGZipSeeks(const char *name, const byte *compressed, uint32 compressedSize, uint32 checkpointInterval) {
+	Common::SeekableReadStream *stream = Common::wrapCompressedReadStream(
+			new Common::MemoryReadStream(compressed, compressedSize), 0, checkpointInterval);
+
+	// A first pass over the data, as a game loading the resource would
+	byte buffer[256];
+	while (!stream->eos())
+		stream->read(buffer, sizeof(buffer));
+
+	double seeks = 0;
+	double elapsed = 0;
+	uint32 rng = 1;
+	const double start = Benchmark::getTime();
+
+	do {
+		for (int n = 0; n < 8; n++) {
+			rng = rng * 1103515245 + 12345;
+			stream->seek((rng >> 8) % (kGZipDataSize - sizeof(buffer)));
+			stream->read(buffer, sizeof(buffer));
+			seeks++;
+		}
+
+		elapsed = Benchmark::getTime() - start;
+	} while (elapsed < Benchmark::kMinDuration);
+
+	Benchmark::report(name, seeks, "seek", elapsed);
+	delete stream;
+}
+
+} // End of anonymous namespace
+
+class ZlibBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void test_gzip_seek() {
+		byte *data = new byte[kGZipDataSize];
+		uint32 rng = 7;
+		for (uint32 i = 0; i < kGZipDataSize; i++) {
+			rng = rng * 1103515245 + 12345;
+			data[i] = 'a' + ((i / 3) % 13) + ((rng >> 16) % 4);
+		}
+
+		Common::MemoryWriteStreamDynamic *output = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(output);
+		gzip->write(data, kGZipDataSize);
+		gzip->finalize();
+		byte *compressed = output->getData();
+		uint32 compressedSize = output->size();
+		delete gzip;
+		delete[] data;
+
+		benchmarkGZipSeeks("GZip random seek", compressed, compressedSize, 0);
+		benchmarkGZipSeeks("GZip random seek, 1 MB checkpoints", compressed, compressedSize, 1024 * 1024);
+		benchmarkGZipSeeks("GZip random seek, 256 KB checkpoints", compressed, compressedSize, 256 * 1024);
+		benchmarkGZipSeeks("GZip random seek, 64 KB checkpoints", compressed, compressedSize, 64 * 1024);
+
+		free(compressed);
+	}
+};
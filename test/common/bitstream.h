@@ -255,4 +255,53 @@ public:
 		tmpl_align_16<Common::MemoryReadStream, Common::BitStream16BELSB>();
 		tmpl_align_16<Common::BitStreamMemoryStream, Common::BitStreamMemory16BELSB>();
 	}
+
+private:
+	template<class BS, class MBS>
+	void tmpl_memory_matches_stream() {
+		// An odd size, so that the end of the buffer isn't aligned to the data values
+		byte contents[61];
+		for (uint i = 0; i < sizeof(contents); i++)
+			contents[i] = (byte)(i * 73 + 41);
+
+		Common::MemoryReadStream ms(contents, sizeof(contents));
+		Common::BitStreamMemoryStream mms(contents, sizeof(contents));
+
+		BS bs(ms);
+		MBS mbs(mms);
+		TS_ASSERT_EQUALS(mbs.size(), bs.size());
+
+		// Mix reads, peeks and skips of all sizes, up to past the end of the data
+		for (uint i = 0; bs.pos() < bs.size() + 64; i++) {
+			const uint n = (i * 7) % 33;
+
+			switch (i % 4) {
+			case 0:
+				TS_ASSERT_EQUALS(mbs.getBits(n), bs.getBits(n));
+				break;
+			case 1:
+				TS_ASSERT_EQUALS(mbs.peekBits(n), bs.peekBits(n));
+				break;
+			case 2:
+				TS_ASSERT_EQUALS(mbs.getBit(), bs.getBit());
+				break;
+			default:
+				mbs.skip(n + 40);
+				bs.skip(n + 40);
+				break;
+			}
+
+			TS_ASSERT_EQUALS(mbs.pos(), bs.pos());
+			TS_ASSERT_EQUALS(mbs.eos(), bs.eos());
+		}
+	}
+public:
+	void test_memory_matches_stream() {
+		tmpl_memory_matches_stream<Common::BitStream8MSB, Common::BitStreamMemory8MSB>();
+		tmpl_memory_matches_stream<Common::BitStream8LSB, Common::BitStreamMemory8LSB>();
+		tmpl_memory_matches_stream<Common::BitStream16LELSB, Common::BitStreamMemory16LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream16BEMSB, Common::BitStreamMemory16BEMSB>();
+		tmpl_memory_matches_stream<Common::BitStream32LELSB, Common::BitStreamMemory32LELSB>();
+		tmpl_memory_matches_stream<Common::BitStream32BEMSB, Common::BitStreamMemory32BEMSB>();
+	}
 };
@@ -0,0 +1,67 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/fft.h"
+#include "common/cosinetables.h"
+
+class FFTTestSuite : public CxxTest::TestSuite
+{
+	public:
+	void test_fft() {
+		// Covers the unrolled small transforms and the larger passes
+		for (int bits = 2; bits <= 10; bits++) {
+			for (int inverse = 0; inverse < 2; inverse++) {
+				const int n = 1 << bits;
+
+				Common::Complex *z = new Common::Complex[n];
+				for (int i = 0; i < n; i++) {
+					z[i].re = (float)((i * 37) % 17) / 17.0f - 0.5f;
+					z[i].im = (float)((i * 11) % 13) / 13.0f - 0.5f;
+				}
+
+				// Straightforward DFT of the input
+				double *expectedRe = new double[n];
+				double *expectedIm = new double[n];
+				const double sign = inverse ? 1.0 : -1.0;
+				for (int k = 0; k < n; k++) {
+					expectedRe[k] = expectedIm[k] = 0.0;
+					for (int i = 0; i < n; i++) {
+						const double a = sign * 2.0 * M_PI * i * k / n;
+						expectedRe[k] += z[i].re * cos(a) - z[i].im * sin(a);
+						expectedIm[k] += z[i].re * sin(a) + z[i].im * cos(a);
+					}
+				}
+
+				Common::FFT fft(bits, inverse);
+				fft.permute(z);
+				fft.calc(z);
+
+				for (int k = 0; k < n; k++) {
+					TS_ASSERT_DELTA(z[k].re, expectedRe[k], 1e-3);
+					TS_ASSERT_DELTA(z[k].im, expectedIm[k], 1e-3);
+				}
+
+				delete[] expectedRe;
+				delete[] expectedIm;
+				delete[] z;
+			}
+		}
+	}
+
+	void test_shared_tables() {
+		const Common::CosineTable *table = Common::CosineTable::acquire(256);
+		const Common::CosineTable *other = Common::CosineTable::acquire(512);
+		TS_ASSERT_EQUALS(Common::CosineTable::acquire(256), table);
+		TS_ASSERT_DIFFERS(other, table);
+
+		TS_ASSERT_DELTA(table->at(0), 1.0f, 1e-6);
+		TS_ASSERT_DELTA(table->at(32), 0.70710678f, 1e-6);
+
+		Common::CosineTable::release(other);
+		Common::CosineTable::release(table);
+
+		// Still referenced once
+		TS_ASSERT_EQUALS(Common::CosineTable::acquire(256), table);
+		Common::CosineTable::release(table);
+		Common::CosineTable::release(table);
+	}
+};
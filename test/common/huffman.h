@@ -2,6 +2,79 @@
 #include "common/huffman.h"
 #include "common/bitstream.h"
 #include "common/memstream.h"
+#include "common/array.h"
+
+namespace {
+
+/** Assign canonical codes to the given code lengths. */
+void buildCanonicalCodes(const Common::Array<uint8> &lengths, Common::Array<uint32> &codes) {
+	codes.resize(lengths.size());
+
+	uint32 code = 0;
+	for (uint8 length = 1; length <= 32; length++) {
+		for (uint i = 0; i < lengths.size(); i++)
+			if (lengths[i] == length)
+				codes[i] = code++;
+		code <<= 1;
+	}
+}
+
+/** Write the codes of the given symbols to a buffer, in MSB or LSB first bit order. */
+void encodeSymbols(const Common::Array<uint32> &codes, const Common::Array<uint8> &lengths,
+		const Common::Array<uint32> &symbols, bool msb, Common::Array<byte> &data) {
+	uint32 bitCount = 0;
+	for (uint i = 0; i < symbols.size(); i++)
+		bitCount += lengths[symbols[i]];
+
+	data.resize((bitCount + 7) / 8);
+	memset(data.begin(), 0, data.size());
+
+	uint32 pos = 0;
+	for (uint i = 0; i < symbols.size(); i++) {
+		const uint32 symbol = symbols[i];
+		for (int bit = lengths[symbol] - 1; bit >= 0; bit--, pos++) {
+			if (!((codes[symbol] >> bit) & 1))
+				continue;
+
+			if (msb)
+				data[pos / 8] |= 0x80 >> (pos % 8);
+			else
+				data[pos / 8] |= 1 << (pos % 8);
+		}
+	}
+}
+
+template<class BITSTREAM>
+void checkDecode(const Common::Array<uint8> &lengths, bool msb) {
+	Common::Array<uint32> codes;
+	buildCanonicalCodes(lengths, codes);
+
+	Common::Array<uint32> symbols;
+	for (uint i = 0; i < 2000; i++)
+		symbols.push_back((i * 7919 + i / 3) % lengths.size());
+
+	Common::Array<byte> data;
+	encodeSymbols(codes, lengths, symbols, msb, data);
+
+	Common::Huffman<BITSTREAM> h(0, lengths.size(), codes.begin(), lengths.begin());
+
+	Common::MemoryReadStream ms(data.begin(), data.size());
+	BITSTREAM bs(ms);
+
+	for (uint i = 0; i < symbols.size(); i++)
+		TS_ASSERT_EQUALS(h.getSymbol(bs), symbols[i]);
+
+	bs.rewind();
+
+	Common::Array<uint32> decoded;
+	decoded.resize(symbols.size());
+	h.getSymbols(bs, decoded.size(), decoded.begin());
+
+	for (uint i = 0; i < symbols.size(); i++)
+		TS_ASSERT_EQUALS(decoded[i], symbols[i]);
+}
+
+} // End of anonymous namespace
 
 /**
 * A test suite for the Huffman decoder in common/huffman.h
@@ -94,4 +167,39 @@ class HuffmanTestSuite : public CxxTest::TestSuite {
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[5]);
 		TS_ASSERT_EQUALS(h.getSymbol(bs), expected[6]);
 	}
+
+	void test_long_codes() {
+		// 1, 01, 001, ... up to two codes of 20 bits, which take three table levels
+		Common::Array<uint8> lengths;
+		for (uint8 length = 1; length <= 20; length++)
+			lengths.push_back(length);
+		lengths.push_back(20);
+
+		checkDecode<Common::BitStream8MSB>(lengths, true);
+		checkDecode<Common::BitStream8LSB>(lengths, false);
+	}
+
+	void test_wide_sub_tables() {
+		// Three short codes, and 256 codes of 10 bits sharing the remaining prefix
+		Common::Array<uint8> lengths;
+		for (uint i = 0; i < 3; i++)
+			lengths.push_back(2);
+		for (uint i = 0; i < 256; i++)
+			lengths.push_back(10);
+
+		checkDecode<Common::BitStream8MSB>(lengths, true);
+		checkDecode<Common::BitStream8LSB>(lengths, false);
+	}
+
+	void test_wide_sub_tables_long_root() {
+		// As above, but with codes past the 10-bit root table
+		Common::Array<uint8> lengths;
+		for (uint i = 0; i < 3; i++)
+			lengths.push_back(2);
+		for (uint i = 0; i < 1024; i++)
+			lengths.push_back(12);
+
+		checkDecode<Common::BitStream8MSB>(lengths, true);
+		checkDecode<Common::BitStream8LSB>(lengths, false);
+	}
 };
@@ -47,4 +47,19 @@ class MD5TestSuite : public CxxTest::TestSuite {
 		}
 	}
 
+	void test_md5Context() {
+		for (int i = 0; i < 7; i++) {
+			// Add the data in uneven blocks, which straddle the 64 bytes of the MD5 blocks
+			const uint8 *data = (const uint8 *)md5_test_string[i];
+			uint32 length = strlen(md5_test_string[i]);
+
+			Common::MD5Context context;
+			uint32 block = 1;
+			for (uint32 pos = 0; pos < length; pos += block, block += 7) {
+				context.update(data + pos, MIN(block, length - pos));
+			}
+
+			TS_ASSERT_EQUALS(context.finishAsString(), md5_test_digest[i]);
+		}
+	}
 };
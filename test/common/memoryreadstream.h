@@ -104,4 +104,25 @@ class MemoryReadStreamTestSuite : public CxxTest::TestSuite {
 		ms.seek(0, SEEK_SET);
 		TS_ASSERT(!ms.eos());
 	}
+
+	void test_view_outlives_parent_reference() {
+		byte *contents = (byte *)malloc(6);
+		memcpy(contents, "abcdef", 6);
+		Common::SharedPtr<Common::MemoryReadStream> parent(new Common::MemoryReadStream(contents, 6, DisposeAfterUse::YES));
+
+		Common::MemoryReadStreamView *view = new Common::MemoryReadStreamView(parent, 2, 3);
+		TS_ASSERT_EQUALS(parent.refCount(), 2);
+
+		// The view keeps the parent alive once the archive lets go of it
+		Common::MemoryReadStreamView::releaseParent(parent);
+		TS_ASSERT(!parent);
+
+		TS_ASSERT_EQUALS(view->size(), 3);
+		TS_ASSERT_EQUALS(view->readByte(), 'c');
+		TS_ASSERT_EQUALS(view->readByte(), 'd');
+		TS_ASSERT_EQUALS(view->readByte(), 'e');
+		view->readByte();
+		TS_ASSERT(view->eos());
+		delete view;
+	}
 };
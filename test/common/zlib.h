@@ -0,0 +1,91 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "common/zlib.h"
+
+class ZlibTestSuite : public CxxTest::TestSuite {
+public:
+	void test_seek_checkpoints() {
+		const uint32 size = 512 * 1024;
+		byte *data = createData(size);
+
+		uint32 compressedSize;
+		byte *compressed = compress(data, size, compressedSize);
+
+		Common::SeekableReadStream *plain = Common::wrapCompressedReadStream(
+				new Common::MemoryReadStream(compressed, compressedSize));
+		Common::SeekableReadStream *indexed = Common::wrapCompressedReadStream(
+				new Common::MemoryReadStream(compressed, compressedSize), 0, 16 * 1024);
+		TS_ASSERT_EQUALS(indexed->size(), (int32)size);
+
+		// The first pass reads everything, recording the checkpoints
+		byte *buffer = new byte[size];
+		TS_ASSERT_EQUALS(indexed->read(buffer, size), size);
+		TS_ASSERT_SAME_DATA(buffer, data, size);
+
+		uint32 rng = 1;
+		for (uint i = 0; i < 200; i++) {
+			rng = rng * 1103515245 + 12345;
+			uint32 offset = (rng >> 8) % size;
+			uint32 length = MIN<uint32>(size - offset, (rng >> 4) % 4096);
+
+			if (i % 3 == 0) {
+				TS_ASSERT(indexed->seek((int32)offset - indexed->pos(), SEEK_CUR));
+			} else if (i % 3 == 1) {
+				TS_ASSERT(indexed->seek((int32)offset - (int32)size, SEEK_END));
+			} else {
+				TS_ASSERT(indexed->seek(offset));
+			}
+			TS_ASSERT_EQUALS(indexed->pos(), (int32)offset);
+			TS_ASSERT_EQUALS(indexed->read(buffer, length), length);
+			TS_ASSERT_SAME_DATA(buffer, data + offset, length);
+
+			if (i % 20 == 0) {
+				// The stream without checkpoints gives the same results
+				TS_ASSERT(plain->seek(offset));
+				TS_ASSERT_EQUALS(plain->read(buffer, length), length);
+				TS_ASSERT_SAME_DATA(buffer, data + offset, length);
+			}
+		}
+
+		// Reading up to the end still works after resuming from a checkpoint
+		TS_ASSERT(indexed->seek(size - 1000));
+		TS_ASSERT_EQUALS(indexed->read(buffer, 2000), 1000u);
+		TS_ASSERT(indexed->eos());
+		TS_ASSERT_SAME_DATA(buffer, data + size - 1000, 1000);
+
+		delete plain;
+		delete indexed;
+		delete[] buffer;
+		delete[] data;
+		free(compressed);
+	}
+
+private:
+	/** Data which compresses to many deflate blocks of different kinds */
+	static byte *createData(uint32 size) {
+		byte *data = new byte[size];
+		uint32 rng = 7;
+		for (uint32 i = 0; i < size; i++) {
+			rng = rng * 1103515245 + 12345;
+			if ((i / 4096) % 4 == 3) {
+				data[i] = rng >> 16;
+			} else {
+				data[i] = 'a' + ((i / 3) % 13) + ((rng >> 16) % 4);
+			}
+		}
+		return data;
+	}
+
+	static byte *compress(const byte *data, uint32 size, uint32 &compressedSize) {
+		Common::MemoryWriteStreamDynamic *output = new Common::MemoryWriteStreamDynamic(DisposeAfterUse::NO);
+		Common::WriteStream *gzip = Common::wrapCompressedWriteStream(output);
+		gzip->write(data, size);
+		gzip->finalize();
+
+		byte *compressed = output->getData();
+		compressedSize = output->size();
+		delete gzip;
+		return compressed;
+	}
+};
@@ -0,0 +1,163 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+
+#include "engines/grim/movie/codecs/blocks_sse2.h"
+
+/**
+ * Check the SSE2 block helpers of the SMUSH codecs against the scalar
+ * code of Blocky16 and Codec48 they replace, for all the source offsets
+ * the codecs use them with.
+ */
+class SmushBlocksTestSuite : public CxxTest::TestSuite {
+public:
+	void test_copy_rows_8() {
+#ifdef __SSE2__
+		// Blocky16 level 2 and Codec48 motion copies, 4 rows of 8 bytes
+		// for Blocky16 and 8 rows for Codec48. Sources between 1 and 7 bytes
+		// before the destination keep the scalar code.
+		for (int offset = -3 * kPitch - 16; offset <= 3 * kPitch; offset++) {
+			if (offset > -8 && offset < 0)
+				continue;
+
+			for (int rows = 4; rows <= 8; rows += 4) {
+				byte expected[kBufferSize], actual[kBufferSize];
+				fill(expected, offset);
+				memcpy(actual, expected, kBufferSize);
+
+				const int dst = kDstOffset;
+				copyRowsScalar(expected + dst, expected + dst + offset, 8, rows);
+				Grim::copyRows8SSE2(actual + dst, kPitch, actual + dst + offset, kPitch, rows);
+				TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+			}
+		}
+#endif
+	}
+
+	void test_copy_rows_16() {
+#ifdef __SSE2__
+		// Blocky16 level 1 motion copies, 8 rows of 16 bytes
+		for (int offset = -3 * kPitch - 32; offset <= 3 * kPitch; offset++) {
+			if (offset > -16 && offset < 0)
+				continue;
+
+			byte expected[kBufferSize], actual[kBufferSize];
+			fill(expected, offset);
+			memcpy(actual, expected, kBufferSize);
+
+			const int dst = kDstOffset;
+			copyRowsScalar(expected + dst, expected + dst + offset, 16, 8);
+			Grim::copyRows16SSE2(actual + dst, kPitch, actual + dst + offset, kPitch, 8);
+			TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+		}
+#endif
+	}
+
+	void test_copy_raw_block() {
+#ifdef __SSE2__
+		// Codec48 raw 8x8 blocks, stored without any padding
+		byte src[64];
+		fill(src, sizeof(src), 1);
+
+		byte expected[kBufferSize], actual[kBufferSize];
+		fill(expected, 2);
+		memcpy(actual, expected, kBufferSize);
+
+		for (int i = 0; i < 8; i++) {
+			WRITE_UINT32(expected + kDstOffset + kPitch * i, READ_UINT32(src + i * 8));
+			WRITE_UINT32(expected + kDstOffset + kPitch * i + 4, READ_UINT32(src + i * 8 + 4));
+		}
+		Grim::copyRows8SSE2(actual + kDstOffset, kPitch, src, 8, 8);
+		TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+#endif
+	}
+
+	void test_fill_rows() {
+#ifdef __SSE2__
+		// Blocky16 fills with a repeated 16-bit color
+		const uint16 colors[] = { 0, 0x1234, 0x8001, 0xFFFF };
+		for (uint c = 0; c < ARRAYSIZE(colors); c++) {
+			const uint32 t = (colors[c] << 16) | colors[c];
+
+			byte expected[kBufferSize], actual[kBufferSize];
+			fill(expected, c);
+			memcpy(actual, expected, kBufferSize);
+
+			for (int i = 0; i < 4; i++) {
+				WRITE_UINT32(expected + kDstOffset + kPitch * i, t);
+				WRITE_UINT32(expected + kDstOffset + kPitch * i + 4, t);
+			}
+			Grim::fillRows8SSE2(actual + kDstOffset, kPitch, t, 4);
+			TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+
+			for (int i = 0; i < 8; i++) {
+				for (int j = 0; j < 16; j += 4)
+					WRITE_UINT32(expected + kDstOffset + kPitch * i + j, t);
+			}
+			Grim::fillRows16SSE2(actual + kDstOffset, kPitch, t, 8);
+			TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+		}
+#endif
+	}
+
+	void test_scale_block() {
+#ifdef __SSE2__
+		// Codec48 2x scaled blocks
+		byte src[16];
+		fill(src, sizeof(src), 3);
+
+		byte expected[kBufferSize], actual[kBufferSize];
+		fill(expected, 4);
+		memcpy(actual, expected, kBufferSize);
+
+		byte *dst = expected + kDstOffset;
+		const byte *s = src;
+		for (int i = 0; i < 4; i++) {
+			for (int j = 0; j < 4; j++) {
+				uint16 pixels = s[j];
+				pixels = (pixels << 8) | pixels;
+				WRITE_UINT16(dst + j * 2, pixels);
+				WRITE_UINT16(dst + kPitch + j * 2, pixels);
+			}
+			s += 4;
+			dst += kPitch * 2;
+		}
+		Grim::scaleBlockSSE2(actual + kDstOffset, kPitch, src);
+		TS_ASSERT_SAME_DATA(actual, expected, kBufferSize);
+#endif
+	}
+
+private:
+	enum {
+		kPitch = 40,
+		kBufferSize = kPitch * 16,
+		// The destination block, with room for the sources all around it
+		kDstOffset = kPitch * 4 + 20
+	};
+
+	static void fill(byte *buffer, uint32 size, int seed) {
+		uint32 rng = seed;
+		for (uint32 i = 0; i < size; i++) {
+			rng = rng * 1103515245 + 12345;
+			buffer[i] = rng >> 16;
+		}
+	}
+
+	static void fill(byte *buffer, int seed) {
+		fill(buffer, kBufferSize, seed);
+	}
+
+	/** The four bytes at a time copies of the scalar code */
+	static void copyRowsScalar(byte *dst, const byte *src, int width, int rows) {
+		for (int i = 0; i < rows; i++) {
+			for (int j = 0; j < width; j += 4) {
+				dst[j + 0] = src[j + 0];
+				dst[j + 1] = src[j + 1];
+				dst[j + 2] = src[j + 2];
+				dst[j + 3] = src[j + 3];
+			}
+			dst += kPitch;
+			src += kPitch;
+		}
+	}
+};
@@ -0,0 +1,94 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "engines/myst3/lzo.h"
+#include "engines/myst3/lzo_stream.h"
+
+namespace {
+
+// About the size of a large modded movie
+const uint32 kLzoDataSize = 4 * 1024 * 1024;
+
+/** Compress kLzoDataSize bytes of generated data, with the archive resource header. */
+byte *createLzoResource(uint32 &compressedSize) {
+	byte *data = new byte[kLzoDataSize];
+	uint32 rng = 7;
+	for (uint32 i = 0; i < kLzoDataSize; i++) {
+		rng = rng * 1103515245 + 12345;
+		if (i >= 40000 && (i / 1000) % 3 == 0) {
+			data[i] = data[i - 40000];
+		} else {
+			data[i] = 'a' + ((i / 5) % 17) + ((rng >> 16) % 3);
+		}
+	}
+
+	size_t maxSize = Myst3::lzoCompressWorstSize(kLzoDataSize);
+	byte *compressed = new byte[maxSize + 8];
+	WRITE_LE_UINT32(compressed, MKTAG('L', 'Z', 'O', 'X'));
+	WRITE_LE_UINT32(compressed + 4, kLzoDataSize);
+
+	size_t written = 0;
+	Myst3::lzoCompress(data, kLzoDataSize, compressed + 8, maxSize, written);
+	compressedSize = written + 8;
+
+	delete[] data;
+	return compressed;
+}
+
+} // End of anonymous namespace
+
+class Myst3LzoBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void test_decompress() {
+		uint32 compressedSize;
+		byte *compressed = createLzoResource(compressedSize);
+		byte *output = new byte[kLzoDataSize];
+
+		double bytes = 0;
+		double elapsed = 0;
+		const double start = Benchmark::getTime();
+
+		do {
+			size_t written = 0;
+			Myst3::lzoDecompress(compressed + 8, compressedSize - 8, output, kLzoDataSize, written);
+			bytes += written;
+
+			elapsed = Benchmark::getTime() - start;
+		} while (elapsed < Benchmark::kMinDuration);
+
+		Benchmark::report("LZO decompress at once", bytes, "byte", elapsed);
+
+		delete[] output;
+		delete[] compressed;
+	}
+
+	void test_stream() {
+		uint32 compressedSize;
+		byte *compressed = createLzoResource(compressedSize);
+
+		double bytes = 0;
+		double elapsed = 0;
+		const double start = Benchmark::getTime();
+
+		do {
+			// Read in small blocks, as the video decoders do
+			Common::SeekableReadStream *stream = Myst3::createLzoReadStream(
+					new Common::MemoryReadStream(compressed, compressedSize), nullptr);
+
+			byte buffer[4096];
+			uint32 read;
+			while ((read = stream->read(buffer, sizeof(buffer))) > 0)
+				bytes += read;
+
+			delete stream;
+
+			elapsed = Benchmark::getTime() - start;
+		} while (elapsed < Benchmark::kMinDuration);
+
+		Benchmark::report("LZO stream, 4 KB reads", bytes, "byte", elapsed);
+
+		delete[] compressed;
+	}
+};
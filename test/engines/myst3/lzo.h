@@ -0,0 +1,111 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "engines/myst3/lzo.h"
+#include "engines/myst3/lzo_stream.h"
+
+class Myst3LzoTestSuite : public CxxTest::TestSuite {
+public:
+	void test_round_trip() {
+		const uint32 size = 64 * 1024;
+		byte *data = createData(size);
+
+		uint32 compressedSize;
+		byte *compressed = compress(data, size, compressedSize);
+
+		// Small resources are decompressed at once
+		Common::SeekableReadStream *stream = Myst3::createLzoReadStream(
+				new Common::MemoryReadStream(compressed, compressedSize), nullptr);
+		TS_ASSERT_EQUALS(stream->size(), (int32)size);
+
+		byte *buffer = new byte[size];
+		TS_ASSERT_EQUALS(stream->read(buffer, size), size);
+		TS_ASSERT_SAME_DATA(buffer, data, size);
+
+		delete stream;
+		delete[] buffer;
+		delete[] compressed;
+		delete[] data;
+	}
+
+	void test_streaming() {
+		const uint32 size = 1024 * 1024 + 123;
+		byte *data = createData(size);
+
+		uint32 compressedSize;
+		byte *compressed = compress(data, size, compressedSize);
+
+		// Large resources are decompressed in chunks, as they are read
+		Common::SeekableReadStream *stream = Myst3::createLzoReadStream(
+				new Common::MemoryReadStream(compressed, compressedSize), nullptr);
+		TS_ASSERT_EQUALS(stream->size(), (int32)size);
+
+		byte *buffer = new byte[size];
+		uint32 offset = 0;
+		uint32 rng = 3;
+		while (offset < size) {
+			rng = rng * 1103515245 + 12345;
+			uint32 length = MIN<uint32>(size - offset, (rng >> 8) % 20000);
+			TS_ASSERT_EQUALS(stream->read(buffer + offset, length), length);
+			offset += length;
+		}
+		TS_ASSERT_SAME_DATA(buffer, data, size);
+
+		TS_ASSERT(!stream->eos());
+		TS_ASSERT_EQUALS(stream->read(buffer, 1), 0u);
+		TS_ASSERT(stream->eos());
+
+		// Seeking backwards starts again from the beginning, forwards skips data
+		for (uint i = 0; i < 50; i++) {
+			rng = rng * 1103515245 + 12345;
+			uint32 position = (rng >> 8) % size;
+			uint32 length = MIN<uint32>(size - position, (rng >> 4) % 4096);
+
+			TS_ASSERT(stream->seek(position));
+			TS_ASSERT_EQUALS(stream->pos(), (int32)position);
+			TS_ASSERT_EQUALS(stream->read(buffer, length), length);
+			TS_ASSERT_SAME_DATA(buffer, data + position, length);
+		}
+
+		TS_ASSERT(!stream->seek(size + 1));
+		TS_ASSERT(stream->seek(-1000, SEEK_END));
+		TS_ASSERT_EQUALS(stream->read(buffer, 2000), 1000u);
+		TS_ASSERT_SAME_DATA(buffer, data + size - 1000, 1000);
+
+		delete stream;
+		delete[] buffer;
+		delete[] compressed;
+		delete[] data;
+	}
+
+private:
+	/** Generate data with both short and long distance repetitions */
+	static byte *createData(uint32 size) {
+		byte *data = new byte[size];
+		uint32 rng = 7;
+		for (uint32 i = 0; i < size; i++) {
+			rng = rng * 1103515245 + 12345;
+			if (i >= 40000 && (i / 1000) % 3 == 0) {
+				data[i] = data[i - 40000];
+			} else {
+				data[i] = 'a' + ((i / 5) % 17) + ((rng >> 16) % 3);
+			}
+		}
+		return data;
+	}
+
+	/** Compress data the way the resources are stored in the archives */
+	static byte *compress(const byte *data, uint32 size, uint32 &compressedSize) {
+		size_t maxSize = Myst3::lzoCompressWorstSize(size);
+		byte *compressed = new byte[maxSize + 8];
+		WRITE_LE_UINT32(compressed, MKTAG('L', 'Z', 'O', 'X'));
+		WRITE_LE_UINT32(compressed + 4, size);
+
+		size_t written = 0;
+		TS_ASSERT_EQUALS(Myst3::lzoCompress(data, size, compressed + 8, maxSize, written), Myst3::kLzoSuccess);
+		compressedSize = written + 8;
+		return compressed;
+	}
+};
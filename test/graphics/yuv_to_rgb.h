@@ -0,0 +1,136 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/surface.h"
+#include "graphics/yuv_to_rgb.h"
+#include "graphics/yuva_to_rgba.h"
+
+namespace {
+
+// Not a multiple of 8, so that both the vector and the table paths run
+const int kWidth = 38;
+const int kHeight = 6;
+
+const Graphics::PixelFormat kFormats[] = {
+	Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+	Graphics::PixelFormat(4, 8, 8, 8, 0, 16, 8, 0, 0),
+	Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+	Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15)
+};
+
+struct YUVPlanes {
+	byte y[kWidth * kHeight];
+	byte u[kWidth * kHeight];
+	byte v[kWidth * kHeight];
+	byte a[kWidth * kHeight];
+
+	YUVPlanes() {
+		// Covers the clipped ends of both luminance ranges
+		for (int i = 0; i < kWidth * kHeight; i++) {
+			y[i] = (i * 97) & 0xFF;
+			u[i] = (i * 61 + 7) & 0xFF;
+			v[i] = (i * 151 + 3) & 0xFF;
+			a[i] = (i * 29) & 0xFF;
+		}
+	}
+};
+
+/** Create a surface over a buffer of width x kHeight pixels. */
+Graphics::Surface createSurface(byte *pixels, int width, const Graphics::PixelFormat &format) {
+	Graphics::Surface s;
+	s.w = width;
+	s.h = kHeight;
+	s.pitch = width * format.bytesPerPixel;
+	s.format = format;
+	s.setPixels(pixels);
+	return s;
+}
+
+/** Copy a narrow surface into column x of a kWidth wide buffer. */
+void copyColumns(byte *dst, int x, const Graphics::Surface &src) {
+	const int bpp = src.format.bytesPerPixel;
+	for (int y = 0; y < kHeight; y++)
+		memcpy(dst + (y * kWidth + x) * bpp, src.getBasePtr(0, y), src.w * bpp);
+}
+
+} // End of anonymous namespace
+
+/**
+ * The vectorized conversions must match the lookup tables exactly.
+ * Narrow conversions only ever use the tables, so each image is
+ * converted once whole and once a couple of columns at a time.
+ * The conversions expect the destination pitch to match the width.
+ */
+class YUVToRGBTestSuite : public CxxTest::TestSuite {
+public:
+	void test_convert444() {
+		YUVPlanes planes;
+		byte expected[kWidth * kHeight * 4];
+		byte actual[kWidth * kHeight * 4];
+		byte columns[2 * kHeight * 4];
+
+		for (uint f = 0; f < ARRAYSIZE(kFormats); f++) {
+			for (int scale = 0; scale < 2; scale++) {
+				const Graphics::YUVToRGBManager::LuminanceScale s = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+				Graphics::Surface dst = createSurface(actual, kWidth, kFormats[f]);
+				YUVToRGBMan.convert444(&dst, s, planes.y, planes.u, planes.v, kWidth, kHeight, kWidth, kWidth);
+
+				for (int x = 0; x < kWidth; x++) {
+					Graphics::Surface column = createSurface(columns, 1, kFormats[f]);
+					YUVToRGBMan.convert444(&column, s, planes.y + x, planes.u + x, planes.v + x, 1, kHeight, kWidth, kWidth);
+					copyColumns(expected, x, column);
+				}
+
+				TS_ASSERT_SAME_DATA(actual, expected, kWidth * kHeight * kFormats[f].bytesPerPixel);
+			}
+		}
+	}
+
+	void test_convert420() {
+		YUVPlanes planes;
+		byte expected[kWidth * kHeight * 4];
+		byte actual[kWidth * kHeight * 4];
+		byte columns[2 * kHeight * 4];
+
+		for (uint f = 0; f < ARRAYSIZE(kFormats); f++) {
+			for (int scale = 0; scale < 2; scale++) {
+				const Graphics::YUVToRGBManager::LuminanceScale s = scale ? Graphics::YUVToRGBManager::kScaleITU : Graphics::YUVToRGBManager::kScaleFull;
+
+				Graphics::Surface dst = createSurface(actual, kWidth, kFormats[f]);
+				YUVToRGBMan.convert420(&dst, s, planes.y, planes.u, planes.v, kWidth, kHeight, kWidth, kWidth / 2);
+
+				for (int x = 0; x < kWidth; x += 2) {
+					Graphics::Surface column = createSurface(columns, 2, kFormats[f]);
+					YUVToRGBMan.convert420(&column, s, planes.y + x, planes.u + x / 2, planes.v + x / 2, 2, kHeight, kWidth, kWidth / 2);
+					copyColumns(expected, x, column);
+				}
+
+				TS_ASSERT_SAME_DATA(actual, expected, kWidth * kHeight * kFormats[f].bytesPerPixel);
+			}
+		}
+	}
+
+	void test_convert420_alpha() {
+		YUVPlanes planes;
+		byte expected[kWidth * kHeight * 4];
+		byte actual[kWidth * kHeight * 4];
+		byte columns[2 * kHeight * 4];
+
+		for (uint f = 0; f < ARRAYSIZE(kFormats); f++) {
+			for (int scale = 0; scale < 2; scale++) {
+				const Graphics::YUVAToRGBAManager::LuminanceScale s = scale ? Graphics::YUVAToRGBAManager::kScaleITU : Graphics::YUVAToRGBAManager::kScaleFull;
+
+				Graphics::Surface dst = createSurface(actual, kWidth, kFormats[f]);
+				YUVAToRGBAMan.convert420(&dst, s, planes.y, planes.u, planes.v, planes.a, kWidth, kHeight, kWidth, kWidth / 2);
+
+				for (int x = 0; x < kWidth; x += 2) {
+					Graphics::Surface column = createSurface(columns, 2, kFormats[f]);
+					YUVAToRGBAMan.convert420(&column, s, planes.y + x, planes.u + x / 2, planes.v + x / 2, planes.a + x, 2, kHeight, kWidth, kWidth / 2);
+					copyColumns(expected, x, column);
+				}
+
+				TS_ASSERT_SAME_DATA(actual, expected, kWidth * kHeight * kFormats[f].bytesPerPixel);
+			}
+		}
+	}
+};
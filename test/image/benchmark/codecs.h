@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+
+#include "image/codecs/cinepak.h"
+#include "image/codecs/msrle.h"
+#include "image/codecs/msvideo1.h"
+#include "image/codecs/qtrle.h"
+#include "image/codecs/rpza.h"
+
+#include "test/image/reference/clips.h"
+
+namespace {
+
+const int kWidth = 640;
+const int kHeight = 480;
+
+// A key frame followed by frames that update part of the picture
+const int kClipLength = 8;
+
+/** Encode a clip of kClipLength frames, with the encoder of the given codec. */
+template<typename EncodeProc>
+CodecClips::Frame *createClip(EncodeProc encode) {
+	CodecClips::Random rng(1);
+	CodecClips::Frame *clip = new CodecClips::Frame[kClipLength];
+	for (int i = 0; i < kClipLength; i++)
+		encode(clip[i], rng, i == 0);
+	return clip;
+}
+
+/** Decode the clip in a loop, and report the frame and pixel rates. */
+void benchmarkDecoder(const char *name, Image::Codec &decoder, const CodecClips::Frame *clip) {
+	double frames = 0;
+	double elapsed = 0;
+	const double start = Benchmark::getTime();
+
+	do {
+		for (int i = 0; i < kClipLength; i++) {
+			Common::MemoryReadStream stream(clip[i].begin(), clip[i].size());
+			decoder.decodeFrame(stream);
+		}
+		frames += kClipLength;
+
+		elapsed = Benchmark::getTime() - start;
+	} while (elapsed < Benchmark::kMinDuration);
+
+	Benchmark::report(name, frames, "frame", elapsed);
+	Benchmark::report(name, frames * kWidth * kHeight, "pixel", elapsed);
+}
+
+struct EncodeQTRLE {
+	int bitsPerPixel;
+	void operator()(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) const {
+		CodecClips::encodeQTRLE(frame, kWidth, kHeight, bitsPerPixel, rng, keyframe);
+	}
+};
+
+struct EncodeMSVideo1 {
+	int bitsPerPixel;
+	void operator()(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) const {
+		CodecClips::encodeMSVideo1(frame, kWidth, kHeight, bitsPerPixel, rng, keyframe);
+	}
+};
+
+void encodeRPZA(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+	CodecClips::encodeRPZA(frame, kWidth, kHeight, rng, keyframe);
+}
+
+void encodeMSRLE(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+	CodecClips::encodeMSRLE(frame, kWidth, kHeight, rng, keyframe);
+}
+
+void encodeCinepak(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+	CodecClips::encodeCinepak(frame, kWidth, kHeight, rng, keyframe);
+}
+
+} // End of anonymous namespace
+
+class ImageCodecsBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void test_qtrle() {
+		static const int depths[] = { 16, 24, 32 };
+
+		for (uint i = 0; i < ARRAYSIZE(depths); i++) {
+			EncodeQTRLE encode = { depths[i] };
+			CodecClips::Frame *clip = createClip(encode);
+			Image::QTRLEDecoder decoder(kWidth, kHeight, depths[i]);
+
+			Common::String name = Common::String::format("QTRLE %d bpp", depths[i]);
+			benchmarkDecoder(name.c_str(), decoder, clip);
+			delete[] clip;
+		}
+	}
+
+	void test_msvideo1() {
+		static const int depths[] = { 8, 16 };
+
+		for (uint i = 0; i < ARRAYSIZE(depths); i++) {
+			EncodeMSVideo1 encode = { depths[i] };
+			CodecClips::Frame *clip = createClip(encode);
+			Image::MSVideo1Decoder decoder(kWidth, kHeight, depths[i]);
+
+			Common::String name = Common::String::format("MSVideo1 %d bpp", depths[i]);
+			benchmarkDecoder(name.c_str(), decoder, clip);
+			delete[] clip;
+		}
+	}
+
+	void test_rpza() {
+		CodecClips::Frame *clip = createClip(encodeRPZA);
+		Image::RPZADecoder decoder(kWidth, kHeight);
+		benchmarkDecoder("RPZA", decoder, clip);
+		delete[] clip;
+	}
+
+	void test_msrle() {
+		CodecClips::Frame *clip = createClip(encodeMSRLE);
+		Image::MSRLEDecoder decoder(kWidth, kHeight, 8);
+		benchmarkDecoder("MSRLE 8 bpp", decoder, clip);
+		delete[] clip;
+	}
+
+	void test_cinepak() {
+		CodecClips::Frame *clip = createClip(encodeCinepak);
+		Image::CinepakDecoder decoder(8);
+		benchmarkDecoder("Cinepak 8 bpp", decoder, clip);
+		delete[] clip;
+	}
+};
@@ -0,0 +1,161 @@
+#include <cxxtest/TestSuite.h>
+
+#include "image/codecs/cinepak.h"
+#include "image/codecs/msrle.h"
+#include "image/codecs/msvideo1.h"
+#include "image/codecs/qtrle.h"
+#include "image/codecs/rpza.h"
+
+#include "test/image/reference/clips.h"
+
+/**
+ * Decodes a few generated frames, a key frame and frames that update
+ * part of the picture, and compares each of them with the checksum of
+ * what the decoder produced when the test was written.
+ */
+class ImageCodecsTestSuite : public CxxTest::TestSuite {
+public:
+	void test_qtrle() {
+		static const char *const expected16[] = {
+			"bf4db8214a792807a78678cae31e6f36",
+			"a34bca3c61ffc1af905177eda9f5016e",
+			"668bac573e677400336a1ea4c1e8fae1",
+			"5643dc624d3b87158bca3691f3093114"
+		};
+		static const char *const expected24[] = {
+			"e585fc9b94532870f2fe7d520ac046df",
+			"118189544f0175c53eba23edac5817ee",
+			"ce1691dc297fc2b0c342a7b38e1b11dc",
+			"edfac0fbc8be0a190248d077663f93a7"
+		};
+		static const char *const expected32[] = {
+			"45d66078152229922ce41bba232156a5",
+			"041454accd3989423cbe510542f1a5cd",
+			"852a916ac8a4195e80bdde36244665c7",
+			"b26f27cfdd9d5378ff8c1f3d825fb02c"
+		};
+
+		Image::QTRLEDecoder decoder16(kWidth, kHeight, 16);
+		checkClip(decoder16, expected16, 1, encodeQTRLE16);
+		Image::QTRLEDecoder decoder24(kWidth, kHeight, 24);
+		checkClip(decoder24, expected24, 2, encodeQTRLE24);
+		Image::QTRLEDecoder decoder32(kWidth, kHeight, 32);
+		checkClip(decoder32, expected32, 3, encodeQTRLE32);
+	}
+
+	void test_msvideo1() {
+		static const char *const expected8[] = {
+			"7aaac24117bb01188faead57054831bf",
+			"79121813a73ab263ccb0fd1936dd29ff",
+			"eb1010f7d01b154b6d67f896c90af937",
+			"f33b206ca5856fc3dc010233e8d4d6e5"
+		};
+		static const char *const expected16[] = {
+			"ad31b7aeb6874ffdb84ea6fbcac5bf42",
+			"23d666a50106723571d142fb0b6585e6",
+			"1acaa8fed8e5cc2c9e4cbfd655d0e4f3",
+			"e4e8ea281b146b4c3aba1b74ddd40ba7"
+		};
+
+		Image::MSVideo1Decoder decoder8(kWidth, kHeight, 8);
+		checkClip(decoder8, expected8, 4, encodeMSVideo1_8);
+		Image::MSVideo1Decoder decoder16(kWidth, kHeight, 16);
+		checkClip(decoder16, expected16, 5, encodeMSVideo1_16);
+	}
+
+	void test_rpza() {
+		static const char *const expected[] = {
+			"5d1cb8590e2110eeeb2048e05a849449",
+			"b2b66fc41ec1d76aceb8ba07cbbb6182",
+			"167b743ce9c0760f1da58e46b2e351ea",
+			"11033365f79522d4df4f475a4c21315a"
+		};
+
+		Image::RPZADecoder decoder(kWidth, kHeight);
+		checkClip(decoder, expected, 6, encodeRPZA);
+	}
+
+	void test_msrle() {
+		static const char *const expected[] = {
+			"c8c43c258f1c5dc7130bedfe08a90535",
+			"2783fa1a9eb5129d2be5c0bf4de25ad2",
+			"f71a0783db1370dfac77b873f46aa31c",
+			"78590a560d475d5902e3d1e62a9f3e93"
+		};
+
+		Image::MSRLEDecoder decoder(kWidth, kHeight, 8);
+		checkClip(decoder, expected, 7, encodeMSRLE);
+	}
+
+	void test_cinepak() {
+		static const char *const expected[] = {
+			"952a0deeb464cf681adcd10c0e0c958c",
+			"f570866e43b708b11e1389b67a6bd06e",
+			"823bd7294a62f4e2b363007893734d1e",
+			"eb9e83d43b55a673c3763ffab129f03e"
+		};
+
+		Image::CinepakDecoder decoder(8);
+		checkClip(decoder, expected, 8, encodeCinepak);
+	}
+
+private:
+	enum {
+		kWidth = 64,
+		kHeight = 48,
+		kFrameCount = 4
+	};
+
+	typedef void (*EncodeProc)(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe);
+
+	static void encodeQTRLE16(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeQTRLE(frame, kWidth, kHeight, 16, rng, keyframe);
+	}
+
+	static void encodeQTRLE24(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeQTRLE(frame, kWidth, kHeight, 24, rng, keyframe);
+	}
+
+	static void encodeQTRLE32(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeQTRLE(frame, kWidth, kHeight, 32, rng, keyframe);
+	}
+
+	static void encodeMSVideo1_8(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeMSVideo1(frame, kWidth, kHeight, 8, rng, keyframe);
+	}
+
+	static void encodeMSVideo1_16(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeMSVideo1(frame, kWidth, kHeight, 16, rng, keyframe);
+	}
+
+	static void encodeRPZA(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeRPZA(frame, kWidth, kHeight, rng, keyframe);
+	}
+
+	static void encodeMSRLE(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeMSRLE(frame, kWidth, kHeight, rng, keyframe);
+	}
+
+	static void encodeCinepak(CodecClips::Frame &frame, CodecClips::Random &rng, bool keyframe) {
+		CodecClips::encodeCinepak(frame, kWidth, kHeight, rng, keyframe);
+	}
+
+	void checkClip(Image::Codec &decoder, const char *const (&expected)[kFrameCount], uint32 seed, EncodeProc encode) {
+		CodecClips::Random rng(seed);
+		CodecClips::Frame frame;
+
+		for (int i = 0; i < kFrameCount; i++) {
+			encode(frame, rng, i == 0);
+
+			Common::MemoryReadStream stream(frame.begin(), frame.size());
+			const Graphics::Surface *surface = decoder.decodeFrame(stream);
+			TS_ASSERT(surface);
+			if (!surface)
+				return;
+
+			TS_ASSERT_EQUALS(surface->w, kWidth);
+			TS_ASSERT_EQUALS(surface->h, kHeight);
+			TS_ASSERT_EQUALS(CodecClips::computeFrameMD5(*surface), expected[i]);
+		}
+	}
+};
@@ -0,0 +1,386 @@
+#ifndef TEST_IMAGE_REFERENCE_CLIPS_H
+#define TEST_IMAGE_REFERENCE_CLIPS_H
+
+#include "common/array.h"
+#include "common/md5.h"
+#include "common/memstream.h"
+#include "common/str.h"
+
+#include "graphics/surface.h"
+
+/**
+ * Encoders for synthetic clips of the image codecs, to check and measure
+ * the decoders with. The frames use every coding mode of their codec,
+ * chosen at random from a seed so that they can be generated again.
+ * Frames other than the key frame also skip parts of the picture, which
+ * then keep the contents of the previous frame.
+ */
+namespace CodecClips {
+
+typedef Common::Array<byte> Frame;
+
+/** Reproducible pseudo-random numbers. */
+class Random {
+public:
+	Random(uint32 seed) : _seed(seed) {}
+
+	/** A number between 0 and max - 1. */
+	uint32 next(uint32 max) {
+		_seed = _seed * 1103515245 + 12345;
+		return ((_seed >> 8) & 0xFFFFFF) % max;
+	}
+
+	byte nextByte() { return next(256); }
+
+private:
+	uint32 _seed;
+};
+
+static inline void putByte(Frame &frame, byte value) {
+	frame.push_back(value);
+}
+
+static inline void putUint16BE(Frame &frame, uint16 value) {
+	putByte(frame, value >> 8);
+	putByte(frame, value & 0xFF);
+}
+
+static inline void putUint16LE(Frame &frame, uint16 value) {
+	putByte(frame, value & 0xFF);
+	putByte(frame, value >> 8);
+}
+
+static inline void putUint24BE(Frame &frame, uint32 value) {
+	putByte(frame, (value >> 16) & 0xFF);
+	putUint16BE(frame, value & 0xFFFF);
+}
+
+static inline void patchUint24BE(Frame &frame, uint32 pos, uint32 value) {
+	frame[pos] = (value >> 16) & 0xFF;
+	frame[pos + 1] = (value >> 8) & 0xFF;
+	frame[pos + 2] = value & 0xFF;
+}
+
+static inline void patchUint16BE(Frame &frame, uint32 pos, uint16 value) {
+	frame[pos] = value >> 8;
+	frame[pos + 1] = value & 0xFF;
+}
+
+/**
+ * Writes flags the way the decoders read them: 32 bits at a time, most
+ * significant bit first, each word placed where the next bit is needed.
+ */
+class FlagWriter {
+public:
+	FlagWriter(Frame &frame) : _frame(frame), _pos(0), _bitsLeft(0) {}
+
+	void putBit(bool bit) {
+		if (!_bitsLeft) {
+			_pos = _frame.size();
+			for (int i = 0; i < 4; i++)
+				putByte(_frame, 0);
+			_bitsLeft = 32;
+		}
+
+		_bitsLeft--;
+		if (bit)
+			_frame[_pos + 3 - _bitsLeft / 8] |= 1 << (_bitsLeft % 8);
+	}
+
+private:
+	Frame &_frame;
+	uint32 _pos;
+	int _bitsLeft;
+};
+
+/** QuickTime RLE, at 16, 24 or 32 bits per pixel. The width must be a multiple of 4. */
+static inline void encodeQTRLE(Frame &frame, int width, int height, int bitsPerPixel, Random &rng, bool keyframe) {
+	frame.clear();
+	putUint16BE(frame, 0); // Chunk size, unused by the decoder
+	putUint16BE(frame, 0);
+
+	int lines = height;
+	if (keyframe) {
+		putUint16BE(frame, 0);
+	} else {
+		// Only update a band of lines
+		const int startLine = rng.next(height / 2);
+		lines = 1 + rng.next(height - startLine);
+		putUint16BE(frame, 8);
+		putUint16BE(frame, startLine);
+		putUint16BE(frame, 0);
+		putUint16BE(frame, lines);
+		putUint16BE(frame, 0);
+	}
+
+	for (int y = 0; y < lines; y++) {
+		int x = keyframe ? 0 : rng.next(width / 4);
+		putByte(frame, x + 1);
+
+		while (x < width) {
+			const int count = 1 + rng.next(MIN(width - x, 127));
+			const int mode = rng.next(keyframe ? 2 : 3);
+
+			if (mode == 2) {
+				putByte(frame, 0);
+				putByte(frame, count + 1);
+			} else {
+				putByte(frame, mode == 0 ? -count : count);
+
+				const int colors = mode == 0 ? 1 : count;
+				for (int i = 0; i < colors; i++) {
+					if (bitsPerPixel == 16) {
+						putUint16BE(frame, rng.next(0x8000));
+					} else {
+						for (int j = 0; j < bitsPerPixel / 8; j++)
+							putByte(frame, rng.nextByte());
+					}
+				}
+			}
+
+			x += count;
+		}
+
+		putByte(frame, 0xFF);
+	}
+}
+
+/** Microsoft Video 1, at 8 or 16 bits per pixel. */
+static inline void encodeMSVideo1(Frame &frame, int width, int height, int bitsPerPixel, Random &rng, bool keyframe) {
+	frame.clear();
+
+	const int blocks = (width / 4) * (height / 4);
+	for (int i = 0; i < blocks; ) {
+		const int mode = rng.next(keyframe ? 3 : 4);
+
+		if (mode == 3) {
+			// Skip blocks
+			const int count = 1 + rng.next(MIN(blocks - i, 0x3FF));
+			putByte(frame, count & 0xFF);
+			putByte(frame, 0x84 | (count >> 8));
+			i += count;
+			continue;
+		}
+
+		if (mode == 0) {
+			// One color
+			if (bitsPerPixel == 8) {
+				putByte(frame, rng.nextByte());
+				putByte(frame, rng.next(2) ? 0x80 + rng.next(4) : 0x88 + rng.next(8));
+			} else {
+				const uint16 color = rng.next(0x8000);
+				putByte(frame, color & 0xFF);
+				putByte(frame, 0x88 | ((color >> 8) & 0x77));
+			}
+		} else {
+			const bool eightColors = mode == 2;
+			putByte(frame, rng.nextByte());
+			if (bitsPerPixel == 8) {
+				putByte(frame, eightColors ? 0x90 + rng.next(0x70) : rng.next(0x80));
+				for (int j = 0; j < (eightColors ? 8 : 2); j++)
+					putByte(frame, rng.nextByte());
+			} else {
+				putByte(frame, rng.next(0x80));
+				putUint16LE(frame, rng.next(0x8000) | (eightColors ? 0x8000 : 0));
+				for (int j = 1; j < (eightColors ? 8 : 2); j++)
+					putUint16LE(frame, rng.next(0x8000));
+			}
+		}
+
+		i++;
+	}
+}
+
+/** Apple Video (RPZA). */
+static inline void encodeRPZA(Frame &frame, int width, int height, Random &rng, bool keyframe) {
+	frame.clear();
+	putByte(frame, 0xE1);
+	putUint24BE(frame, 0); // Patched with the chunk size
+
+	const int blocks = ((width + 3) / 4) * ((height + 3) / 4);
+	for (int i = 0; i < blocks; ) {
+		int count = 1 + rng.next(MIN(blocks - i, 32));
+
+		switch (rng.next(keyframe ? 4 : 5)) {
+		case 0: // Fill
+			putByte(frame, 0xA0 | (count - 1));
+			putUint16BE(frame, rng.next(0x8000));
+			break;
+		case 1: // Four colors
+			putByte(frame, 0xC0 | (count - 1));
+			putUint16BE(frame, rng.next(0x10000));
+			putUint16BE(frame, rng.next(0x10000));
+			for (int j = 0; j < count * 4; j++)
+				putByte(frame, rng.nextByte());
+			break;
+		case 2: // Four colors, for a single block without an opcode
+			count = 1;
+			putUint16BE(frame, rng.next(0x8000));
+			putUint16BE(frame, 0x8000 | rng.next(0x8000));
+			for (int j = 0; j < 4; j++)
+				putByte(frame, rng.nextByte());
+			break;
+		case 3: // Sixteen colors
+			count = 1;
+			for (int j = 0; j < 16; j++)
+				putUint16BE(frame, rng.next(0x8000));
+			break;
+		default: // Skip
+			putByte(frame, 0x80 | (count - 1));
+			break;
+		}
+
+		i += count;
+	}
+
+	patchUint24BE(frame, 1, frame.size());
+}
+
+/** Microsoft RLE, at 8 bits per pixel. */
+static inline void encodeMSRLE(Frame &frame, int width, int height, Random &rng, bool keyframe) {
+	frame.clear();
+
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; ) {
+			const int left = width - x;
+			int mode = rng.next(keyframe ? 2 : 3);
+			if (mode == 1 && left < 3)
+				mode = 0;
+
+			int count;
+			if (mode == 0) {
+				// Run
+				count = 1 + rng.next(MIN(left, 255));
+				putByte(frame, count);
+				putByte(frame, rng.nextByte());
+			} else if (mode == 1) {
+				// Literal pixels, padded to a 16-bit boundary
+				count = 3 + rng.next(MIN(left, 255) - 2);
+				putByte(frame, 0);
+				putByte(frame, count);
+				for (int i = 0; i < count; i++)
+					putByte(frame, rng.nextByte());
+				if (count & 1)
+					putByte(frame, 0);
+			} else {
+				// Skip within the line
+				count = 1 + rng.next(left);
+				putByte(frame, 0);
+				putByte(frame, 2);
+				putByte(frame, count);
+				putByte(frame, 0);
+			}
+
+			x += count;
+		}
+
+		// End of line
+		putByte(frame, 0);
+		putByte(frame, 0);
+	}
+
+	// End of picture
+	putByte(frame, 0);
+	putByte(frame, 1);
+}
+
+static inline void putCinepakCodebookEntry(Frame &frame, Random &rng, bool withColor) {
+	for (int i = 0; i < (withColor ? 6 : 4); i++)
+		putByte(frame, rng.nextByte());
+}
+
+/**
+ * Cinepak, with two strips. The height must be a multiple of 8, and the
+ * width a multiple of 4.
+ */
+static inline void encodeCinepak(Frame &frame, int width, int height, Random &rng, bool keyframe) {
+	const int strips = 2;
+
+	frame.clear();
+	putByte(frame, 0); // The second strip starts with the codebooks of the first one
+	putUint24BE(frame, 0); // Patched with the frame size
+	putUint16BE(frame, width);
+	putUint16BE(frame, height);
+	putUint16BE(frame, strips);
+
+	for (int strip = 0; strip < strips; strip++) {
+		const uint32 stripStart = frame.size();
+		putUint16BE(frame, keyframe ? 0x1000 : 0x1100);
+		putUint16BE(frame, 0); // Patched with the strip size
+		putUint16BE(frame, 0);
+		putUint16BE(frame, 0);
+		putUint16BE(frame, height / strips);
+		putUint16BE(frame, width);
+
+		// Codebooks: the full ones for the key frame, updates of some entries otherwise
+		for (int codebook = 0; codebook < 2; codebook++) {
+			if (!keyframe && !rng.next(3))
+				continue;
+
+			const bool withColor = rng.next(2);
+			byte chunkID = (codebook ? 0x22 : 0x20) | (withColor ? 0 : 0x04) | (keyframe ? 0 : 0x01);
+
+			const uint32 chunkStart = frame.size();
+			putByte(frame, chunkID);
+			putUint24BE(frame, 0);
+
+			if (keyframe) {
+				for (int i = 0; i < 256; i++)
+					putCinepakCodebookEntry(frame, rng, withColor);
+			} else {
+				FlagWriter flags(frame);
+				for (int i = 0; i < 256; i++) {
+					const bool update = rng.next(4) == 0;
+					flags.putBit(update);
+					if (update)
+						putCinepakCodebookEntry(frame, rng, withColor);
+				}
+			}
+
+			patchUint24BE(frame, chunkStart + 1, frame.size() - chunkStart);
+		}
+
+		// Vectors: every block for the key frame, some blocks otherwise
+		const uint32 chunkStart = frame.size();
+		putByte(frame, keyframe ? 0x30 : 0x31);
+		putUint24BE(frame, 0);
+
+		FlagWriter flags(frame);
+		const int blocks = (width / 4) * (height / strips / 4);
+		for (int i = 0; i < blocks; i++) {
+			if (!keyframe) {
+				const bool update = rng.next(2);
+				flags.putBit(update);
+				if (!update)
+					continue;
+			}
+
+			const bool fourVectors = rng.next(2);
+			flags.putBit(fourVectors);
+			for (int j = 0; j < (fourVectors ? 4 : 1); j++)
+				putByte(frame, rng.nextByte());
+		}
+
+		patchUint24BE(frame, chunkStart + 1, frame.size() - chunkStart);
+		patchUint16BE(frame, stripStart + 2, frame.size() - stripStart);
+	}
+
+	patchUint24BE(frame, 1, frame.size());
+}
+
+/** The MD5 of the visible pixels of a decoded frame. */
+static inline Common::String computeFrameMD5(const Graphics::Surface &surface) {
+	const uint32 rowSize = surface.w * surface.format.bytesPerPixel;
+	byte *pixels = new byte[rowSize * surface.h];
+	for (int y = 0; y < surface.h; y++)
+		memcpy(pixels + y * rowSize, surface.getBasePtr(0, y), rowSize);
+
+	Common::MemoryReadStream stream(pixels, rowSize * surface.h);
+	Common::String md5 = Common::computeStreamMD5AsString(stream);
+	delete[] pixels;
+	return md5;
+}
+
+} // End of namespace CodecClips
+
+#endif
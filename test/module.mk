@@ -1,15 +1,33 @@
 ######################################################################
 # Unit/regression tests, based on CxxTest.
-# Use the 'test' target to run them.
-# Edit TESTS and TESTLIBS to add more tests.
+# Use the 'test' target to run them, and the 'benchmark' target to run
+# the benchmarks.
+# Edit TESTS and TESTLIBS to add more tests, and BENCHMARKS to add more
+# benchmarks.
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h
-TEST_LIBS    := audio/libaudio.a math/libmath.a common/libcommon.a
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/video/*.h $(srcdir)/test/image/*.h
+BENCHMARKS   := $(srcdir)/test/common/benchmark/*.h $(srcdir)/test/audio/benchmark/*.h $(srcdir)/test/video/benchmark/*.h $(srcdir)/test/image/benchmark/*.h
+# Only the graphics objects the tests need are linked, rather than the whole
+# library, so that the tests build without the OpenGL headers.
+TEST_GRAPHICS_OBJS := graphics/conversion.o graphics/pixelbuffer.o graphics/primitives.o graphics/surface.o \
+	graphics/yuv_to_rgb.o graphics/yuv_to_rgb_sse2.o graphics/yuva_to_rgba.o
+TEST_LIBS    := video/libvideo.a image/libimage.a audio/libaudio.a $(TEST_GRAPHICS_OBJS) math/libmath.a common/libcommon.a
+
+ifdef ENABLE_GRIM
+TESTS        += $(srcdir)/test/engines/grim/*.h
+endif
+
+ifdef ENABLE_MYST3
+TESTS        += $(srcdir)/test/engines/myst3/*.h
+BENCHMARKS   += $(srcdir)/test/engines/myst3/benchmark/*.h
+TEST_LIBS    := engines/myst3/lzo.o engines/myst3/lzo_stream.o $(TEST_LIBS)
+endif
 
 #
 TEST_FLAGS   := --runner=StdioPrinter --no-std --no-eh --include=$(srcdir)/test/cxxtest_mingw.h
+BENCHMARK_FLAGS := $(TEST_FLAGS) --include=$(srcdir)/test/benchmark.h
 TEST_CFLAGS  := $(CFLAGS) -I$(srcdir)/test/cxxtest
 TEST_LDFLAGS := $(LDFLAGS) $(LIBS)
 TEST_CXXFLAGS := $(filter-out -Wglobal-constructors,$(CXXFLAGS))
@@ -37,8 +55,16 @@ test/runner.cpp: $(TESTS)
 	@mkdir -p test
 	$(srcdir)/test/cxxtest/cxxtestgen.py $(TEST_FLAGS) -o $@ $+
 
+benchmark: test/bench_runner
+	./test/bench_runner
+test/bench_runner: test/bench_runner.cpp $(TEST_LIBS)
+	$(QUIET_CXX)$(CXX) $(TEST_CXXFLAGS) $(CPPFLAGS) $(TEST_CFLAGS) -o $@ $+ $(TEST_LDFLAGS)
+test/bench_runner.cpp: $(BENCHMARKS) $(srcdir)/test/benchmark.h
+	@mkdir -p test
+	$(srcdir)/test/cxxtest/cxxtestgen.py $(BENCHMARK_FLAGS) -o $@ $(BENCHMARKS)
+
 clean: clean-test
 clean-test:
-	-$(RM) test/runner.cpp test/runner
+	-$(RM) test/runner.cpp test/runner test/bench_runner.cpp test/bench_runner
 
-.PHONY: test clean-test
+.PHONY: test benchmark clean-test
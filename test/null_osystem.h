@@ -0,0 +1,84 @@
+#ifndef TEST_NULL_OSYSTEM_H
+#define TEST_NULL_OSYSTEM_H
+
+#include "common/system.h"
+
+#include "graphics/pixelbuffer.h"
+#include "graphics/pixelformat.h"
+
+/**
+ * A system without any backend, for the tests of code which needs g_system
+ * for no more than its mutexes. The tests run in a single thread, so the
+ * mutexes do nothing.
+ */
+class NullTestSystem : public OSystem {
+public:
+	/** Install the null system as g_system, unless there is one already. */
+	static void install() {
+		static NullTestSystem system;
+		if (!g_system)
+			g_system = &system;
+	}
+
+	const GraphicsMode *getSupportedGraphicsModes() const {
+		static const GraphicsMode modes[] = { { nullptr, nullptr, 0 } };
+		return modes;
+	}
+	int getDefaultGraphicsMode() const { return 0; }
+	bool setGraphicsMode(int mode) { return mode == 0; }
+	int getGraphicsMode() const { return 0; }
+	Graphics::PixelFormat getScreenFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	Common::List<Graphics::PixelFormat> getSupportedFormats() const {
+		Common::List<Graphics::PixelFormat> formats;
+		formats.push_back(Graphics::PixelFormat::createFormatCLUT8());
+		return formats;
+	}
+	void initSize(uint width, uint height, const Graphics::PixelFormat *format) {}
+	void launcherInitSize(uint width, uint height) {}
+	void setupScreen(uint screenW, uint screenH, bool fullscreen, bool accel3d) {}
+	Graphics::PixelBuffer getScreenPixelBuffer() { return Graphics::PixelBuffer(); }
+	int16 getHeight() { return 0; }
+	int16 getWidth() { return 0; }
+	PaletteManager *getPaletteManager() { return nullptr; }
+	void copyRectToScreen(const void *buf, int pitch, int x, int y, int w, int h) {}
+	Graphics::Surface *lockScreen() { return nullptr; }
+	void unlockScreen() {}
+	void fillScreen(uint32 col) {}
+	void updateScreen() {}
+	void setShakePos(int shakeOffset) {}
+	void showOverlay() {}
+	void hideOverlay() {}
+	Graphics::PixelFormat getOverlayFormat() const { return Graphics::PixelFormat::createFormatCLUT8(); }
+	void clearOverlay() {}
+	void grabOverlay(void *buf, int pitch) {}
+	void copyRectToOverlay(const void *buf, int pitch, int x, int y, int w, int h) {}
+	int16 getOverlayHeight() { return 0; }
+	int16 getOverlayWidth() { return 0; }
+	bool showMouse(bool visible) { return false; }
+	bool lockMouse(bool lock) { return false; }
+	void warpMouse(int x, int y) {}
+	void setMouseCursor(const void *buf, uint w, uint h, int hotspotX, int hotspotY, uint32 keycolor, bool dontScale, const Graphics::PixelFormat *format) {}
+	uint32 getMillis(bool skipRecord) { return 0; }
+	void delayMillis(uint msecs) {}
+	void getTimeAndDate(TimeDate &t) const {
+		t.tm_sec = t.tm_min = t.tm_hour = 0;
+		t.tm_mday = 1;
+		t.tm_mon = 0;
+		t.tm_year = 100;
+		t.tm_wday = 6;
+	}
+
+	// Any non-null value will do, nothing is ever locked.
+	MutexRef createMutex() { return (MutexRef)this; }
+	void lockMutex(MutexRef mutex) {}
+	void unlockMutex(MutexRef mutex) {}
+	void deleteMutex(MutexRef mutex) {}
+
+	Audio::Mixer *getMixer() { return nullptr; }
+	void quit() {}
+	void displayMessageOnOSD(const char *msg) {}
+	void displayActivityIconOnOSD(const Graphics::Surface *icon) {}
+	void logMessage(LogMessageType::Type type, const char *message) {}
+};
+
+#endif
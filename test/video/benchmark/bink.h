@@ -0,0 +1,78 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/bink_decoder_sse2.h"
+
+#include "test/video/reference/bink_idct.h"
+
+namespace {
+
+// A 640x480 frame, the size of the EMI and Myst3 cutscenes
+const int kFrameWidth = 640;
+const int kFrameHeight = 480;
+const int kFrameBlocks = (kFrameWidth / 8) * (kFrameHeight / 8);
+
+typedef void (*IDCTBlockFunc)(byte *dest, uint32 pitch, const int32 *block);
+
+/**
+ * Run one block function over every 8x8 block of a frame, and report
+ * the number of frames per second.
+ */
+void benchmarkFrame(const char *name, IDCTBlockFunc func, const int32 *blocks, byte *frame) {
+	double frames = 0;
+	double elapsed = 0;
+	const double start = Benchmark::getTime();
+
+	do {
+		for (int n = 0; n < 16; n++) {
+			const int32 *block = blocks;
+			for (int y = 0; y < kFrameHeight; y += 8)
+				for (int x = 0; x < kFrameWidth; x += 8, block += 64)
+					func(frame + y * kFrameWidth + x, kFrameWidth, block);
+
+			frames++;
+		}
+
+		elapsed = Benchmark::getTime() - start;
+	} while (elapsed < Benchmark::kMinDuration);
+
+	Benchmark::report(name, frames, "frame", elapsed);
+}
+
+} // End of anonymous namespace
+
+class BinkBenchmarkSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		_blocks = new int32[kFrameBlocks * 64];
+		_frame = new byte[kFrameWidth * kFrameHeight];
+
+		uint32 seed = 1;
+		for (int i = 0; i < kFrameBlocks; i++)
+			BinkReference::fillCoefficients(_blocks + i * 64, seed, false);
+
+		Benchmark::fillRandom(_frame, kFrameWidth * kFrameHeight);
+	}
+
+	void tearDown() {
+		delete[] _blocks;
+		delete[] _frame;
+	}
+
+	void test_intra() {
+		benchmarkFrame("Bink intra frame, scalar", &BinkReference::idctPut, _blocks, _frame);
+#if defined(USE_BINK) && defined(__SSE2__)
+		benchmarkFrame("Bink intra frame, SSE2", &Video::binkIDCTPutSSE2, _blocks, _frame);
+#endif
+	}
+
+	void test_inter() {
+		benchmarkFrame("Bink inter frame, scalar", &BinkReference::idctAdd, _blocks, _frame);
+#if defined(USE_BINK) && defined(__SSE2__)
+		benchmarkFrame("Bink inter frame, SSE2", &Video::binkIDCTAddSSE2, _blocks, _frame);
+#endif
+	}
+
+private:
+	int32 *_blocks;
+	byte *_frame;
+};
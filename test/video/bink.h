@@ -0,0 +1,71 @@
+#include <cxxtest/TestSuite.h>
+
+#include "video/bink_decoder_sse2.h"
+
+#include "test/video/reference/bink_idct.h"
+
+class BinkTestSuite : public CxxTest::TestSuite {
+public:
+	void test_idct() {
+#if defined(USE_BINK) && defined(__SSE2__)
+		uint32 seed = 1;
+		for (int n = 0; n < 1000; n++) {
+			int32 expected[64], actual[64];
+			BinkReference::fillCoefficients(expected, seed, n & 1);
+			memcpy(actual, expected, sizeof(actual));
+
+			BinkReference::idct(expected);
+			Video::binkIDCTSSE2(actual);
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+#endif
+	}
+
+	void test_idct_put_add() {
+#if defined(USE_BINK) && defined(__SSE2__)
+		// Blocks in a wider picture, to check the pitch is used
+		const uint32 pitch = 24;
+		byte expected[8 * pitch], actual[8 * pitch];
+
+		uint32 seed = 2;
+		for (int n = 0; n < 1000; n++) {
+			int32 block[64];
+			BinkReference::fillCoefficients(block, seed, n & 1);
+
+			for (uint i = 0; i < sizeof(expected); i++)
+				expected[i] = actual[i] = (i * 37 + n) & 0xFF;
+
+			BinkReference::idctPut(expected + 8, pitch, block);
+			Video::binkIDCTPutSSE2(actual + 8, pitch, block);
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+
+			BinkReference::idctAdd(expected + 8, pitch, block);
+			Video::binkIDCTAddSSE2(actual + 8, pitch, block);
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+#endif
+	}
+
+	void test_add_residue() {
+#if defined(USE_BINK) && defined(__SSE2__)
+		const uint32 pitch = 16;
+		byte expected[8 * pitch], actual[8 * pitch];
+
+		uint32 seed = 3;
+		for (int n = 0; n < 100; n++) {
+			int16 block[64];
+			for (int i = 0; i < 64; i++) {
+				seed = seed * 1103515245 + 12345;
+				block[i] = (int16)(seed >> 16);
+			}
+
+			for (uint i = 0; i < sizeof(expected); i++)
+				expected[i] = actual[i] = (i * 13 + n) & 0xFF;
+
+			BinkReference::addResidue(expected + 4, pitch, block);
+			Video::binkAddResidueSSE2(actual + 4, pitch, block);
+			TS_ASSERT_SAME_DATA(actual, expected, sizeof(actual));
+		}
+#endif
+	}
+};
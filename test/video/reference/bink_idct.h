@@ -0,0 +1,100 @@
+#ifndef TEST_VIDEO_REFERENCE_BINK_IDCT_H
+#define TEST_VIDEO_REFERENCE_BINK_IDCT_H
+
+#include "common/scummsys.h"
+
+/**
+ * The scalar Bink video IDCT and residue code, as in BinkDecoder, to
+ * check and measure the optimized versions against.
+ */
+namespace BinkReference {
+
+static inline void transform(const int32 *src, int32 *dest, int stride, bool round) {
+	const int a0 = src[0 * stride] + src[4 * stride];
+	const int a1 = src[0 * stride] - src[4 * stride];
+	const int a2 = src[2 * stride] + src[6 * stride];
+	const int a3 = (2896 * (src[2 * stride] - src[6 * stride])) >> 11;
+	const int a4 = src[5 * stride] + src[3 * stride];
+	const int a5 = src[5 * stride] - src[3 * stride];
+	const int a6 = src[1 * stride] + src[7 * stride];
+	const int a7 = src[1 * stride] - src[7 * stride];
+	const int b0 = a4 + a6;
+	const int b1 = (3784 * (a5 + a7)) >> 11;
+	const int b2 = ((-5352 * a5) >> 11) - b0 + b1;
+	const int b3 = (2896 * (a6 - a4) >> 11) - b2;
+	const int b4 = ((2217 * a7) >> 11) + b3 - b1;
+
+	const int out[8] = {
+		a0 + a2 + b0, a1 + a3 - a2 + b2, a1 - a3 + a2 + b3, a0 - a2 - b4,
+		a0 - a2 + b4, a1 - a3 + a2 - b3, a1 + a3 - a2 - b2, a0 + a2 - b0
+	};
+
+	for (int i = 0; i < 8; i++)
+		dest[i * stride] = round ? ((out[i] + 0x7F) >> 8) : out[i];
+}
+
+static inline void idct(int32 *block) {
+	int32 temp[64];
+	for (int i = 0; i < 8; i++) {
+		const int32 *src = &block[i];
+		if ((src[8] | src[16] | src[24] | src[32] | src[40] | src[48] | src[56]) == 0) {
+			// Only a DC value, as BinkDecoder does
+			for (int j = 0; j < 8; j++)
+				temp[i + j * 8] = src[0];
+		} else {
+			transform(src, &temp[i], 8, false);
+		}
+	}
+	for (int i = 0; i < 8; i++)
+		transform(&temp[8 * i], &block[8 * i], 1, true);
+}
+
+static inline void idctPut(byte *dest, uint32 pitch, const int32 *block) {
+	int32 temp[64];
+	memcpy(temp, block, sizeof(temp));
+	idct(temp);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		for (int j = 0; j < 8; j++)
+			dest[j] = temp[i * 8 + j];
+}
+
+static inline void idctAdd(byte *dest, uint32 pitch, const int32 *block) {
+	int32 temp[64];
+	memcpy(temp, block, sizeof(temp));
+	idct(temp);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		for (int j = 0; j < 8; j++)
+			dest[j] += temp[i * 8 + j];
+}
+
+static inline void addResidue(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		for (int j = 0; j < 8; j++)
+			dest[j] += block[j];
+}
+
+/**
+ * Fill a block with coefficients like those of a real video: a DC value
+ * and a few low frequency AC values, or with any value at all.
+ */
+static inline void fillCoefficients(int32 *block, uint32 &seed, bool anyValue) {
+	for (int i = 0; i < 64; i++) {
+		seed = seed * 1103515245 + 12345;
+		const int32 value = (int32)(seed >> 8);
+
+		if (anyValue)
+			block[i] = value >> 12;
+		else if (i == 0)
+			block[i] = value & 0x7FFF;
+		else if ((i & 7) < 3 && i < 24)
+			block[i] = (value & 0x3FF) - 0x200;
+		else
+			block[i] = 0;
+	}
+}
+
+} // End of namespace BinkReference
+
+#endif
@@ -0,0 +1,363 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/array.h"
+#include "common/endian.h"
+#include "common/memstream.h"
+
+#include "graphics/surface.h"
+
+#include "video/smk_decoder.h"
+
+#include "test/null_osystem.h"
+
+namespace {
+
+/** Writes bits the way Smacker reads them, starting with the lowest bit of each byte */
+class SmackerBitWriter {
+public:
+	SmackerBitWriter() : _bitCount(0) {}
+
+	void putBit(uint32 bit) {
+		if ((_bitCount & 7) == 0)
+			_data.push_back(0);
+		if (bit)
+			_data.back() |= 1 << (_bitCount & 7);
+		_bitCount++;
+	}
+
+	/** Write the lowest bits of value, lowest bit first, as read by getBits() */
+	void putBits(uint32 value, uint count) {
+		for (uint i = 0; i < count; i++)
+			putBit((value >> i) & 1);
+	}
+
+	/** Write a Huffman code, first bit first */
+	void putCode(uint32 code, uint8 length) {
+		for (int i = length - 1; i >= 0; i--)
+			putBit((code >> i) & 1);
+	}
+
+	const Common::Array<byte> &getData() const { return _data; }
+
+private:
+	Common::Array<byte> _data;
+	uint32 _bitCount;
+};
+
+struct SmackerRandom {
+	uint32 seed;
+
+	SmackerRandom(uint32 s) : seed(s) {}
+
+	uint32 next(uint32 max) {
+		seed = seed * 1103515245 + 12345;
+		return (seed >> 8) % max;
+	}
+};
+
+/** The leaves of a Huffman tree, in the order they are stored */
+struct SmackerTestLeaves {
+	Common::Array<uint32> codes;
+	Common::Array<uint8> lengths;
+
+	/**
+	 * Write the shape of a random tree with the given number of leaves.
+	 * Leaves are written as a 0 bit followed by whatever writeLeaf adds.
+	 */
+	template<class LeafWriter>
+	void write(SmackerBitWriter &writer, SmackerRandom &rng, uint32 count, LeafWriter &writeLeaf) {
+		writeNode(writer, rng, count, 0, 0, writeLeaf);
+	}
+
+private:
+	template<class LeafWriter>
+	void writeNode(SmackerBitWriter &writer, SmackerRandom &rng, uint32 count, uint32 code, uint8 length, LeafWriter &writeLeaf) {
+		if (count == 1) {
+			writer.putBit(0);
+			codes.push_back(code);
+			lengths.push_back(length);
+			writeLeaf(writer, codes.size() - 1);
+			return;
+		}
+
+		// Lopsided trees, for long codes, but no longer than 20 bits
+		uint32 depthLeft = 1;
+		while ((1u << depthLeft) < count)
+			depthLeft++;
+
+		uint32 left;
+		if (length + depthLeft >= 20) {
+			left = count / 2;
+		} else {
+			switch (rng.next(3)) {
+			case 0:
+				left = 1;
+				break;
+			case 1:
+				left = count - 1;
+				break;
+			default:
+				left = 1 + rng.next(count - 1);
+				break;
+			}
+		}
+
+		writer.putBit(1);
+		writeNode(writer, rng, left, code << 1, length + 1, writeLeaf);
+		writeNode(writer, rng, count - left, (code << 1) | 1, length + 1, writeLeaf);
+	}
+};
+
+/** A tree of the 256 byte values, in a random order */
+struct SmackerTestSmallTree {
+	SmackerTestLeaves leaves;
+	uint32 values[256];
+	uint32 leafOfValue[256];
+
+	void write(SmackerBitWriter &writer, SmackerRandom &rng, uint32 count) {
+		// Shuffled values, so that the leaf order says nothing about them
+		for (uint32 i = 0; i < 256; i++)
+			values[i] = i;
+		for (uint32 i = 255; i > 0; i--)
+			SWAP(values[i], values[rng.next(i + 1)]);
+		for (uint32 i = 0; i < count; i++)
+			leafOfValue[values[i]] = i;
+
+		writer.putBit(1);
+		leaves.write(writer, rng, count, *this);
+		writer.putBit(0);
+	}
+
+	void operator()(SmackerBitWriter &writer, uint32 leaf) {
+		writer.putBits(values[leaf], 8);
+	}
+
+	void putValue(SmackerBitWriter &writer, uint32 value) const {
+		uint32 leaf = leafOfValue[value];
+		writer.putCode(leaves.codes[leaf], leaves.lengths[leaf]);
+	}
+};
+
+/**
+ * A tree of 16-bit values, along with a model of how Smacker decodes it:
+ * the leaves holding one of the three marker values return the cached
+ * last decoded values instead.
+ */
+struct SmackerTestBigTree {
+	SmackerTestLeaves leaves;
+	SmackerTestSmallTree lo, hi;
+	Common::Array<uint32> leafValues;
+	Common::Array<uint32> values;
+	uint32 markers[3];
+	uint32 last[3];
+
+	/**
+	 * @param count    the number of leaves, or 0 for a tree without any
+	 * @param typeTree whether to only use values which are valid block types with a run of 1
+	 */
+	void write(SmackerBitWriter &writer, SmackerRandom &rng, uint32 count, bool typeTree) {
+		for (uint32 i = 0; i < count; i++) {
+			uint32 value = rng.next(0x10000);
+			if (typeTree)
+				value &= 0xFF03;
+			leafValues.push_back(value);
+		}
+
+		// Some of the leaves hold the cached values
+		for (uint32 i = 0; i < 3; i++) {
+			uint32 marker = 0xFFFF - i;
+			if (count > 3 && rng.next(2))
+				leafValues[rng.next(count)] = marker;
+			markers[i] = marker;
+		}
+
+		if (count == 0) {
+			writer.putBit(0);
+			values.push_back(0);
+			last[0] = last[1] = last[2] = 0;
+			return;
+		}
+
+		writer.putBit(1);
+		lo.write(writer, rng, 256);
+		hi.write(writer, rng, 256);
+		for (uint32 i = 0; i < 3; i++)
+			writer.putBits(markers[i], 16);
+
+		last[0] = last[1] = last[2] = 0xFFFFFFFF;
+		leaves.write(writer, rng, count, *this);
+		writer.putBit(0);
+
+		for (uint32 i = 0; i < 3; i++) {
+			if (last[i] == 0xFFFFFFFF) {
+				last[i] = values.size();
+				values.push_back(0);
+			}
+		}
+	}
+
+	void operator()(SmackerBitWriter &writer, uint32 leaf) {
+		uint32 value = leafValues[leaf];
+		lo.putValue(writer, value & 0xFF);
+		hi.putValue(writer, value >> 8);
+
+		values.push_back(value);
+		for (uint32 i = 0; i < 3; i++) {
+			if (markers[i] == value) {
+				last[i] = leaf;
+				values.back() = 0;
+			}
+		}
+	}
+
+	/** Write the code of a random leaf, and return the value Smacker decodes for it */
+	uint32 putRandomLeaf(SmackerBitWriter &writer, SmackerRandom &rng) {
+		uint32 leaf = 0;
+		if (!leaves.codes.empty()) {
+			leaf = rng.next(leaves.codes.size());
+			writer.putCode(leaves.codes[leaf], leaves.lengths[leaf]);
+		}
+
+		uint32 value = values[leaf];
+		if (value != values[last[0]]) {
+			values[last[2]] = values[last[1]];
+			values[last[1]] = values[last[0]];
+			values[last[0]] = value;
+		}
+		return value;
+	}
+};
+
+} // End of anonymous namespace
+
+class SmackerTestSuite : public CxxTest::TestSuite {
+public:
+	void setUp() {
+		// The video decoders need g_system for the default pixel format
+		NullTestSystem::install();
+	}
+
+	void test_random_trees() {
+		for (uint32 seed = 1; seed <= 20; seed++) {
+			SmackerRandom rng(seed);
+			const uint32 counts[4] = {
+				1 + rng.next(400), 1 + rng.next(400), 1 + rng.next(400), 1 + rng.next(50)
+			};
+			checkFrame(seed, counts);
+		}
+	}
+
+	void test_degenerate_trees() {
+		// Trees made of a single leaf, which do not use any bits
+		const uint32 singleLeaves[4] = { 1, 1, 1, 1 };
+		checkFrame(100, singleLeaves);
+
+		// Trees without any leaf, which always decode to 0
+		const uint32 emptyTrees[4] = { 0, 0, 0, 0 };
+		checkFrame(101, emptyTrees);
+
+		const uint32 mixed[4] = { 0, 1, 300, 2 };
+		checkFrame(102, mixed);
+	}
+
+private:
+	enum {
+		kWidth = 32,
+		kHeight = 16
+	};
+
+	/**
+	 * Encode a frame of random blocks with random trees, and check that
+	 * the decoder gets the same picture back.
+	 *
+	 * @param counts the number of leaves of the mono map, mono color, full and type trees
+	 */
+	void checkFrame(uint32 seed, const uint32 counts[4]) {
+		SmackerRandom rng(seed);
+
+		SmackerTestBigTree trees[4];
+		SmackerBitWriter treeWriter;
+		for (uint32 i = 0; i < 4; i++)
+			trees[i].write(treeWriter, rng, counts[i], i == 3);
+		SmackerTestBigTree &mMapTree = trees[0];
+		SmackerTestBigTree &mClrTree = trees[1];
+		SmackerTestBigTree &fullTree = trees[2];
+		SmackerTestBigTree &typeTree = trees[3];
+
+		byte expected[kWidth * kHeight];
+		memset(expected, 0, sizeof(expected));
+
+		SmackerBitWriter frameWriter;
+		for (uint32 block = 0; block < (kWidth / 4) * (kHeight / 4); block++) {
+			byte *out = expected + (block / (kWidth / 4)) * 4 * kWidth + (block % (kWidth / 4)) * 4;
+
+			uint32 type = typeTree.putRandomLeaf(frameWriter, rng);
+			switch (type & 3) {
+			case 0: { // Mono
+				uint32 color = mClrTree.putRandomLeaf(frameWriter, rng);
+				uint32 map = mMapTree.putRandomLeaf(frameWriter, rng);
+				for (uint32 i = 0; i < 16; i++)
+					out[(i / 4) * kWidth + (i % 4)] = ((map >> i) & 1) ? color >> 8 : color & 0xFF;
+				break;
+			}
+			case 1: // Full
+				for (uint32 y = 0; y < 4; y++) {
+					uint32 p1 = fullTree.putRandomLeaf(frameWriter, rng);
+					uint32 p2 = fullTree.putRandomLeaf(frameWriter, rng);
+					out[y * kWidth + 0] = p2 & 0xFF;
+					out[y * kWidth + 1] = p2 >> 8;
+					out[y * kWidth + 2] = p1 & 0xFF;
+					out[y * kWidth + 3] = p1 >> 8;
+				}
+				break;
+			case 2: // Skip
+				break;
+			case 3: // Fill
+				for (uint32 y = 0; y < 4; y++)
+					memset(out + y * kWidth, type >> 8, 4);
+				break;
+			}
+		}
+
+		Video::SmackerDecoder decoder;
+		TS_ASSERT(decoder.loadStream(createFile(treeWriter.getData(), frameWriter.getData())));
+
+		const Graphics::Surface *surface = decoder.decodeNextFrame();
+		TS_ASSERT(surface);
+		if (!surface)
+			return;
+
+		TS_ASSERT_EQUALS(surface->w, kWidth);
+		TS_ASSERT_EQUALS(surface->h, kHeight);
+		for (uint32 y = 0; y < kHeight; y++)
+			TS_ASSERT_SAME_DATA(surface->getBasePtr(0, y), expected + y * kWidth, kWidth);
+	}
+
+	/** Create a Smacker 2 file of a single frame, without palette nor audio */
+	static Common::SeekableReadStream *createFile(const Common::Array<byte> &trees, const Common::Array<byte> &frame) {
+		// The frame sizes are multiples of 4, the lowest bits are flags
+		const uint32 frameSize = (frame.size() + 3) & ~3;
+		const uint32 headerSize = 104;
+		const uint32 size = headerSize + 4 + 1 + trees.size() + frameSize;
+
+		byte *data = (byte *)calloc(size, 1);
+		WRITE_BE_UINT32(data, MKTAG('S', 'M', 'K', '2'));
+		WRITE_LE_UINT32(data + 4, kWidth);
+		WRITE_LE_UINT32(data + 8, kHeight);
+		WRITE_LE_UINT32(data + 12, 1);   // Frame count
+		WRITE_LE_UINT32(data + 16, 100); // Frame delay
+		WRITE_LE_UINT32(data + 52, trees.size());
+		// Flags, audio sizes, tree sizes and audio info are all 0
+
+		byte *p = data + headerSize;
+		WRITE_LE_UINT32(p, frameSize);
+		p[4] = 0; // Frame type
+		p += 5;
+
+		memcpy(p, trees.begin(), trees.size());
+		p += trees.size();
+		memcpy(p, frame.begin(), frame.size());
+
+		return new Common::MemoryReadStream(data, size, DisposeAfterUse::YES);
+	}
+};
@@ -31,7 +31,6 @@
 #include "common/textconsole.h"
 #include "common/math.h"
 #include "common/stream.h"
-#include "common/substream.h"
 #include "common/file.h"
 #include "common/str.h"
 #include "common/bitstream.h"
@@ -40,11 +39,13 @@
 #include "common/dct.h"
 #include "common/system.h"
 
+#include "graphics/yuv_to_rgb.h"
 #include "graphics/yuva_to_rgba.h" // ResidualVM specific
 #include "graphics/surface.h"
 
 #include "video/binkdata.h"
 #include "video/bink_decoder.h"
+#include "video/bink_decoder_sse2.h"
 
 static const uint32 kBIKfID = MKTAG('B', 'I', 'K', 'f');
 static const uint32 kBIKgID = MKTAG('B', 'I', 'K', 'g');
@@ -63,6 +64,8 @@ namespace Video {
 
 BinkDecoder::BinkDecoder() {
 	_bink = 0;
+	_packetBuffer = 0;
+	_packetBufferSize = 0;
 }
 
 BinkDecoder::~BinkDecoder() {
@@ -150,6 +153,10 @@ void BinkDecoder::close() {
 	delete _bink;
 	_bink = 0;
 
+	free(_packetBuffer);
+	_packetBuffer = 0;
+	_packetBufferSize = 0;
+
 	_audioTracks.clear();
 	_frames.clear();
 }
@@ -180,14 +187,12 @@ void BinkDecoder::readNextPacket() {
 		if (audioPacketLength >= 4) {
 			// Get our track - audio index plus one as the first track is video
 			BinkAudioTrack *audioTrack = (BinkAudioTrack *)getTrack(i + 1);
-			uint32 audioPacketStart = _bink->pos();
-			uint32 audioPacketEnd   = _bink->pos() + audioPacketLength;
+			uint32 audioPacketEnd = _bink->pos() + audioPacketLength;
 
 			//                  Number of samples in bytes
 			audio.sampleCount = _bink->readUint32LE() / (2 * audio.channels);
 
-			audio.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-					audioPacketStart + 4, audioPacketEnd), DisposeAfterUse::YES);
+			audio.bits = readPacketBits(audioPacketLength - 4);
 
 			audioTrack->decodePacket();
 
@@ -200,11 +205,7 @@ void BinkDecoder::readNextPacket() {
 		}
 	}
 
-	uint32 videoPacketStart = _bink->pos();
-	uint32 videoPacketEnd   = _bink->pos() + frameSize;
-
-	frame.bits = new Common::BitStream32LELSB(new Common::SeekableSubReadStream(_bink,
-			videoPacketStart, videoPacketEnd), DisposeAfterUse::YES);
+	frame.bits = readPacketBits(frameSize);
 
 	videoTrack->decodePacket(frame);
 
@@ -212,6 +213,26 @@ void BinkDecoder::readNextPacket() {
 	frame.bits = 0;
 }
 
+bool BinkDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	// The video track converts its frames straight into dst
+	return decodeTrackFrameInto(dst);
+}
+
+Common::BitStreamMemory32LELSB *BinkDecoder::readPacketBits(uint32 size) {
+	// The packets are read one at a time, so a single buffer, grown as needed, will do
+	if (size > _packetBufferSize) {
+		free(_packetBuffer);
+		_packetBuffer = (byte *)malloc(size);
+		_packetBufferSize = size;
+	}
+
+	// A truncated packet decodes as if padded with zeros, as with a sub stream
+	uint32 bytesRead = _bink->read(_packetBuffer, size);
+	memset(_packetBuffer + bytesRead, 0, size - bytesRead);
+
+	return new Common::BitStreamMemory32LELSB(new Common::BitStreamMemoryStream(_packetBuffer, size), DisposeAfterUse::YES);
+}
+
 VideoDecoder::AudioTrack *BinkDecoder::getAudioTrack(int index) {
 	// Bink audio track indexes are relative to the first audio track
 	Track *track = getTrack(index + 1);
@@ -245,6 +266,8 @@ BinkDecoder::AudioInfo::~AudioInfo() {
 BinkDecoder::BinkVideoTrack::BinkVideoTrack(uint32 width, uint32 height, const Graphics::PixelFormat &format, uint32 frameCount, const Common::Rational &frameRate, bool swapPlanes, bool hasAlpha, uint32 id) :
 		_frameCount(frameCount), _frameRate(frameRate), _swapPlanes(swapPlanes), _hasAlpha(hasAlpha), _id(id) {
 	_curFrame = -1;
+	_alphaSizeState = kAlphaSizeUnchecked;
+	_surfaceOutdated = false;
 
 	for (int i = 0; i < 16; i++)
 		_huffman[i] = 0;
@@ -472,6 +495,7 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 	}
 
 	_curFrame = -1;
+	_surfaceOutdated = false;
 
 	// Re-initialize the video with solid green
 	memset(_curPlanes[0],   0, _yBlockWidth  * 8 * _yBlockHeight  * 8);
@@ -489,12 +513,8 @@ bool BinkDecoder::BinkVideoTrack::rewind() {
 void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 	assert(frame.bits);
 
-	if (_hasAlpha) {
-		if (_id == kBIKiID)
-			frame.bits->skip(32);
-
-		decodePlane(frame, 3, false);
-	}
+	if (_hasAlpha)
+		decodeAlphaPlane(frame);
 
 	if (_id == kBIKiID)
 		frame.bits->skip(32);
@@ -508,19 +528,74 @@ void BinkDecoder::BinkVideoTrack::decodePacket(VideoFrame &frame) {
 			break;
 	}
 
+	// The YUV data is converted to our format when the frame is asked for,
+	// so that it can go straight to where the caller wants it.
+	// Swap the planes with the reference planes, which is where it is found then.
+	for (int i = 0; i < 4; i++)
+		SWAP(_curPlanes[i], _oldPlanes[i]);
+
+	_surfaceOutdated = true;
+	_curFrame++;
+}
+
+const Graphics::Surface *BinkDecoder::BinkVideoTrack::decodeNextFrame() {
+	if (_surfaceOutdated) {
+		convertFrame(_surface);
+		_surfaceOutdated = false;
+	}
+
+	return &_surface;
+}
+
+bool BinkDecoder::BinkVideoTrack::decodeNextFrameInto(Graphics::Surface &dst) {
+	// The conversion writes whole pairs of lines and columns
+	if (!_surfaceOutdated || dst.format != _surface.format || dst.w < _surfaceWidth || dst.h < _surfaceHeight)
+		return VideoTrack::decodeNextFrameInto(dst);
+
+	convertFrame(dst);
+	return true;
+}
+
+void BinkDecoder::BinkVideoTrack::convertFrame(Graphics::Surface &dst) {
 	// Convert the YUV data we have to our format
 	// The width used here is the surface-width, and not the video-width
 	// to allow for odd-sized videos.
-	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _curPlanes[3]
-	assert(_curPlanes[0] && _curPlanes[1] && _curPlanes[2] && _curPlanes[3]);
-	YUVAToRGBAMan.convert420(&_surface, Graphics::YUVAToRGBAManager::kScaleITU, _curPlanes[0], _curPlanes[1], _curPlanes[2], _curPlanes[3],
-			_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	// ResidualVM: added support for Alpha version: YUVAToRGBAMan, _oldPlanes[3]
+	assert(_oldPlanes[0] && _oldPlanes[1] && _oldPlanes[2] && _oldPlanes[3]);
+	if (_hasAlpha && dst.format.aBits() != 0)
+		YUVAToRGBAMan.convert420(&dst, Graphics::YUVAToRGBAManager::kScaleITU, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2], _oldPlanes[3],
+				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+	else // Opaque, which is what the plain YUV conversion produces
+		YUVToRGBMan.convert420(&dst, Graphics::YUVToRGBManager::kScaleITU, _oldPlanes[0], _oldPlanes[1], _oldPlanes[2],
+				_surfaceWidth, _surfaceHeight, _yBlockWidth * 8, _uvBlockWidth * 8);
+}
+
+void BinkDecoder::BinkVideoTrack::decodeAlphaPlane(VideoFrame &video) {
+	if (_id != kBIKiID) {
+		decodePlane(video, 3, false);
+		return;
+	}
 
-	// And swap the planes with the reference planes
-	for (int i = 0; i < 4; i++)
-		SWAP(_curPlanes[i], _oldPlanes[i]);
+	// The alpha plane is preceded by its size in bytes
+	const uint32 size = video.bits->getBits(32) * 8;
+	const uint32 start = video.bits->pos();
 
-	_curFrame++;
+	if (_alphaSizeState == kAlphaSizeValid && _surface.format.aBits() == 0) {
+		// The surface cannot hold the alpha values, don't bother decoding them
+		video.bits->skip(MIN(size, video.bits->size() - start));
+		return;
+	}
+
+	decodePlane(video, 3, false);
+
+	if (_alphaSizeState == kAlphaSizeUnchecked) {
+		if (video.bits->pos() - start == size) {
+			_alphaSizeState = kAlphaSizeValid;
+		} else {
+			warning("Bink alpha plane size %d does not match the decoded size %d", size, video.bits->pos() - start);
+			_alphaSizeState = kAlphaSizeInvalid;
+		}
+	}
 }
 
 void BinkDecoder::BinkVideoTrack::decodePlane(VideoFrame &video, int planeIdx, bool isChroma) {
@@ -748,7 +823,7 @@ void BinkDecoder::BinkVideoTrack::deinitBundles() {
 
 void BinkDecoder::BinkVideoTrack::initHuffman() {
 	for (int i = 0; i < 16; i++)
-		_huffman[i] = new Common::Huffman<Common::BitStream32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
+		_huffman[i] = new Common::Huffman<Common::BitStreamMemory32LELSB>(binkHuffmanLengths[i][15], 16, binkHuffmanCodes[i], binkHuffmanLengths[i]);
 }
 
 byte BinkDecoder::BinkVideoTrack::getHuffmanSymbol(VideoFrame &video, Huffman &huffman) {
@@ -970,11 +1045,15 @@ void BinkDecoder::BinkVideoTrack::blockResidue(DecodeContext &ctx) {
 
 	readResidue(*ctx.video, block, v);
 
+#ifdef __SSE2__
+	binkAddResidueSSE2(ctx.dest, ctx.pitch, block);
+#else
 	byte  *dst = ctx.dest;
 	int16 *src = block;
 	for (int i = 0; i < 8; i++, dst += ctx.pitch, src += 8)
 		for (int j = 0; j < 8; j++)
 			dst[j] += src[j];
+#endif
 }
 
 void BinkDecoder::BinkVideoTrack::blockIntra(DecodeContext &ctx) {
@@ -1477,6 +1556,22 @@ static inline void IDCTCol(int32 *dest, const int32 *src) {
 	}
 }
 
+#ifdef __SSE2__
+
+void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
+	binkIDCTSSE2(block);
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTAdd(DecodeContext &ctx, int32 *block) {
+	binkIDCTAddSSE2(ctx.dest, ctx.pitch, block);
+}
+
+void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
+	binkIDCTPutSSE2(ctx.dest, ctx.pitch, block);
+}
+
+#else
+
 void BinkDecoder::BinkVideoTrack::IDCT(int32 *block) {
 	int i;
 	int32 temp[64];
@@ -1508,6 +1603,8 @@ void BinkDecoder::BinkVideoTrack::IDCTPut(DecodeContext &ctx, int32 *block) {
 	}
 }
 
+#endif
+
 BinkDecoder::BinkAudioTrack::BinkAudioTrack(BinkDecoder::AudioInfo &audio, Audio::Mixer::SoundType soundType) :
 		AudioTrack(soundType),
 		_audioInfo(&audio) {
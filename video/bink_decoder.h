@@ -77,6 +77,8 @@ public:
 	// ResidualVM-specific:
 	Common::Rational getFrameRate();
 	bool hasAlpha() const;
+
+	bool decodeNextFrameInto(Graphics::Surface &dst);
 protected:
 	void readNextPacket();
 	bool supportsAudioTrackSwitching() const { return true; }
@@ -109,7 +111,7 @@ private:
 
 		uint32 sampleCount;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		bool first;
 
@@ -143,7 +145,7 @@ public:
 		uint32 offset;
 		uint32 size;
 
-		Common::BitStream32LELSB *bits;
+		Common::BitStreamMemory32LELSB *bits;
 
 		VideoFrame();
 		~VideoFrame();
@@ -162,7 +164,8 @@ private:
 		Graphics::PixelFormat getPixelFormat() const { return _surface.format; }
 		int getCurFrame() const { return _curFrame; }
 		int getFrameCount() const { return _frameCount; }
-		const Graphics::Surface *decodeNextFrame() { return &_surface; }
+		const Graphics::Surface *decodeNextFrame();
+		bool decodeNextFrameInto(Graphics::Surface &dst);
 // ResidualVM-specific:
 		bool isSeekable() const { return true; }
 		bool seek(const Audio::Timestamp &time) { return true; }
@@ -257,17 +260,27 @@ private:
 		Graphics::Surface _surface;
 		int _surfaceWidth; ///< The actual surface width
 		int _surfaceHeight; ///< The actual surface height
+		bool _surfaceOutdated; ///< Has the last frame not been converted into the surface yet?
 
 		uint32 _id; ///< The BIK FourCC.
 
 		bool _hasAlpha;   ///< Do video frames have alpha?
 		bool _swapPlanes; ///< Are the planes ordered (A)YVU instead of (A)YUV?
 
+		/** States of the alpha plane size found in kBIKiID frames. */
+		enum AlphaSizeState {
+			kAlphaSizeUnchecked, ///< Not yet compared with a decoded plane.
+			kAlphaSizeValid,     ///< Matches the decoded plane, the plane can be skipped using it.
+			kAlphaSizeInvalid    ///< Does not match, the plane always has to be decoded.
+		};
+
+		AlphaSizeState _alphaSizeState;
+
 		Common::Rational _frameRate;
 
 		Bundle _bundles[kSourceMAX]; ///< Bundles for decoding all data types.
 
-		Common::Huffman<Common::BitStream32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
+		Common::Huffman<Common::BitStreamMemory32LELSB> *_huffman[16]; ///< The 16 Huffman codebooks used in Bink decoding.
 
 		/** Huffman codebooks to use for decoding high nibbles in color data types. */
 		Huffman _colHighHuffman[16];
@@ -292,6 +305,10 @@ private:
 
 		/** Decode a plane. */
 		void decodePlane(VideoFrame &video, int planeIdx, bool isChroma);
+		/** Decode or skip the alpha plane. */
+		void decodeAlphaPlane(VideoFrame &video);
+		/** Convert the last decoded frame into dst, which is at least the size of the surface. */
+		void convertFrame(Graphics::Surface &dst);
 
 		/** Read/Initialize a bundle for decoding a plane. */
 		void readBundle(VideoFrame &video, Source source);
@@ -378,10 +395,19 @@ private:
 
 	Common::SeekableReadStream *_bink;
 
+	byte *_packetBuffer;      ///< Holds the packet being decoded, reused by the next ones.
+	uint32 _packetBufferSize; ///< Size of _packetBuffer in bytes.
+
 	Common::Array<AudioInfo> _audioTracks; ///< All audio tracks.
 	Common::Array<VideoFrame> _frames;      ///< All video frames.
 
 	void initAudioTrack(AudioInfo &audio);
+
+	/**
+	 * Read the next size bytes of the file into memory, for bit stream decoding.
+	 * The data is only valid until the next call.
+	 */
+	Common::BitStreamMemory32LELSB *readPacketBits(uint32 size);
 };
 
 } // End of namespace Video
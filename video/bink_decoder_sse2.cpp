@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "video/bink_decoder_sse2.h"
+
+#ifdef __SSE2__
+
+#include <emmintrin.h>
+
+namespace Video {
+
+namespace {
+
+/**
+ * The low 32 bits of c * x, for a constant 0 <= c < 65536. SSE2 has no
+ * 32-bit multiply, so it is put together from 16-bit ones: the low half
+ * of each result is the low half of c * lo, and the high half adds the
+ * high half of c * lo to the low half of c * hi.
+ */
+inline __m128i mulLo32(__m128i x, int c) {
+	const __m128i constant = _mm_set1_epi16((int16)c);
+	const __m128i low = _mm_mullo_epi16(x, constant);
+	const __m128i high = _mm_slli_epi32(_mm_mulhi_epu16(x, constant), 16);
+	return _mm_add_epi32(low, high);
+}
+
+/** (c * x) >> 11, as used by the transform. */
+inline __m128i mulShift(int c, __m128i x) {
+	if (c < 0)
+		return _mm_srai_epi32(_mm_sub_epi32(_mm_setzero_si128(), mulLo32(x, -c)), 11);
+
+	return _mm_srai_epi32(mulLo32(x, c), 11);
+}
+
+/**
+ * The one-dimensional transform of the scalar IDCT_TRANSFORM macro, on
+ * four columns or rows at once.
+ */
+inline void transform(const __m128i *s, __m128i *d) {
+	const __m128i a0 = _mm_add_epi32(s[0], s[4]);
+	const __m128i a1 = _mm_sub_epi32(s[0], s[4]);
+	const __m128i a2 = _mm_add_epi32(s[2], s[6]);
+	const __m128i a3 = mulShift(2896, _mm_sub_epi32(s[2], s[6]));
+	const __m128i a4 = _mm_add_epi32(s[5], s[3]);
+	const __m128i a5 = _mm_sub_epi32(s[5], s[3]);
+	const __m128i a6 = _mm_add_epi32(s[1], s[7]);
+	const __m128i a7 = _mm_sub_epi32(s[1], s[7]);
+	const __m128i b0 = _mm_add_epi32(a4, a6);
+	const __m128i b1 = mulShift(3784, _mm_add_epi32(a5, a7));
+	const __m128i b2 = _mm_add_epi32(_mm_sub_epi32(mulShift(-5352, a5), b0), b1);
+	const __m128i b3 = _mm_sub_epi32(mulShift(2896, _mm_sub_epi32(a6, a4)), b2);
+	const __m128i b4 = _mm_sub_epi32(_mm_add_epi32(mulShift(2217, a7), b3), b1);
+
+	const __m128i e0 = _mm_add_epi32(a0, a2);
+	const __m128i e1 = _mm_sub_epi32(_mm_add_epi32(a1, a3), a2);
+	const __m128i e2 = _mm_add_epi32(_mm_sub_epi32(a1, a3), a2);
+	const __m128i e3 = _mm_sub_epi32(a0, a2);
+
+	d[0] = _mm_add_epi32(e0, b0);
+	d[1] = _mm_add_epi32(e1, b2);
+	d[2] = _mm_add_epi32(e2, b3);
+	d[3] = _mm_sub_epi32(e3, b4);
+	d[4] = _mm_add_epi32(e3, b4);
+	d[5] = _mm_sub_epi32(e2, b3);
+	d[6] = _mm_sub_epi32(e1, b2);
+	d[7] = _mm_sub_epi32(e0, b0);
+}
+
+inline void transpose4x4(__m128i &r0, __m128i &r1, __m128i &r2, __m128i &r3) {
+	const __m128i t0 = _mm_unpacklo_epi32(r0, r1);
+	const __m128i t1 = _mm_unpacklo_epi32(r2, r3);
+	const __m128i t2 = _mm_unpackhi_epi32(r0, r1);
+	const __m128i t3 = _mm_unpackhi_epi32(r2, r3);
+	r0 = _mm_unpacklo_epi64(t0, t1);
+	r1 = _mm_unpackhi_epi64(t0, t1);
+	r2 = _mm_unpacklo_epi64(t2, t3);
+	r3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * Transform rows 0-3 of the column pass output, given as its columns 0-3
+ * and 4-7, and round them.
+ */
+inline void idctRows(const __m128i *left, const __m128i *right, __m128i *rows) {
+	__m128i s[8] = { left[0], left[1], left[2], left[3], right[0], right[1], right[2], right[3] };
+	transpose4x4(s[0], s[1], s[2], s[3]);
+	transpose4x4(s[4], s[5], s[6], s[7]);
+
+	__m128i d[8];
+	transform(s, d);
+
+	const __m128i round = _mm_set1_epi32(0x7F);
+	for (int i = 0; i < 8; i++)
+		d[i] = _mm_srai_epi32(_mm_add_epi32(d[i], round), 8);
+
+	transpose4x4(d[0], d[1], d[2], d[3]);
+	transpose4x4(d[4], d[5], d[6], d[7]);
+
+	rows[0] = d[0];
+	rows[1] = d[4];
+	rows[2] = d[1];
+	rows[3] = d[5];
+	rows[4] = d[2];
+	rows[5] = d[6];
+	rows[6] = d[3];
+	rows[7] = d[7];
+}
+
+/**
+ * Inverse transform a block. Row i of the result ends up in rows[2 * i]
+ * (columns 0-3) and rows[2 * i + 1] (columns 4-7).
+ */
+inline void idct(const int32 *block, __m128i *rows) {
+	// Columns 0-3 and 4-7. The scalar code skips the transform of
+	// columns with only a DC value, which gives the same result.
+	__m128i s[8], left[8], right[8];
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_loadu_si128((const __m128i *)(block + i * 8));
+	transform(s, left);
+
+	for (int i = 0; i < 8; i++)
+		s[i] = _mm_loadu_si128((const __m128i *)(block + i * 8 + 4));
+	transform(s, right);
+
+	// Rows 0-3 and 4-7, on the transposed columns
+	idctRows(left, right, rows);
+	idctRows(left + 4, right + 4, rows + 8);
+}
+
+/** The low 16 bits of each of the eight 32-bit values. */
+inline __m128i truncate16(__m128i lo, __m128i hi) {
+	lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+	hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+	return _mm_packs_epi32(lo, hi);
+}
+
+/** Add eight 16-bit values to eight pixels, wrapping around like a byte does. */
+inline void addRow(byte *dest, __m128i values) {
+	const __m128i pixels = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)dest), _mm_setzero_si128());
+	const __m128i sum = _mm_and_si128(_mm_add_epi16(pixels, values), _mm_set1_epi16(0xFF));
+	_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(sum, sum));
+}
+
+} // End of anonymous namespace
+
+void binkIDCTSSE2(int32 *block) {
+	__m128i rows[16];
+	idct(block, rows);
+
+	for (int i = 0; i < 16; i++)
+		_mm_storeu_si128((__m128i *)(block + i * 4), rows[i]);
+}
+
+void binkIDCTPutSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	idct(block, rows);
+
+	// Only the low byte of each value is kept
+	const __m128i mask = _mm_set1_epi32(0xFF);
+	for (int i = 0; i < 8; i++, dest += pitch) {
+		const __m128i row = _mm_packs_epi32(_mm_and_si128(rows[i * 2], mask), _mm_and_si128(rows[i * 2 + 1], mask));
+		_mm_storel_epi64((__m128i *)dest, _mm_packus_epi16(row, row));
+	}
+}
+
+void binkIDCTAddSSE2(byte *dest, uint32 pitch, const int32 *block) {
+	__m128i rows[16];
+	idct(block, rows);
+
+	for (int i = 0; i < 8; i++, dest += pitch)
+		addRow(dest, truncate16(rows[i * 2], rows[i * 2 + 1]));
+}
+
+void binkAddResidueSSE2(byte *dest, uint32 pitch, const int16 *block) {
+	for (int i = 0; i < 8; i++, dest += pitch, block += 8)
+		addRow(dest, _mm_loadu_si128((const __m128i *)block));
+}
+
+} // End of namespace Video
+
+#endif
@@ -0,0 +1,57 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/**
+ * @file
+ * SSE2 versions of the Bink video IDCT and of adding residues to blocks.
+ *
+ * They produce exactly the same output as the scalar code in
+ * BinkDecoder::BinkVideoTrack, including the wrap-around of pixel values
+ * that do not fit in a byte.
+ */
+
+#ifndef VIDEO_BINK_DECODER_SSE2_H
+#define VIDEO_BINK_DECODER_SSE2_H
+
+#include "common/scummsys.h"
+
+#ifdef __SSE2__
+
+namespace Video {
+
+/** Inverse transform an 8x8 block of coefficients in place. */
+void binkIDCTSSE2(int32 *block);
+
+/** Inverse transform an 8x8 block of coefficients and store it into dest. */
+void binkIDCTPutSSE2(byte *dest, uint32 pitch, const int32 *block);
+
+/** Inverse transform an 8x8 block of coefficients and add it to dest. */
+void binkIDCTAddSSE2(byte *dest, uint32 pitch, const int32 *block);
+
+/** Add an 8x8 block of residues to dest. */
+void binkAddResidueSSE2(byte *dest, uint32 pitch, const int16 *block);
+
+} // End of namespace Video
+
+#endif
+
+#endif
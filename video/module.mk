@@ -13,7 +13,8 @@ MODULE_OBJS := \
 
 ifdef USE_BINK
 MODULE_OBJS += \
-	bink_decoder.o
+	bink_decoder.o \
+	bink_decoder_sse2.o
 endif
 
 ifdef USE_THEORADEC
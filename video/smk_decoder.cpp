@@ -27,6 +27,7 @@
 #include "video/smk_decoder.h"
 
 #include "common/endian.h"
+#include "common/huffman.h"
 #include "common/util.h"
 #include "common/stream.h"
 #include "common/bitstream.h"
@@ -49,113 +50,97 @@ enum SmkBlockTypes {
 /*
  * class SmallHuffmanTree
  * A Huffman-tree to hold 8-bit values.
+ *
+ * The tree is read from the bitstream once, and decoded through the
+ * lookup tables of a Common::Huffman built from its codes.
  */
 
 class SmallHuffmanTree {
 public:
 	SmallHuffmanTree(Common::BitStreamMemory8LSB &bs);
+	~SmallHuffmanTree();
 
-	uint16 getCode(Common::BitStreamMemory8LSB &bs);
+	uint16 getCode(Common::BitStreamMemory8LSB &bs) const;
 private:
-	enum {
-		SMK_NODE = 0x8000
-	};
-
-	uint16 decodeTree(uint32 prefix, int length);
+	void decodeTree(uint32 code, int length);
 
-	uint16 _treeSize;
-	uint16 _tree[511];
+	Common::Array<uint32> _codes;
+	Common::Array<uint8> _lengths;
+	Common::Array<uint32> _values;
 
-	uint16 _prefixtree[256];
-	byte _prefixlength[256];
+	Common::Huffman<Common::BitStreamMemory8LSB> *_huffman;
 
 	Common::BitStreamMemory8LSB &_bs;
 };
 
 SmallHuffmanTree::SmallHuffmanTree(Common::BitStreamMemory8LSB &bs)
-	: _treeSize(0), _bs(bs) {
+	: _huffman(0), _bs(bs) {
 	uint32 bit = _bs.getBit();
 	assert(bit);
 
-	for (uint16 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	decodeTree(0, 0);
 
 	bit = _bs.getBit();
 	assert(!bit);
-}
 
-uint16 SmallHuffmanTree::decodeTree(uint32 prefix, int length) {
-	if (!_bs.getBit()) { // Leaf
-		_tree[_treeSize] = _bs.getBits(8);
-
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
-		}
-		++_treeSize;
+	// A tree made of a single leaf doesn't use any bits
+	if (_lengths[0] > 0)
+		_huffman = new Common::Huffman<Common::BitStreamMemory8LSB>(0, _codes.size(), _codes.begin(), _lengths.begin(), _values.begin());
+}
 
-		return 1;
-	}
+SmallHuffmanTree::~SmallHuffmanTree() {
+	delete _huffman;
+}
 
-	uint16 t = _treeSize++;
+void SmallHuffmanTree::decodeTree(uint32 code, int length) {
+	if (length > 32)
+		error("SmallHuffmanTree: Code too long");
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+	if (!_bs.getBit()) { // Leaf
+		_codes.push_back(code);
+		_lengths.push_back(length);
+		_values.push_back(_bs.getBits(8));
+		return;
 	}
 
-	uint16 r1 = decodeTree(prefix, length + 1);
-
-	_tree[t] = (SMK_NODE | r1);
-
-	uint16 r2 = decodeTree(prefix | (1 << length), length + 1);
-
-	return r1+r2+1;
+	decodeTree(code << 1, length + 1);
+	decodeTree((code << 1) | 1, length + 1);
 }
 
-uint16 SmallHuffmanTree::getCode(Common::BitStreamMemory8LSB &bs) {
-	byte peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), 8));
-	uint16 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
+uint16 SmallHuffmanTree::getCode(Common::BitStreamMemory8LSB &bs) const {
+	if (!_huffman)
+		return _values[0];
 
-	while (*p & SMK_NODE) {
-		if (bs.getBit())
-			p += *p & ~SMK_NODE;
-		p++;
-	}
-
-	return *p;
+	return _huffman->getSymbol(bs);
 }
 
 /*
  * class BigHuffmanTree
  * A Huffman-tree to hold 16-bit values.
+ *
+ * Like SmallHuffmanTree, decoded through lookup tables. The codes map
+ * to leaf indices, since three of the leaves don't hold fixed values but
+ * a cache of the last values decoded.
  */
 
 class BigHuffmanTree {
 public:
-	BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize);
+	BigHuffmanTree(Common::BitStreamMemory8LSB &bs);
 	~BigHuffmanTree();
 
 	void reset();
 	uint32 getCode(Common::BitStreamMemory8LSB &bs);
 private:
-	enum {
-		SMK_NODE = 0x80000000
-	};
+	void decodeTree(uint32 code, int length);
 
-	uint32 decodeTree(uint32 prefix, int length);
+	Common::Array<uint32> _codes;
+	Common::Array<uint8> _lengths;
 
-	uint32  _treeSize;
-	uint32 *_tree;
-	uint32  _last[3];
+	/** The values of the leaves */
+	Common::Array<uint32> _values;
+	uint32 _last[3];
 
-	uint32 _prefixtree[256];
-	byte _prefixlength[256];
+	Common::Huffman<Common::BitStreamMemory8LSB> *_huffman;
 
 	/* Used during construction */
 	Common::BitStreamMemory8LSB &_bs;
@@ -164,19 +149,15 @@ private:
 	SmallHuffmanTree *_hiBytes;
 };
 
-BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize)
-	: _bs(bs) {
+BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs)
+	: _huffman(0), _bs(bs) {
 	uint32 bit = _bs.getBit();
 	if (!bit) {
-		_tree = new uint32[1];
-		_tree[0] = 0;
+		_values.push_back(0);
 		_last[0] = _last[1] = _last[2] = 0;
 		return;
 	}
 
-	for (uint32 i = 0; i < 256; ++i)
-		_prefixtree[i] = _prefixlength[i] = 0;
-
 	_loBytes = new SmallHuffmanTree(_bs);
 	_hiBytes = new SmallHuffmanTree(_bs);
 
@@ -186,16 +167,19 @@ BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize)
 
 	_last[0] = _last[1] = _last[2] = 0xffffffff;
 
-	_treeSize = 0;
-	_tree = new uint32[allocSize / 4];
 	decodeTree(0, 0);
 	bit = _bs.getBit();
 	assert(!bit);
 
+	// A tree made of a single leaf doesn't use any bits
+	if (_lengths[0] > 0)
+		_huffman = new Common::Huffman<Common::BitStreamMemory8LSB>(0, _codes.size(), _codes.begin(), _lengths.begin());
+
+	// Markers not found in the tree still need a place to cache their value
 	for (uint32 i = 0; i < 3; ++i) {
 		if (_last[i] == 0xffffffff) {
-			_last[i] = _treeSize;
-			_tree[_treeSize++] = 0;
+			_last[i] = _values.size();
+			_values.push_back(0);
 		}
 	}
 
@@ -204,14 +188,17 @@ BigHuffmanTree::BigHuffmanTree(Common::BitStreamMemory8LSB &bs, int allocSize)
 }
 
 BigHuffmanTree::~BigHuffmanTree() {
-	delete[] _tree;
+	delete _huffman;
 }
 
 void BigHuffmanTree::reset() {
-	_tree[_last[0]] = _tree[_last[1]] = _tree[_last[2]] = 0;
+	_values[_last[0]] = _values[_last[1]] = _values[_last[2]] = 0;
 }
 
-uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
+void BigHuffmanTree::decodeTree(uint32 code, int length) {
+	if (length > 32)
+		error("BigHuffmanTree: Code too long");
+
 	uint32 bit = _bs.getBit();
 
 	if (!bit) { // Leaf
@@ -220,57 +207,31 @@ uint32 BigHuffmanTree::decodeTree(uint32 prefix, int length) {
 
 		uint32 v = (hi << 8) | lo;
 
-		_tree[_treeSize] = v;
-
-		if (length <= 8) {
-			for (int i = 0; i < 256; i += (1 << length)) {
-				_prefixtree[prefix | i] = _treeSize;
-				_prefixlength[prefix | i] = length;
-			}
-		}
+		_codes.push_back(code);
+		_lengths.push_back(length);
+		_values.push_back(v);
 
 		for (int i = 0; i < 3; ++i) {
 			if (_markers[i] == v) {
-				_last[i] = _treeSize;
-				_tree[_treeSize] = 0;
+				_last[i] = _values.size() - 1;
+				_values.back() = 0;
 			}
 		}
-		++_treeSize;
-
-		return 1;
-	}
-
-	uint32 t = _treeSize++;
 
-	if (length == 8) {
-		_prefixtree[prefix] = t;
-		_prefixlength[prefix] = 8;
+		return;
 	}
 
-	uint32 r1 = decodeTree(prefix, length + 1);
-
-	_tree[t] = SMK_NODE | r1;
-
-	uint32 r2 = decodeTree(prefix | (1 << length), length + 1);
-	return r1+r2+1;
+	decodeTree(code << 1, length + 1);
+	decodeTree((code << 1) | 1, length + 1);
 }
 
 uint32 BigHuffmanTree::getCode(Common::BitStreamMemory8LSB &bs) {
-	byte peek = bs.peekBits(MIN<uint32>(bs.size() - bs.pos(), 8));
-	uint32 *p = &_tree[_prefixtree[peek]];
-	bs.skip(_prefixlength[peek]);
-
-	while (*p & SMK_NODE) {
-		if (bs.getBit())
-			p += (*p) & ~SMK_NODE;
-		p++;
-	}
+	uint32 v = _values[_huffman ? _huffman->getSymbol(bs) : 0];
 
-	uint32 v = *p;
-	if (v != _tree[_last[0]]) {
-		_tree[_last[2]] = _tree[_last[1]];
-		_tree[_last[1]] = _tree[_last[0]];
-		_tree[_last[0]] = v;
+	if (v != _values[_last[0]]) {
+		_values[_last[2]] = _values[_last[1]];
+		_values[_last[1]] = _values[_last[0]];
+		_values[_last[0]] = v;
 	}
 
 	return v;
@@ -386,7 +347,7 @@ bool SmackerDecoder::loadStream(Common::SeekableReadStream *stream) {
 	_fileStream->read(huffmanTrees, _header.treesSize);
 
 	Common::BitStreamMemory8LSB bs(new Common::BitStreamMemoryStream(huffmanTrees, _header.treesSize, DisposeAfterUse::YES), DisposeAfterUse::YES);
-	videoTrack->readTrees(bs, _header.mMapSize, _header.mClrSize, _header.fullSize, _header.typeSize);
+	videoTrack->readTrees(bs);
 
 	_firstFrameStart = _fileStream->pos();
 
@@ -552,11 +513,11 @@ Graphics::PixelFormat SmackerDecoder::SmackerVideoTrack::getPixelFormat() const
 	return _surface->format;
 }
 
-void SmackerDecoder::SmackerVideoTrack::readTrees(Common::BitStreamMemory8LSB &bs, uint32 mMapSize, uint32 mClrSize, uint32 fullSize, uint32 typeSize) {
-	_MMapTree = new BigHuffmanTree(bs, mMapSize);
-	_MClrTree = new BigHuffmanTree(bs, mClrSize);
-	_FullTree = new BigHuffmanTree(bs, fullSize);
-	_TypeTree = new BigHuffmanTree(bs, typeSize);
+void SmackerDecoder::SmackerVideoTrack::readTrees(Common::BitStreamMemory8LSB &bs) {
+	_MMapTree = new BigHuffmanTree(bs);
+	_MClrTree = new BigHuffmanTree(bs);
+	_FullTree = new BigHuffmanTree(bs);
+	_TypeTree = new BigHuffmanTree(bs);
 }
 
 void SmackerDecoder::SmackerVideoTrack::decodeFrame(Common::BitStreamMemory8LSB &bs) {
@@ -28,11 +28,49 @@
 #include "common/rational.h"
 #include "common/file.h"
 #include "common/system.h"
+#include "common/timer.h"
 
+#include "graphics/conversion.h"
 #include "graphics/palette.h"
+#include "graphics/surface.h"
 
 namespace Video {
 
+struct VideoDecoder::DecodedFrame {
+	Graphics::Surface surface;
+	bool hasSurface;
+	int prevFrame;     // The current frame before this one was decoded
+	uint32 startTime;  // The time at which this frame is due
+	bool dirtyPalette;
+	byte palette[3 * 256];
+};
+
+// All the videos decoding ahead share one timer callback, since the
+// timer manager only allows installing a callback once
+static Common::Array<VideoDecoder *> *s_decodeAheadDecoders = 0;
+static Common::Mutex *s_decodeAheadMutex = 0;
+
+// The time the videos may decode in per tick of the timer thread, which all
+// the other timer callbacks share, in milliseconds. The time spent over it
+// is paid back in the next ticks.
+static const int32 kDecodeAheadBudget = 3;
+static int32 s_decodeAheadCredit = 0;
+static uint s_decodeAheadNext = 0;
+
+/** Copy a frame into a surface allocated by the caller of decodeNextFrameInto(). */
+static void copyFrame(Graphics::Surface &dst, const Graphics::Surface &src) {
+	const int width = MIN(dst.w, src.w);
+	const int height = MIN(dst.h, src.h);
+
+	if (dst.format != src.format) {
+		Graphics::crossBlit((byte *)dst.getPixels(), (const byte *)src.getPixels(), dst.pitch, src.pitch, width, height, dst.format, src.format);
+		return;
+	}
+
+	for (int y = 0; y < height; y++)
+		memcpy(dst.getBasePtr(0, y), src.getBasePtr(0, y), width * src.format.bytesPerPixel);
+}
+
 VideoDecoder::VideoDecoder() {
 	_startTime = 0;
 	_dirtyPalette = false;
@@ -49,6 +87,11 @@ VideoDecoder::VideoDecoder() {
 	_nextVideoTrack = 0;
 	_mainAudioTrack = 0;
 	_canSetDither = true;
+	_decodeAhead = 0;
+	_decodedFrames = 0;
+	_decodedHead = 0;
+	_decodedCount = 0;
+	_decodeAheadRegistered = false;
 
 	// Find the best format for output
 	_defaultHighColorFormat = g_system->getScreenFormat();
@@ -57,10 +100,30 @@ VideoDecoder::VideoDecoder() {
 		_defaultHighColorFormat = Graphics::PixelFormat(4, 8, 8, 8, 8, 8, 16, 24, 0);
 }
 
+VideoDecoder::~VideoDecoder() {
+	// The timer could otherwise decode with the subclass already destroyed
+	assert(!_decodeAheadRegistered);
+
+	if (_decodeAhead) {
+		for (uint i = 0; i <= _decodeAhead; i++)
+			_decodedFrames[i].surface.free();
+
+		delete[] _decodedFrames;
+	}
+}
+
 void VideoDecoder::close() {
+	registerDecodeAhead(false);
+
+	Common::StackLock lock(_decodeMutex);
+
 	if (isPlaying())
 		stop();
 
+	dropDecodedFrames();
+	for (uint i = 0; _decodedFrames && i <= _decodeAhead; i++)
+		_decodedFrames[i].surface.free();
+
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++)
 		delete *it;
 
@@ -94,10 +157,13 @@ bool VideoDecoder::loadFile(const Common::String &filename) {
 }
 
 bool VideoDecoder::needsUpdate() const {
+	Common::StackLock lock(_decodeMutex);
 	return hasFramesLeft() && getTimeToNextFrame() == 0;
 }
 
 void VideoDecoder::pauseVideo(bool pause) {
+	Common::StackLock lock(_decodeMutex);
+
 	if (pause) {
 		_pauseLevel++;
 
@@ -182,9 +248,30 @@ Graphics::PixelFormat VideoDecoder::getPixelFormat() const {
 }
 
 const Graphics::Surface *VideoDecoder::decodeNextFrame() {
+	Common::StackLock lock(_decodeMutex);
+
 	_needsUpdate = false;
 	_canSetDither = false;
 
+	if (canDecodeAhead()) {
+		// Decode the frame now if the timer did not get to it
+		if (!_decodedCount && _nextVideoTrack)
+			decodeFrameAhead();
+
+		if (_decodedCount) {
+			DecodedFrame &frame = _decodedFrames[_decodedHead];
+			_decodedHead = (_decodedHead + 1) % (_decodeAhead + 1);
+			_decodedCount--;
+
+			if (frame.dirtyPalette) {
+				_palette = frame.palette;
+				_dirtyPalette = true;
+			}
+
+			return frame.hasSurface ? &frame.surface : 0;
+		}
+	}
+
 	readNextPacket();
 
 	// If we have no next video track at this point, there shouldn't be
@@ -205,11 +292,59 @@ const Graphics::Surface *VideoDecoder::decodeNextFrame() {
 	return frame;
 }
 
+bool VideoDecoder::decodeNextFrameInto(Graphics::Surface &dst) {
+	const Graphics::Surface *frame = decodeNextFrame();
+	if (!frame)
+		return false;
+
+	copyFrame(dst, *frame);
+	return true;
+}
+
+bool VideoDecoder::decodeTrackFrameInto(Graphics::Surface &dst) {
+	Common::StackLock lock(_decodeMutex);
+
+	// The frames decoded ahead are already in surfaces of their own
+	if (canDecodeAhead())
+		return VideoDecoder::decodeNextFrameInto(dst);
+
+	_needsUpdate = false;
+	_canSetDither = false;
+
+	readNextPacket();
+
+	if (!_nextVideoTrack)
+		return false;
+
+	const bool decoded = _nextVideoTrack->decodeNextFrameInto(dst);
+
+	if (_nextVideoTrack->hasDirtyPalette()) {
+		_palette = _nextVideoTrack->getPalette();
+		_dirtyPalette = true;
+	}
+
+	findNextVideoTrack();
+
+	return decoded;
+}
+
 bool VideoDecoder::setReverse(bool reverse) {
+	Common::StackLock lock(_decodeMutex);
+
 	// Can only reverse video-only videos
 	if (reverse && hasAudio())
 		return false;
 
+	// The track is past the frames decoded ahead, move it back to the
+	// first of them before turning around
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (reverse && decodedFrame) {
+		if (!seekIntern(Audio::Timestamp(decodedFrame->startTime, 1000)))
+			return false;
+
+		dropDecodedFrames();
+	}
+
 	// Attempt to make sure all the tracks are in the requested direction
 	for (TrackList::iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() == Track::kTrackTypeVideo && ((VideoTrack *)*it)->isReversed() != reverse) {
@@ -230,6 +365,13 @@ const byte *VideoDecoder::getPalette() {
 }
 
 int VideoDecoder::getCurFrame() const {
+	Common::StackLock lock(_decodeMutex);
+
+	// The track is already past the frames decoded ahead
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (decodedFrame)
+		return decodedFrame->prevFrame;
+
 	int32 frame = -1;
 
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++)
@@ -271,13 +413,16 @@ uint32 VideoDecoder::getTime() const {
 }
 
 uint32 VideoDecoder::getTimeToNextFrame() const {
-	if (endOfVideo() || _needsUpdate || !_nextVideoTrack)
+	Common::StackLock lock(_decodeMutex);
+
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+	if (endOfVideo() || _needsUpdate || (!_nextVideoTrack && !decodedFrame))
 		return 0;
 
 	uint32 currentTime = getTime();
-	uint32 nextFrameStartTime = _nextVideoTrack->getNextFrameStartTime();
+	uint32 nextFrameStartTime = decodedFrame ? decodedFrame->startTime : _nextVideoTrack->getNextFrameStartTime();
 
-	if (_nextVideoTrack->isReversed()) {
+	if (!decodedFrame && _nextVideoTrack->isReversed()) {
 		// For reversed videos, we need to handle the time difference the opposite way.
 		if (nextFrameStartTime >= currentTime)
 			return 0;
@@ -293,11 +438,21 @@ uint32 VideoDecoder::getTimeToNextFrame() const {
 }
 
 bool VideoDecoder::endOfVideo() const {
+	Common::StackLock lock(_decodeMutex);
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		const Track *track = *it;
+		bool endReached;
+
+		if (decodedFrame && track->getTrackType() == Track::kTrackTypeVideo) {
+			// There are still frames to show, unless they are past the end time
+			endReached = isPlaying() && _endTimeSet && decodedFrame->startTime >= (uint)_endTime.msecs();
+		} else {
+			bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
+			endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
+		}
 
-		bool videoEndTimeReached = _endTimeSet && track->getTrackType() == Track::kTrackTypeVideo && ((const VideoTrack *)track)->getNextFrameStartTime() >= (uint)_endTime.msecs();
-		bool endReached = track->endOfTrack() || (isPlaying() && videoEndTimeReached);
 		if (!endReached)
 			return false;
 	}
@@ -317,9 +472,13 @@ bool VideoDecoder::isRewindable() const {
 }
 
 bool VideoDecoder::rewind() {
+	Common::StackLock lock(_decodeMutex);
+
 	if (!isRewindable())
 		return false;
 
+	dropDecodedFrames();
+
 	// Stop all tracks so they can be rewound
 	if (isPlaying())
 		stopAudio();
@@ -351,9 +510,13 @@ bool VideoDecoder::isSeekable() const {
 }
 
 bool VideoDecoder::seek(const Audio::Timestamp &time) {
+	Common::StackLock lock(_decodeMutex);
+
 	if (!isSeekable())
 		return false;
 
+	dropDecodedFrames();
+
 	// Stop all tracks so they can be seeked
 	if (isPlaying())
 		stopAudio();
@@ -414,9 +577,16 @@ bool VideoDecoder::seekToFrame(uint frame) {
 void VideoDecoder::start() {
 	if (!isPlaying())
 		setRate(1);
+
+	if (_decodeAhead)
+		registerDecodeAhead(true);
 }
 
 void VideoDecoder::stop() {
+	registerDecodeAhead(false);
+
+	Common::StackLock lock(_decodeMutex);
+
 	if (!isPlaying())
 		return;
 
@@ -444,6 +614,8 @@ void VideoDecoder::stop() {
 }
 
 void VideoDecoder::setRate(const Common::Rational &rate) {
+	Common::StackLock lock(_decodeMutex);
+
 	if (!isVideoLoaded() || _playbackRate == rate)
 		return;
 
@@ -507,6 +679,8 @@ bool VideoDecoder::seekIntern(const Audio::Timestamp &time) {
 }
 
 bool VideoDecoder::setDitheringPalette(const byte *palette) {
+	Common::StackLock lock(_decodeMutex);
+
 	// If a frame was already decoded, we can't set it now.
 	if (!_canSetDither)
 		return false;
@@ -523,6 +697,24 @@ bool VideoDecoder::setDitheringPalette(const byte *palette) {
 	return result;
 }
 
+void VideoDecoder::setDecodeAhead(uint frames) {
+	assert(!isVideoLoaded());
+
+	if (_decodeAhead == frames)
+		return;
+
+	// The surfaces were freed by close()
+	delete[] _decodedFrames;
+	_decodedFrames = 0;
+	_decodeAhead = frames;
+	dropDecodedFrames();
+
+	if (_decodeAhead) {
+		// One more to keep the frame on display while decoding the next ones
+		_decodedFrames = new DecodedFrame[_decodeAhead + 1];
+	}
+}
+
 VideoDecoder::Track::Track() {
 	_paused = false;
 }
@@ -548,6 +740,15 @@ bool VideoDecoder::VideoTrack::endOfTrack() const {
 	return getCurFrame() >= (getFrameCount() - 1);
 }
 
+bool VideoDecoder::VideoTrack::decodeNextFrameInto(Graphics::Surface &dst) {
+	const Graphics::Surface *frame = decodeNextFrame();
+	if (!frame)
+		return false;
+
+	copyFrame(dst, *frame);
+	return true;
+}
+
 Audio::Timestamp VideoDecoder::VideoTrack::getFrameTime(uint frame) const {
 	// Default implementation: Return an invalid (negative) number
 	return Audio::Timestamp().addFrames(-1);
@@ -798,6 +999,7 @@ uint VideoDecoder::getAudioTrackCount() const {
 }
 
 void VideoDecoder::setEndTime(const Audio::Timestamp &endTime) {
+	Common::StackLock lock(_decodeMutex);
 	Audio::Timestamp startTime = 0;
 
 	if (isPlaying()) {
@@ -915,10 +1117,16 @@ bool VideoDecoder::hasFramesLeft() const {
 	// This is similar to endOfVideo(), except it doesn't take Audio into account (and returns true if not the end of the video)
 	// This is only used for needsUpdate() atm so that setEndTime() works properly
 	// And unlike endOfVideoTracks(), this takes into account _endTime
+	const DecodedFrame *decodedFrame = peekDecodedFrame();
+
 	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
 		if ((*it)->getTrackType() != Track::kTrackTypeVideo)
 			continue;
 
+		// The frames decoded ahead are still to be shown
+		if (decodedFrame)
+			return !isPlaying() || !_endTimeSet || decodedFrame->startTime < (uint)_endTime.msecs();
+
 		const VideoTrack *track = (const VideoTrack *)*it;
 
 		bool videoEndTimeReached = _endTimeSet && track->getNextFrameStartTime() >= (uint)_endTime.msecs();
@@ -955,4 +1163,143 @@ void VideoDecoder::eraseTrack(Track *track) {
 	}
 }
 
+void VideoDecoder::decodeAheadProc(void *refCon) {
+	Common::StackLock lock(*s_decodeAheadMutex);
+
+	// The videos take turns for one frame at a time, until the budget of the
+	// tick is spent or none of them has anything left to decode
+	s_decodeAheadCredit = MIN(s_decodeAheadCredit + kDecodeAheadBudget, kDecodeAheadBudget);
+	uint idle = 0;
+	while (s_decodeAheadCredit > 0 && idle < s_decodeAheadDecoders->size()) {
+		VideoDecoder *decoder = (*s_decodeAheadDecoders)[s_decodeAheadNext++ % s_decodeAheadDecoders->size()];
+
+		const uint32 start = g_system->getMillis(true);
+		if (decoder->decodeAheadFrame()) {
+			s_decodeAheadCredit -= g_system->getMillis(true) - start;
+			idle = 0;
+		} else {
+			idle++;
+		}
+	}
+}
+
+void VideoDecoder::registerDecodeAhead(bool add) {
+	if (_decodeAheadRegistered == add)
+		return;
+
+	_decodeAheadRegistered = add;
+
+	// The timer manager is only called without holding the list lock,
+	// since the timer thread takes them in the other order. The decoder
+	// lock is not held either, the timer takes it with the list lock.
+	if (add) {
+		if (!s_decodeAheadDecoders) {
+			s_decodeAheadDecoders = new Common::Array<VideoDecoder *>();
+			s_decodeAheadMutex = new Common::Mutex();
+		}
+
+		bool first;
+		{
+			Common::StackLock lock(*s_decodeAheadMutex);
+			s_decodeAheadDecoders->push_back(this);
+			first = s_decodeAheadDecoders->size() == 1;
+		}
+
+		if (first)
+			g_system->getTimerManager()->installTimerProc(&decodeAheadProc, 10000, 0, "videoDecodeAhead");
+	} else {
+		bool last;
+		{
+			Common::StackLock lock(*s_decodeAheadMutex);
+			for (uint i = 0; i < s_decodeAheadDecoders->size(); i++) {
+				if ((*s_decodeAheadDecoders)[i] == this) {
+					s_decodeAheadDecoders->remove_at(i);
+					break;
+				}
+			}
+
+			last = s_decodeAheadDecoders->empty();
+		}
+
+		if (last) {
+			g_system->getTimerManager()->removeTimerProc(&decodeAheadProc);
+
+			delete s_decodeAheadDecoders;
+			s_decodeAheadDecoders = 0;
+			delete s_decodeAheadMutex;
+			s_decodeAheadMutex = 0;
+		}
+	}
+}
+
+bool VideoDecoder::canDecodeAhead() const {
+	if (!_decodeAhead)
+		return false;
+
+	// Only a single video track playing forward is decoded ahead
+	const VideoTrack *videoTrack = 0;
+	for (TrackList::const_iterator it = _tracks.begin(); it != _tracks.end(); it++) {
+		if ((*it)->getTrackType() == Track::kTrackTypeVideo) {
+			if (videoTrack)
+				return false;
+
+			videoTrack = (const VideoTrack *)*it;
+		}
+	}
+
+	return videoTrack && !videoTrack->isReversed();
+}
+
+bool VideoDecoder::decodeAheadFrame() {
+	Common::StackLock lock(_decodeMutex);
+
+	// Nothing is decoded while stopped or paused, where a seek is likely
+	if (!isPlaying() || isPaused() || !canDecodeAhead() || _decodedCount >= _decodeAhead || !_nextVideoTrack)
+		return false;
+
+	if (_endTimeSet && _nextVideoTrack->getNextFrameStartTime() >= (uint)_endTime.msecs())
+		return false;
+
+	decodeFrameAhead();
+	return true;
+}
+
+void VideoDecoder::decodeFrameAhead() {
+	DecodedFrame &frame = _decodedFrames[(_decodedHead + _decodedCount) % (_decodeAhead + 1)];
+	frame.prevFrame = _nextVideoTrack->getCurFrame();
+	frame.startTime = _nextVideoTrack->getNextFrameStartTime();
+
+	readNextPacket();
+
+	// The surfaces are only allocated again when the frame size changes
+	const Graphics::PixelFormat format = _nextVideoTrack->getPixelFormat();
+	if (frame.surface.w != _nextVideoTrack->getWidth() || frame.surface.h != _nextVideoTrack->getHeight() || frame.surface.format != format) {
+		frame.surface.free();
+		frame.surface.create(_nextVideoTrack->getWidth(), _nextVideoTrack->getHeight(), format);
+	}
+
+	frame.hasSurface = _nextVideoTrack->decodeNextFrameInto(frame.surface);
+
+	frame.dirtyPalette = _nextVideoTrack->hasDirtyPalette();
+	if (frame.dirtyPalette)
+		memcpy(frame.palette, _nextVideoTrack->getPalette(), sizeof(frame.palette));
+
+	_decodedCount++;
+
+	// Look for the next video track here for the next decode.
+	findNextVideoTrack();
+}
+
+const VideoDecoder::DecodedFrame *VideoDecoder::peekDecodedFrame() const {
+	if (!_decodedCount)
+		return 0;
+
+	return &_decodedFrames[_decodedHead];
+}
+
+void VideoDecoder::dropDecodedFrames() {
+	_decodedHead = 0;
+	_decodedCount = 0;
+}
+
 } // End of namespace Video
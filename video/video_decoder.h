@@ -26,6 +26,7 @@
 #include "audio/mixer.h"
 #include "audio/timestamp.h"	// TODO: Move this to common/ ?
 #include "common/array.h"
+#include "common/mutex.h"
 #include "common/rational.h"
 #include "common/str.h"
 #include "graphics/pixelformat.h"
@@ -52,7 +53,7 @@ namespace Video {
 class VideoDecoder {
 public:
 	VideoDecoder();
-	virtual ~VideoDecoder() {}
+	virtual ~VideoDecoder();
 
 	/////////////////////////////////////////
 	// Opening/Closing a Video
@@ -355,6 +356,25 @@ public:
 	 */
 	virtual const Graphics::Surface *decodeNextFrame();
 
+	/**
+	 * Decode the next frame into a surface supplied by the caller.
+	 *
+	 * This works like decodeNextFrame(), for callers keeping the frames in
+	 * their own storage. Decoders that convert their frames, like the YUV
+	 * based ones, may write the converted frame straight into dst instead
+	 * of into a surface of their own that the caller would then copy.
+	 * Others decode the frame as usual and copy it into dst, as do frames
+	 * decoded ahead.
+	 *
+	 * dst must already be allocated, with the size and the pixel format
+	 * of the video.
+	 *
+	 * @param dst The surface to decode the frame into
+	 * @return true if dst holds the next frame, false if there is none,
+	 *         in which case the last frame should be kept on screen
+	 */
+	virtual bool decodeNextFrameInto(Graphics::Surface &dst);
+
 	/**
 	 * Set the default high color format for videos that convert from YUV.
 	 *
@@ -396,6 +416,40 @@ public:
 	 */
 	bool setDitheringPalette(const byte *palette);
 
+	/**
+	 * Decode frames ahead of playback.
+	 *
+	 * From start() until stop() or close(), up to the given number of frames
+	 * are decoded from a timer callback into a ring of surfaces, so that the
+	 * work is done in the time between frames. decodeNextFrame() then returns the
+	 * oldest of those frames, and only decodes itself when none is left.
+	 * Seeking and rewinding drop the frames decoded ahead.
+	 *
+	 * Only forward playback of videos with a single video track is decoded
+	 * ahead; anything else is decoded on demand as usual. The frames are
+	 * decoded with readNextPacket() and the track's decodeNextFrame(), so
+	 * decoders doing their own decoding in an override of decodeNextFrame()
+	 * cannot use this. Subclasses must call close() from their destructor.
+	 *
+	 * All timer callbacks share one thread, so there is nothing to gain
+	 * when decodeNextFrame() is itself called from a timer callback. The
+	 * videos only get a few milliseconds of each tick of that thread; a frame
+	 * taking longer than that cannot be split, and makes them skip the next
+	 * ticks instead.
+	 *
+	 * This must be set before calling loadStream(), and remains until it
+	 * is changed again. The default of 0 decodes every frame on demand.
+	 *
+	 * @param frames The maximum number of frames to decode ahead
+	 */
+	void setDecodeAhead(uint frames);
+
+	/**
+	 * Get the number of frames decoded ahead of playback.
+	 * @see setDecodeAhead()
+	 */
+	uint getDecodeAhead() const { return _decodeAhead; }
+
 	/////////////////////////////////////////
 	// Audio Control
 	/////////////////////////////////////////
@@ -603,6 +657,15 @@ protected:
 		 */
 		virtual const Graphics::Surface *decodeNextFrame() = 0;
 
+		/**
+		 * Decode the next frame into dst, which has the size and the pixel
+		 * format of the track. By default, the frame is decoded with
+		 * decodeNextFrame() and copied.
+		 *
+		 * @return true if dst holds the next frame, false if there is none
+		 */
+		virtual bool decodeNextFrameInto(Graphics::Surface &dst);
+
 		/**
 		 * Get the palette currently in use by this track
 		 */
@@ -826,6 +889,14 @@ protected:
 	 */
 	virtual void readNextPacket() {}
 
+	/**
+	 * Decode the next frame into dst through the decodeNextFrameInto() function
+	 * of the next video track. Subclasses whose tracks convert their frames
+	 * can implement decodeNextFrameInto() with this, as long as they do not
+	 * change the frames in decodeNextFrame().
+	 */
+	bool decodeTrackFrameInto(Graphics::Surface &dst);
+
 	/**
 	 * Define a track to be used by this class.
 	 *
@@ -949,6 +1020,22 @@ private:
 	// Default PixelFormat settings
 	Graphics::PixelFormat _defaultHighColorFormat;
 
+	// Frames decoded ahead of playback, see setDecodeAhead()
+	struct DecodedFrame;
+	uint _decodeAhead;
+	DecodedFrame *_decodedFrames;
+	uint _decodedHead, _decodedCount;
+	bool _decodeAheadRegistered;
+	Common::Mutex _decodeMutex;
+
+	static void decodeAheadProc(void *refCon);
+	void registerDecodeAhead(bool add);
+	bool canDecodeAhead() const;
+	bool decodeAheadFrame();
+	void decodeFrameAhead();
+	const DecodedFrame *peekDecodedFrame() const;
+	void dropDecodedFrames();
+
 	// Internal helper functions
 	void stopAudio();
 	void startAudio();